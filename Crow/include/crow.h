@@ -15,6 +15,7 @@
 #include "crow/websocket.h"
 #include "crow/parser.h"
 #include "crow/http_response.h"
+#include "crow/body_stream.h"
 #include "crow/multipart.h"
 #include "crow/multipart_view.h"
 #include "crow/routing.h"
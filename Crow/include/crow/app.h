@@ -32,6 +32,7 @@
 #include "crow/logging.h"
 #include "crow/utility.h"
 #include "crow/routing.h"
+#include "crow/body_stream.h"
 #include "crow/middleware_context.h"
 #include "crow/http_request.h"
 #include "crow/http_server.h"
@@ -423,6 +424,22 @@ namespace crow
             return router_.exception_handler();
         }
 
+        /// \brief Set the function that may take requests as their body arrives, before they reach the router (see crow::body_stream)
+        ///
+        /// The function must have the following signature: std::unique_ptr<crow::body_stream>(const crow::request&, std::shared_ptr<crow::stream_writer>).
+        /// It is called with the method, URL and headers of every HTTP/1.1 request and returns nullptr for the ones the router should handle.
+        template<typename Func>
+        self_t& body_stream_handler(Func&& f)
+        {
+            body_stream_handler_ = std::forward<Func>(f);
+            return *this;
+        }
+
+        std::function<std::unique_ptr<body_stream>(const request&, std::shared_ptr<stream_writer>)>& body_stream_handler()
+        {
+            return body_stream_handler_;
+        }
+
         /// \brief Set a custom duration and function to run on every tick
         template<typename Duration, typename Func>
         self_t& tick(Duration d, Func f)
@@ -774,6 +791,7 @@ namespace crow
 
         std::chrono::milliseconds tick_interval_;
         std::function<void()> tick_function_;
+        std::function<std::unique_ptr<body_stream>(const request&, std::shared_ptr<stream_writer>)> body_stream_handler_;
 
         std::tuple<Middlewares...> middlewares_;
 
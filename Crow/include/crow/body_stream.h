@@ -0,0 +1,151 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "crow/http_request.h"
+#include "crow/http_response.h"
+
+namespace crow // NOTE: Already documented in "crow/app.h"
+{
+    template<typename Adaptor, typename Handler, typename... Middlewares>
+    class Connection;
+
+    /// Takes the body of a request as it arrives, in place of the router.
+
+    ///
+    /// The app's body stream handler (see Crow::body_stream_handler()) is asked for one once the headers of an HTTP/1.1 request are parsed.
+    /// Both calls run on the connection's thread, which reads no more of the body until they return, so a stream that blocks slows the client down.
+    /// The connection also stops reading while too much of the response is waiting for the client.
+    /// Global middlewares are not run for these requests.
+    struct body_stream
+    {
+        virtual ~body_stream() = default;
+
+        /// The next piece of the body.
+        virtual void on_data(const char* data, size_t size) = 0;
+
+        /// The whole body has arrived.
+        virtual void on_end() = 0;
+    };
+
+    /// The response to a request taken by a \ref crow.body_stream.
+
+    ///
+    /// Either begin(), any number of write() calls and end(), or a single send().
+    /// Every call is safe from any thread: the output is collected here and written by the connection on its own thread.
+    /// Calls made after the client is gone are ignored.
+    class stream_writer : public std::enable_shared_from_this<stream_writer>
+    {
+    public:
+        /// Send the status and headers of res, followed by a body in chunks (Transfer-Encoding: chunked).
+        void begin(response res)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_)
+                return;
+            head_.reset(new response(std::move(res)));
+            notify_locked();
+        }
+
+        /// Send data as part of the body started by begin().
+        void write(std::string_view data)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_ || data.empty())
+                return;
+            data_.append(data.data(), data.size());
+            notify_locked();
+        }
+
+        /// Finish the body started by begin(). Only once the request body has arrived (after body_stream::on_end()).
+        void end()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            end_ = true;
+            notify_locked();
+        }
+
+        /// Send res as the whole response instead. Only once the request body has arrived.
+        void send(response res)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_)
+                return;
+            whole_.reset(new response(std::move(res)));
+            notify_locked();
+        }
+
+    private:
+        template<typename Adaptor, typename Handler, typename... Middlewares>
+        friend class crow::Connection;
+
+        /// Output collected since the connection last took it.
+        struct output
+        {
+            std::unique_ptr<response> head;
+            std::unique_ptr<response> whole;
+            std::string data;
+            bool end = false;
+        };
+
+        /// notify is called (under the writer's lock, from any thread) when there is output and the connection has taken everything before it.
+        explicit stream_writer(std::function<void(std::shared_ptr<stream_writer>)> notify):
+          notify_(std::move(notify))
+        {}
+
+        output take()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            output out;
+            out.head = std::move(head_);
+            out.whole = std::move(whole_);
+            out.data.swap(data_);
+            out.end = end_;
+            end_ = false;
+            notified_ = false;
+            return out;
+        }
+
+        /// Bytes written and not yet taken.
+        size_t backlog()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return data_.size();
+        }
+
+        /// Drop all further output.
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            head_.reset();
+            whole_.reset();
+            data_.clear();
+            end_ = false;
+        }
+
+        void notify_locked()
+        {
+            if (!notified_ && !closed_)
+            {
+                notified_ = true;
+                notify_(shared_from_this());
+            }
+        }
+
+        std::function<void(std::shared_ptr<stream_writer>)> notify_;
+        std::function<void()> on_output_; ///< Set by the connection while the stream runs; only touched on its thread.
+
+        std::mutex mutex_;
+        std::unique_ptr<response> head_;
+        std::unique_ptr<response> whole_;
+        std::string data_;
+        bool end_ = false;
+        bool notified_ = false;
+        bool closed_ = false;
+    };
+} // namespace crow
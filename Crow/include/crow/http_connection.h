@@ -12,10 +12,12 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <memory>
 #include <vector>
 
 #include "crow/http_parser_merged.h"
+#include "crow/body_stream.h"
 #include "crow/common.h"
 #include "crow/compression.h"
 #include "crow/http_response.h"
@@ -95,6 +97,9 @@ namespace crow
             adaptor_.start([self](const error_code& ec) {
                 if (!ec)
                 {
+                    // Responses go out as they are written, not held back by Nagle
+                    error_code nodelay_ec;
+                    self->adaptor_.raw_socket().set_option(asio::ip::tcp::no_delay(true), nodelay_ec);
                     self->start_deadline();
                     self->parser_.clear();
 
@@ -130,12 +135,47 @@ namespace crow
                 buffers_.emplace_back(expect_100_continue.data(), expect_100_continue.size());
                 do_write_sync(buffers_);
             }
+
+            auto& open_stream = handler_->body_stream_handler();
+            if (open_stream && req_.check_version(1, 1))
+            {
+                auto& io_context = adaptor_.get_io_context();
+                std::shared_ptr<stream_writer> writer(new stream_writer([&io_context](std::shared_ptr<stream_writer> writer) {
+                    asio::post(io_context, [writer] {
+                        if (writer->on_output_)
+                            writer->on_output_();
+                    });
+                }));
+                stream_ = open_stream(req_, writer);
+                if (stream_)
+                {
+                    auto self = this->shared_from_this();
+                    writer->on_output_ = [self] {
+                        self->stream_flush();
+                    };
+                    stream_writer_ = std::move(writer);
+                    add_keep_alive_ = req_.keep_alive;
+                }
+            }
+        }
+
+        void handle_body(const char* data, size_t size)
+        {
+            if (stream_)
+                stream_->on_data(data, size);
+            else
+                req_.body.append(data, size);
         }
 
         void handle()
         {
             // TODO(EDev): cancel_deadline_timer should be looked into, it might be a good idea to add it to handle_url() and then restart the timer once everything passes
             cancel_deadline_timer();
+            if (stream_)
+            {
+                handle_stream_end();
+                return;
+            }
             bool is_invalid_request = false;
             add_keep_alive_ = false;
 
@@ -390,6 +430,147 @@ namespace crow
             buffers_.emplace_back(crlf.data(), crlf.size());
         }
 
+        void handle_stream_end()
+        {
+            CROW_LOG_INFO << "Request: " << utility::lexical_cast<std::string>(adaptor_.remote_endpoint()) << " " << this << " HTTP/" << (char)(req_.http_ver_major + '0') << "." << (char)(req_.http_ver_minor + '0') << ' ' << method_name(req_.method) << " " << req_.url << " (streamed)";
+
+            close_connection_ = req_.close_connection;
+            // Like a handler that completes later: the next request is read once the response is out
+            need_to_call_after_handlers_ = true;
+            stream_body_done_ = true;
+            stream_->on_end();
+        }
+
+        /// Bytes of the stream's response not yet on the socket
+        size_t stream_backlog()
+        {
+            return stream_writer_->backlog() + stream_chunk_.size();
+        }
+
+        /// Write what the stream has produced, one write at a time; called again as each write completes
+        void stream_flush()
+        {
+            if (!stream_writer_ || stream_writing_)
+                return;
+
+            auto out = stream_writer_->take();
+            if (out.whole)
+            {
+                // A whole response instead of a chunked one, sent as a route's would be
+                auto self = this->shared_from_this();
+                stream_close();
+                res = std::move(*out.whole);
+                need_to_call_after_handlers_ = false;
+                complete_request();
+                return;
+            }
+            if (!adaptor_.is_open())
+            {
+                stream_close();
+                return;
+            }
+
+            buffers_.clear();
+            if (out.head)
+            {
+                res = std::move(*out.head);
+                res.manual_length_header = true;
+                res.set_header("Transfer-Encoding", "chunked");
+                prepare_buffers();
+            }
+            if (!out.data.empty())
+            {
+                stream_chunk_.swap(out.data);
+                char size[20];
+                stream_chunk_size_.assign(size, std::snprintf(size, sizeof(size), "%zx\r\n", stream_chunk_.size()));
+                buffers_.emplace_back(stream_chunk_size_.data(), stream_chunk_size_.size());
+                buffers_.emplace_back(stream_chunk_.data(), stream_chunk_.size());
+                buffers_.emplace_back(crlf.data(), crlf.size());
+            }
+            stream_ended_ = stream_ended_ || out.end;
+            if (out.end)
+            {
+                static std::string last_chunk = "0\r\n\r\n";
+                buffers_.emplace_back(last_chunk.data(), last_chunk.size());
+            }
+            if (buffers_.empty())
+                return;
+
+            // A client that stops taking the response is dropped after the timeout, as one that stops sending
+            start_deadline();
+            stream_writing_ = true;
+            auto self = this->shared_from_this();
+            asio::async_write(
+              adaptor_.socket(), buffers_,
+              [self](const error_code& ec, std::size_t /*bytes_transferred*/) {
+                  self->stream_writing_ = false;
+                  self->buffers_.clear();
+                  self->stream_chunk_.clear();
+                  if (ec || !self->stream_writer_)
+                  {
+                      CROW_LOG_DEBUG << self << " from write (stream)";
+                      self->stream_close();
+                      self->adaptor_.shutdown_readwrite();
+                      self->adaptor_.close();
+                      return;
+                  }
+                  if (self->stream_ended_)
+                  {
+                      self->stream_done();
+                      return;
+                  }
+
+                  if (self->stream_body_done_)
+                      self->cancel_deadline_timer();
+                  else
+                      self->start_deadline();
+                  if (self->stream_read_paused_ && self->stream_backlog() <= stream_backlog_limit)
+                  {
+                      self->stream_read_paused_ = false;
+                      self->do_read();
+                  }
+                  self->stream_flush();
+              });
+        }
+
+        /// The chunked response is out: go on to the next request as after any other response
+        void stream_done()
+        {
+            auto self = this->shared_from_this();
+            cancel_deadline_timer();
+            stream_close();
+            res.clear();
+            parser_.clear();
+            continue_requested = false;
+            need_to_call_after_handlers_ = false;
+            if (close_connection_)
+            {
+                adaptor_.shutdown_readwrite();
+                adaptor_.close();
+                CROW_LOG_DEBUG << this << " from write (stream end)";
+            }
+            else if (need_to_start_read_after_complete_)
+            {
+                need_to_start_read_after_complete_ = false;
+                start_deadline();
+                do_read();
+            }
+        }
+
+        /// Detach the stream and drop any output it still writes. Callers keep the connection alive, since the writer held it.
+        void stream_close()
+        {
+            if (!stream_writer_)
+                return;
+            stream_writer_->close();
+            stream_writer_->on_output_ = nullptr;
+            stream_writer_.reset();
+            stream_.reset();
+            stream_body_done_ = false;
+            stream_ended_ = false;
+            stream_read_paused_ = false;
+        }
+
         void do_write_static()
         {
             asio::write(adaptor_.socket(), buffers_);
@@ -427,7 +608,7 @@ namespace crow
                 res_body_copy_.swap(res.body);
                 buffers_.emplace_back(res_body_copy_.data(), res_body_copy_.size());
 
-                do_write_sync(buffers_);
+                do_write();
 
                 if (need_to_start_read_after_complete_)
                 {
@@ -487,6 +668,7 @@ namespace crow
                   {
                       self->cancel_deadline_timer();
                       self->parser_.done();
+                      self->stream_close();
                       self->adaptor_.shutdown_read();
                       self->adaptor_.close();
                       CROW_LOG_DEBUG << self << " from read(1) with description: \"" << http_errno_description(static_cast<http_errno>(self->parser_.http_errno)) << '\"';
@@ -500,7 +682,10 @@ namespace crow
                   else if (!self->need_to_call_after_handlers_)
                   {
                       self->start_deadline();
-                      self->do_read();
+                      if (self->stream_writer_ && self->stream_backlog() > stream_backlog_limit)
+                          self->stream_read_paused_ = true; // Resumed as the client takes the response
+                      else
+                          self->do_read();
                   }
                   else
                   {
@@ -618,6 +803,17 @@ namespace crow
         size_t res_stream_threshold_;
 
         std::atomic<unsigned int>& queue_length_;
+
+        // Request taken by a body stream (see body_stream.h)
+        static constexpr size_t stream_backlog_limit = 1 << 20;
+        std::unique_ptr<body_stream> stream_;
+        std::shared_ptr<stream_writer> stream_writer_;
+        std::string stream_chunk_;      ///< Chunk being written
+        std::string stream_chunk_size_; ///< Its size line
+        bool stream_writing_{};
+        bool stream_body_done_{};
+        bool stream_ended_{};
+        bool stream_read_paused_{};
     };
 
 } // namespace crow
@@ -88,7 +88,7 @@ namespace crow
         static int on_body(http_parser* self_, const char* at, size_t length)
         {
             HTTPParser* self = static_cast<HTTPParser*>(self_);
-            self->req.body.insert(self->req.body.end(), at, at + length);
+            self->process_body(at, length);
             return 0;
         }
         static int on_message_complete(http_parser* self_)
@@ -158,6 +158,11 @@ namespace crow
             handler_->handle_header();
         }
 
+        inline void process_body(const char* at, size_t length)
+        {
+            handler_->handle_body(at, length);
+        }
+
         inline void process_message()
         {
             handler_->handle();
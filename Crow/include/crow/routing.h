@@ -128,6 +128,13 @@ namespace crow // NOTE: Already documented in "crow/app.h"
             res.end();
         }
 #endif
+#ifdef CROW_HAS_UNIX_SOCKETS
+        virtual void handle_upgrade(const request&, response& res, UnixSocketAdaptor&&)
+        {
+            res = response(404);
+            res.end();
+        }
+#endif
 
         uint32_t get_methods()
         {
@@ -102,6 +102,78 @@ namespace crow
         tcp::socket socket_;
     };
 
+#if defined(ASIO_HAS_LOCAL_SOCKETS) || defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#define CROW_HAS_UNIX_SOCKETS
+    using stream_protocol = asio::local::stream_protocol;
+
+    /// A wrapper for a unix domain stream socket, for clients on the same host.
+    struct UnixSocketAdaptor
+    {
+        using context = void;
+        UnixSocketAdaptor(asio::io_context& io_context, context*):
+          socket_(io_context)
+        {}
+
+        asio::io_context& get_io_context()
+        {
+            return GET_IO_CONTEXT(socket_);
+        }
+
+        stream_protocol::socket& raw_socket()
+        {
+            return socket_;
+        }
+
+        stream_protocol::socket& socket()
+        {
+            return socket_;
+        }
+
+        /// Unix domain peers have no IP address; they are reported as the loopback address.
+        tcp::endpoint remote_endpoint()
+        {
+            return tcp::endpoint(asio::ip::address_v4::loopback(), 0);
+        }
+
+        bool is_open()
+        {
+            return socket_.is_open();
+        }
+
+        void close()
+        {
+            error_code ec;
+            socket_.close(ec);
+        }
+
+        void shutdown_readwrite()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_both, ec);
+        }
+
+        void shutdown_write()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_send, ec);
+        }
+
+        void shutdown_read()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_receive, ec);
+        }
+
+        template<typename F>
+        void start(F f)
+        {
+            f(error_code());
+        }
+
+        stream_protocol::socket socket_;
+    };
+#endif
+
 #ifdef CROW_ENABLE_SSL
     struct SSLAdaptor
     {
@@ -0,0 +1,288 @@
+#include "algorithm_catalog.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Message signed by the signature benchmarks
+constexpr size_t message_bytes = 64;
+
+// Thrown out of an operation to abandon the benchmark when the catalog is destroyed
+struct Stopped {};
+
+AlgorithmInfo describe_kem(const OQS_KEM *kem) {
+    AlgorithmInfo info;
+    info.name = kem->method_name;
+    info.kind = KeyKind::Kem;
+    info.version = kem->alg_version ? kem->alg_version : "";
+    info.nist_level = kem->claimed_nist_level;
+    info.strong_security = kem->ind_cca;
+    info.public_key_bytes = kem->length_public_key;
+    info.secret_key_bytes = kem->length_secret_key;
+    info.ciphertext_bytes = kem->length_ciphertext;
+    info.shared_secret_bytes = kem->length_shared_secret;
+    return info;
+}
+
+AlgorithmInfo describe_sig(const OQS_SIG *sig) {
+    AlgorithmInfo info;
+    info.name = sig->method_name;
+    info.kind = KeyKind::Signature;
+    info.version = sig->alg_version ? sig->alg_version : "";
+    info.nist_level = sig->claimed_nist_level;
+    info.strong_security = sig->euf_cma;
+    info.public_key_bytes = sig->length_public_key;
+    info.secret_key_bytes = sig->length_secret_key;
+    info.signature_bytes = sig->length_signature;
+    return info;
+}
+
+// Every KEM and then every signature scheme that liboqs was built with
+std::vector<AlgorithmInfo> list_algorithms() {
+    std::vector<AlgorithmInfo> algorithms;
+    for (int i = 0; i < OQS_KEM_alg_count(); i++) {
+        const char *name = OQS_KEM_alg_identifier(size_t(i));
+        if (!name || !OQS_KEM_alg_is_enabled(name)) {
+            continue;
+        }
+        if (OQS_KEM *kem = OQS_KEM_new(name)) {
+            algorithms.push_back(describe_kem(kem));
+            OQS_KEM_free(kem);
+        }
+    }
+    for (int i = 0; i < OQS_SIG_alg_count(); i++) {
+        const char *name = OQS_SIG_alg_identifier(size_t(i));
+        if (!name || !OQS_SIG_alg_is_enabled(name)) {
+            continue;
+        }
+        if (OQS_SIG *sig = OQS_SIG_new(name)) {
+            algorithms.push_back(describe_sig(sig));
+            OQS_SIG_free(sig);
+        }
+    }
+    return algorithms;
+}
+
+// Run op once to warm up, then time single calls until the budget is spent.
+// op returns false when the library reports an error.
+template <typename F>
+OperationTiming measure(const char *name, std::chrono::milliseconds budget, const std::atomic<bool> &stop, F op) {
+    if (!op()) {
+        throw std::runtime_error(std::string(name) + " failed");
+    }
+
+    std::vector<double> samples;
+    double total_ns = 0;
+    Clock::time_point deadline = Clock::now() + budget;
+    while (samples.size() < AlgorithmCatalog::min_samples ||
+           (samples.size() < AlgorithmCatalog::max_samples && Clock::now() < deadline)) {
+        if (stop.load(std::memory_order_relaxed)) {
+            throw Stopped();
+        }
+        Clock::time_point start = Clock::now();
+        bool ok = op();
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        if (!ok) {
+            throw std::runtime_error(std::string(name) + " failed");
+        }
+        samples.push_back(elapsed.count());
+        total_ns += elapsed.count();
+    }
+
+    OperationTiming timing;
+    timing.name = name;
+    timing.samples = samples.size();
+    timing.ops_per_sec = total_ns > 0 ? samples.size() * 1e9 / total_ns : 0;
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    timing.p50_us = samples[samples.size() / 2] / 1e3;
+    return timing;
+}
+
+void benchmark_kem(AlgorithmInfo &info, std::chrono::milliseconds budget, const std::atomic<bool> &stop) {
+    OQS_KEM *kem = OQS_KEM_new(info.name.c_str());
+    if (!kem) {
+        throw std::runtime_error("Failed to initialize KEM");
+    }
+    std::vector<uint8_t> public_key(kem->length_public_key), secret_key(kem->length_secret_key);
+    std::vector<uint8_t> ciphertext(kem->length_ciphertext), shared_secret(kem->length_shared_secret);
+    try {
+        info.operations.push_back(measure("keypair", budget, stop, [&] {
+            return OQS_KEM_keypair(kem, public_key.data(), secret_key.data()) == OQS_SUCCESS;
+        }));
+        info.operations.push_back(measure("encaps", budget, stop, [&] {
+            return OQS_KEM_encaps(kem, ciphertext.data(), shared_secret.data(), public_key.data()) == OQS_SUCCESS;
+        }));
+        info.operations.push_back(measure("decaps", budget, stop, [&] {
+            return OQS_KEM_decaps(kem, shared_secret.data(), ciphertext.data(), secret_key.data()) == OQS_SUCCESS;
+        }));
+    } catch (...) {
+        OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+        OQS_KEM_free(kem);
+        throw;
+    }
+    OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+    OQS_KEM_free(kem);
+}
+
+void benchmark_sig(AlgorithmInfo &info, std::chrono::milliseconds budget, const std::atomic<bool> &stop) {
+    OQS_SIG *sig = OQS_SIG_new(info.name.c_str());
+    if (!sig) {
+        throw std::runtime_error("Failed to initialize signature");
+    }
+    std::vector<uint8_t> public_key(sig->length_public_key), secret_key(sig->length_secret_key);
+    std::vector<uint8_t> signature(sig->length_signature), message(message_bytes);
+    size_t signature_len = 0;
+    OQS_randombytes(message.data(), message.size());
+    try {
+        info.operations.push_back(measure("keypair", budget, stop, [&] {
+            return OQS_SIG_keypair(sig, public_key.data(), secret_key.data()) == OQS_SUCCESS;
+        }));
+        info.operations.push_back(measure("sign", budget, stop, [&] {
+            return OQS_SIG_sign(sig, signature.data(), &signature_len, message.data(), message.size(),
+                                secret_key.data()) == OQS_SUCCESS;
+        }));
+        info.operations.push_back(measure("verify", budget, stop, [&] {
+            return OQS_SIG_verify(sig, message.data(), message.size(), signature.data(), signature_len,
+                                  public_key.data()) == OQS_SUCCESS;
+        }));
+    } catch (...) {
+        OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+        OQS_SIG_free(sig);
+        throw;
+    }
+    OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+    OQS_SIG_free(sig);
+}
+
+} // namespace
+
+AlgorithmCatalog::AlgorithmCatalog(std::chrono::milliseconds budget_per_operation)
+    : budget_(budget_per_operation) {
+    auto snapshot = std::make_shared<CatalogSnapshot>();
+    snapshot->algorithms = list_algorithms();
+    snapshot_ = std::move(snapshot);
+    refresh();
+}
+
+AlgorithmCatalog::~AlgorithmCatalog() {
+    stop_.store(true);
+    // Join outside the lock, which run() takes to publish its snapshot
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker = std::move(worker_);
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<const CatalogSnapshot> AlgorithmCatalog::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+bool AlgorithmCatalog::refresh() {
+    if (budget_.count() <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (measuring_.load()) {
+        return true;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    measuring_.store(true);
+    worker_ = std::thread(&AlgorithmCatalog::run, this);
+    return true;
+}
+
+void AlgorithmCatalog::run() {
+    auto snapshot = std::make_shared<CatalogSnapshot>();
+    snapshot->algorithms = list_algorithms();
+    try {
+        for (AlgorithmInfo &info : snapshot->algorithms) {
+            try {
+                if (info.kind == KeyKind::Kem) {
+                    benchmark_kem(info, budget_, stop_);
+                } else {
+                    benchmark_sig(info, budget_, stop_);
+                }
+            } catch (const std::exception &e) {
+                info.error = e.what();
+            }
+        }
+    } catch (const Stopped &) {
+        measuring_.store(false);
+        return;
+    }
+    snapshot->benchmarked = true;
+    snapshot->measured_at = std::chrono::system_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = std::move(snapshot);
+    measuring_.store(false);
+}
+
+SelectionPolicy::Goal parse_selection_goal(const std::string &name) {
+    if (name == "latency") {
+        return SelectionPolicy::Goal::Latency;
+    }
+    if (name == "bandwidth") {
+        return SelectionPolicy::Goal::Bandwidth;
+    }
+    if (name == "key_size") {
+        return SelectionPolicy::Goal::KeySize;
+    }
+    throw std::invalid_argument("optimize must be latency, bandwidth or key_size");
+}
+
+double latency_us(const AlgorithmInfo &info) {
+    double total = 0;
+    for (const OperationTiming &op : info.operations) {
+        if (op.name != "keypair") {
+            total += op.p50_us;
+        }
+    }
+    return total;
+}
+
+size_t bandwidth_bytes(const AlgorithmInfo &info) {
+    return info.kind == KeyKind::Kem ? info.public_key_bytes + info.ciphertext_bytes : info.signature_bytes;
+}
+
+const AlgorithmInfo *select_algorithm(const CatalogSnapshot &snapshot, const SelectionPolicy &policy) {
+    // Sort key: the optimised quantity first (0 when optimising latency), then latency and name
+    auto rank = [&](const AlgorithmInfo &info) {
+        double primary = 0;
+        if (policy.optimize == SelectionPolicy::Goal::Bandwidth) {
+            primary = double(bandwidth_bytes(info));
+        } else if (policy.optimize == SelectionPolicy::Goal::KeySize) {
+            primary = double(info.public_key_bytes);
+        }
+        return std::make_tuple(primary, latency_us(info), std::cref(info.name));
+    };
+
+    const AlgorithmInfo *best = nullptr;
+    for (const AlgorithmInfo &info : snapshot.algorithms) {
+        if (info.kind != policy.kind || !info.strong_security || !info.error.empty() ||
+            info.nist_level < policy.min_nist_level || info.name.compare(0, policy.name_prefix.size(), policy.name_prefix) != 0) {
+            continue;
+        }
+        if (policy.needs_timings() && info.operations.empty()) {
+            continue;
+        }
+        if (policy.max_latency_us > 0 && latency_us(info) > policy.max_latency_us) {
+            continue;
+        }
+        if (!best || rank(info) < rank(*best)) {
+            best = &info;
+        }
+    }
+    return best;
+}
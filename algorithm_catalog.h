@@ -0,0 +1,111 @@
+#ifndef ALGORITHM_CATALOG_H
+#define ALGORITHM_CATALOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "key_registry.h"
+
+// Timing of one operation (keypair, encaps, decaps, sign or verify) on this host
+struct OperationTiming {
+    std::string name;
+    size_t samples = 0;
+    double ops_per_sec = 0;
+    double p50_us = 0;
+};
+
+// A KEM or signature scheme enabled in the linked liboqs
+struct AlgorithmInfo {
+    std::string name;
+    KeyKind kind;
+    std::string version;
+    int nist_level = 0;
+    bool strong_security = false;  // IND-CCA for a KEM, EUF-CMA for a signature
+    size_t public_key_bytes = 0;
+    size_t secret_key_bytes = 0;
+    size_t ciphertext_bytes = 0;     // KEM only
+    size_t shared_secret_bytes = 0;  // KEM only
+    size_t signature_bytes = 0;      // Signature only
+    std::vector<OperationTiming> operations;  // Empty until benchmarked
+    std::string error;                        // Set when an operation failed while benchmarked
+};
+
+struct CatalogSnapshot {
+    std::vector<AlgorithmInfo> algorithms;
+    bool benchmarked = false;
+    std::chrono::system_clock::time_point measured_at;
+};
+
+// What a caller asks for when it lets the server pick the algorithm. Only IND-CCA
+// KEMs and EUF-CMA signature schemes whose benchmark did not fail qualify.
+struct SelectionPolicy {
+    enum class Goal { Latency, Bandwidth, KeySize };
+
+    KeyKind kind = KeyKind::Kem;
+    std::string name_prefix;    // Restrict to names starting with this, e.g. "ML-DSA-"
+    int min_nist_level = 1;
+    Goal optimize = Goal::Latency;
+    double max_latency_us = 0;  // Limit on latency_us(); 0 for none
+
+    // Latency goals and limits can only be resolved once timings are measured
+    bool needs_timings() const { return optimize == Goal::Latency || max_latency_us > 0; }
+};
+
+// Goal named "latency", "bandwidth" or "key_size". Throws std::invalid_argument otherwise.
+SelectionPolicy::Goal parse_selection_goal(const std::string &name);
+
+// Median cost of using a key once: encaps + decaps for a KEM, sign + verify for a
+// signature. Key generation is left out since a selected key is reused.
+double latency_us(const AlgorithmInfo &info);
+
+// Bytes exchanged per use: public key + ciphertext for a KEM, the signature otherwise
+size_t bandwidth_bytes(const AlgorithmInfo &info);
+
+// The best algorithm of the snapshot for the policy, ties going to the lower latency
+// and then to the name. nullptr when none qualifies.
+const AlgorithmInfo *select_algorithm(const CatalogSnapshot &snapshot, const SelectionPolicy &policy);
+
+// Catalog of every enabled liboqs algorithm with a microbenchmark of its operations.
+//
+// The sizes are read when the catalog is built. The benchmark runs on a background
+// thread so the server can take requests meanwhile: each operation is repeated until
+// budget_per_operation has passed (at least min_samples times) and its median latency
+// and throughput are recorded. Readers get the last complete snapshot, which
+// refresh() replaces by measuring again. A zero budget disables the benchmark.
+class AlgorithmCatalog {
+public:
+    static constexpr size_t min_samples = 3;
+    static constexpr size_t max_samples = 10000;
+
+    explicit AlgorithmCatalog(std::chrono::milliseconds budget_per_operation);
+    ~AlgorithmCatalog();
+
+    AlgorithmCatalog(const AlgorithmCatalog &) = delete;
+    AlgorithmCatalog &operator=(const AlgorithmCatalog &) = delete;
+
+    std::shared_ptr<const CatalogSnapshot> snapshot() const;
+
+    // Start a new measurement unless one is already running. Returns false when
+    // benchmarking is disabled.
+    bool refresh();
+
+    bool measuring() const { return measuring_.load(); }
+    std::chrono::milliseconds budget() const { return budget_; }
+
+private:
+    void run();
+
+    std::chrono::milliseconds budget_;
+    mutable std::mutex mutex_;  // Guards snapshot_ and worker_
+    std::shared_ptr<const CatalogSnapshot> snapshot_;
+    std::thread worker_;
+    std::atomic<bool> measuring_{false};
+    std::atomic<bool> stop_{false};
+};
+
+#endif // ALGORITHM_CATALOG_H
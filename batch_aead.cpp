@@ -0,0 +1,185 @@
+#include "batch_aead.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <oqs/oqs.h>
+#include <openssl/kdf.h>
+
+namespace batch_aead {
+
+namespace {
+
+using PkeyCtxPtr = std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)>;
+using CipherCtxPtr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+using MdCtxPtr = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+const char kdf_label[] = "ml-kem-api bulk item v1";
+
+// HKDF-SHA256 in the given mode (extract only or expand only)
+void hkdf(int mode, const uint8_t *key, size_t key_len, const uint8_t *info, size_t info_len,
+          uint8_t *out, size_t out_len) {
+    PkeyCtxPtr ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr), EVP_PKEY_CTX_free);
+    bool ok = ctx && EVP_PKEY_derive_init(ctx.get()) > 0 &&
+              EVP_PKEY_CTX_hkdf_mode(ctx.get(), mode) > 0 &&
+              EVP_PKEY_CTX_set_hkdf_md(ctx.get(), EVP_sha256()) > 0 &&
+              EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), key, key_len) > 0 &&
+              (info_len == 0 || EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), info, info_len) > 0) &&
+              EVP_PKEY_derive(ctx.get(), out, &out_len) > 0;
+    if (!ok) {
+        throw std::runtime_error("Batch key derivation failed");
+    }
+}
+
+// AES-256-GCM context of the calling thread with the cipher already set up; callers
+// only load a key and nonce with EVP_CipherInit_ex
+EVP_CIPHER_CTX *gcm_context() {
+    thread_local CipherCtxPtr ctx(nullptr, EVP_CIPHER_CTX_free);
+    if (!ctx) {
+        CipherCtxPtr fresh(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+        if (!fresh || EVP_CipherInit_ex(fresh.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr, 1) <= 0) {
+            throw std::runtime_error("Failed to initialize AES-256-GCM");
+        }
+        ctx = std::move(fresh);
+    }
+    return ctx.get();
+}
+
+} // namespace
+
+BatchKeys::BatchKeys(const uint8_t *shared_secret, size_t shared_secret_len)
+    : inner_(EVP_MD_CTX_new()), outer_(EVP_MD_CTX_new()) {
+    uint8_t prk[32];
+    hkdf(EVP_PKEY_HKDEF_MODE_EXTRACT_ONLY, shared_secret, shared_secret_len, nullptr, 0, prk, sizeof(prk));
+
+    // HMAC-SHA256 keyed with prk, minus the message: one padded key block per state
+    uint8_t ipad[64], opad[64];
+    for (size_t i = 0; i < sizeof(ipad); i++) {
+        uint8_t k = i < sizeof(prk) ? prk[i] : 0;
+        ipad[i] = k ^ 0x36;
+        opad[i] = k ^ 0x5c;
+    }
+    bool ok = inner_ && outer_ &&
+              EVP_DigestInit_ex(inner_, EVP_sha256(), nullptr) > 0 && EVP_DigestUpdate(inner_, ipad, sizeof(ipad)) > 0 &&
+              EVP_DigestInit_ex(outer_, EVP_sha256(), nullptr) > 0 && EVP_DigestUpdate(outer_, opad, sizeof(opad)) > 0;
+    OQS_MEM_cleanse(prk, sizeof(prk));
+    OQS_MEM_cleanse(ipad, sizeof(ipad));
+    OQS_MEM_cleanse(opad, sizeof(opad));
+    if (!ok) {
+        EVP_MD_CTX_free(inner_);
+        EVP_MD_CTX_free(outer_);
+        throw std::runtime_error("Batch key derivation failed");
+    }
+}
+
+BatchKeys::~BatchKeys() {
+    EVP_MD_CTX_free(inner_);
+    EVP_MD_CTX_free(outer_);
+}
+
+void BatchKeys::hmac(const uint8_t *data, size_t len, uint8_t out[32]) const {
+    MdCtxPtr ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    unsigned int out_len = 0;
+    bool ok = ctx && EVP_MD_CTX_copy_ex(ctx.get(), inner_) > 0 && EVP_DigestUpdate(ctx.get(), data, len) > 0 &&
+              EVP_DigestFinal_ex(ctx.get(), out, &out_len) > 0 &&
+              EVP_MD_CTX_copy_ex(ctx.get(), outer_) > 0 && EVP_DigestUpdate(ctx.get(), out, 32) > 0 &&
+              EVP_DigestFinal_ex(ctx.get(), out, &out_len) > 0;
+    if (!ok) {
+        throw std::runtime_error("Batch key derivation failed");
+    }
+}
+
+// HKDF-Expand: T(1) = HMAC(info || 1) and T(2) = HMAC(T(1) || info || 2) give the 44 bytes
+void BatchKeys::derive(uint64_t index, uint8_t key[key_length], uint8_t nonce[nonce_length]) const {
+    constexpr size_t label_length = sizeof(kdf_label) - 1;
+    uint8_t block[32 + label_length + 8 + 1];
+    uint8_t *info = block + 32;
+    std::memcpy(info, kdf_label, label_length);
+    for (int i = 0; i < 8; i++) {
+        info[label_length + i] = uint8_t(index >> (56 - 8 * i));
+    }
+
+    uint8_t okm[64];
+    info[label_length + 8] = 1;
+    hmac(info, label_length + 9, okm);
+    std::memcpy(block, okm, 32);
+    info[label_length + 8] = 2;
+    hmac(block, sizeof(block), okm + 32);
+
+    std::memcpy(key, okm, key_length);
+    std::memcpy(nonce, okm + key_length, nonce_length);
+    OQS_MEM_cleanse(okm, sizeof(okm));
+    OQS_MEM_cleanse(block, 32);
+}
+
+std::vector<uint8_t> BatchKeys::seal(uint64_t index, const uint8_t *plaintext, size_t len) const {
+    uint8_t key[key_length], nonce[nonce_length];
+    derive(index, key, nonce);
+    try {
+        std::vector<uint8_t> sealed = gcm_seal(key, nonce, plaintext, len);
+        OQS_MEM_cleanse(key, sizeof(key));
+        return sealed;
+    } catch (...) {
+        OQS_MEM_cleanse(key, sizeof(key));
+        throw;
+    }
+}
+
+std::string BatchKeys::open(uint64_t index, const uint8_t *sealed, size_t len) const {
+    uint8_t key[key_length], nonce[nonce_length];
+    derive(index, key, nonce);
+    try {
+        std::string plaintext = gcm_open(key, nonce, sealed, len);
+        OQS_MEM_cleanse(key, sizeof(key));
+        return plaintext;
+    } catch (...) {
+        OQS_MEM_cleanse(key, sizeof(key));
+        throw;
+    }
+}
+
+void hkdf_sha256(const uint8_t *ikm, size_t ikm_len, const uint8_t *info, size_t info_len,
+                 uint8_t *out, size_t out_len) {
+    hkdf(EVP_PKEY_HKDEF_MODE_EXTRACT_AND_EXPAND, ikm, ikm_len, info, info_len, out, out_len);
+}
+
+std::vector<uint8_t> gcm_seal(const uint8_t key[key_length], const uint8_t nonce[nonce_length],
+                              const uint8_t *plaintext, size_t len) {
+    std::vector<uint8_t> sealed(len + tag_length);
+    EVP_CIPHER_CTX *ctx = gcm_context();
+    int out_len = 0, final_len = 0;
+    bool ok = EVP_CipherInit_ex(ctx, nullptr, nullptr, key, nonce, 1) > 0 &&
+              EVP_EncryptUpdate(ctx, sealed.data(), &out_len, plaintext, int(len)) > 0 &&
+              EVP_EncryptFinal_ex(ctx, sealed.data() + out_len, &final_len) > 0 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, int(tag_length), sealed.data() + len) > 0;
+    if (!ok) {
+        throw std::runtime_error("AES-GCM encryption failed");
+    }
+    return sealed;
+}
+
+std::string gcm_open(const uint8_t key[key_length], const uint8_t nonce[nonce_length],
+                     const uint8_t *sealed, size_t len) {
+    if (len < tag_length) {
+        throw std::invalid_argument("Ciphertext is shorter than its tag");
+    }
+    size_t text_len = len - tag_length;
+    std::string plaintext(text_len, '\0');
+    uint8_t tag[tag_length];
+    std::memcpy(tag, sealed + text_len, tag_length);
+    EVP_CIPHER_CTX *ctx = gcm_context();
+    int out_len = 0, final_len = 0;
+    bool ok = EVP_CipherInit_ex(ctx, nullptr, nullptr, key, nonce, 0) > 0 &&
+              EVP_DecryptUpdate(ctx, reinterpret_cast<uint8_t *>(&plaintext[0]), &out_len, sealed, int(text_len)) > 0 &&
+              EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, int(tag_length), tag) > 0;
+    if (!ok) {
+        throw std::runtime_error("AES-GCM decryption failed");
+    }
+    if (EVP_DecryptFinal_ex(ctx, reinterpret_cast<uint8_t *>(&plaintext[0]) + out_len, &final_len) <= 0) {
+        OQS_MEM_cleanse(&plaintext[0], plaintext.size());
+        throw std::invalid_argument("Ciphertext failed authentication");
+    }
+    return plaintext;
+}
+
+} // namespace batch_aead
@@ -0,0 +1,62 @@
+#ifndef BATCH_AEAD_H
+#define BATCH_AEAD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <openssl/evp.h>
+
+// AES-256-GCM for every message of a batch under one KEM shared secret, so a batch
+// to a single public key costs one encapsulation (and one decapsulation) instead of
+// one per message.
+//
+// The shared secret goes through HKDF-Extract once; item i then gets its own key and
+// nonce from HKDF-Expand(prk, label || uint64_be(i), 44). Keys are never reused across
+// items, and the index is bound to the ciphertext, so items cannot be swapped without
+// failing authentication. A sealed item is the GCM ciphertext followed by its tag.
+//
+// HKDF-Expand runs on SHA-256 states with the HMAC pads already absorbed, and each
+// thread keeps one AES-GCM context that is only rekeyed per item, so the per-item cost
+// stays a few compressions and the AES itself rather than OpenSSL object setup.
+// Library failures throw std::runtime_error and a failed tag std::invalid_argument.
+namespace batch_aead {
+
+constexpr size_t key_length = 32;
+constexpr size_t nonce_length = 12;
+constexpr size_t tag_length = 16;
+
+// HKDF-SHA256 with an empty salt: out_len bytes of key material for the given info
+void hkdf_sha256(const uint8_t *ikm, size_t ikm_len, const uint8_t *info, size_t info_len,
+                 uint8_t *out, size_t out_len);
+
+// AES-256-GCM with a caller-chosen key and nonce on the calling thread's context. The
+// result of gcm_seal is the ciphertext followed by the tag.
+std::vector<uint8_t> gcm_seal(const uint8_t key[key_length], const uint8_t nonce[nonce_length],
+                              const uint8_t *plaintext, size_t len);
+std::string gcm_open(const uint8_t key[key_length], const uint8_t nonce[nonce_length],
+                     const uint8_t *sealed, size_t len);
+
+class BatchKeys {
+public:
+    // Throws std::runtime_error when OpenSSL cannot set up HKDF or SHA-256
+    BatchKeys(const uint8_t *shared_secret, size_t shared_secret_len);
+    ~BatchKeys();
+
+    BatchKeys(const BatchKeys &) = delete;
+    BatchKeys &operator=(const BatchKeys &) = delete;
+
+    void derive(uint64_t index, uint8_t key[key_length], uint8_t nonce[nonce_length]) const;
+
+    std::vector<uint8_t> seal(uint64_t index, const uint8_t *plaintext, size_t len) const;
+    std::string open(uint64_t index, const uint8_t *sealed, size_t len) const;
+
+private:
+    void hmac(const uint8_t *data, size_t len, uint8_t out[32]) const;
+
+    EVP_MD_CTX *inner_;  // SHA-256 after absorbing prk ^ ipad
+    EVP_MD_CTX *outer_;  // SHA-256 after absorbing prk ^ opad
+};
+
+} // namespace batch_aead
+
+#endif // BATCH_AEAD_H
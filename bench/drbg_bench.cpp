@@ -0,0 +1,68 @@
+// Cost of the randomness behind OQS_randombytes: liboqs' default source, a direct
+// getrandom() per request and the per-thread ChaCha20 DRBG, for the request sizes of
+// an ML-KEM encapsulation (32 bytes), a keygen (64 bytes) and a larger read. The
+// DRBG is also run on several threads at once.
+//
+// Usage: drbg_bench [iterations] [threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <oqs/oqs.h>
+#include <sys/random.h>
+#include "drbg.h"
+
+namespace {
+
+template <typename F>
+double time_ns(int iterations, F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        f();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void bench_size(size_t len, int iterations) {
+    std::vector<uint8_t> buf(len);
+    double liboqs = time_ns(iterations, [&] { OQS_randombytes(buf.data(), len); });
+    double system = time_ns(iterations, [&] { (void)getrandom(buf.data(), len, 0); });
+    double drbg = time_ns(iterations, [&] { drbg::randombytes(buf.data(), len); });
+    std::printf("%5zu bytes   liboqs default %8.1f ns   getrandom %8.1f ns   drbg %8.1f ns (%.2f ns/byte)\n",
+                len, liboqs, system, drbg, drbg / double(len));
+}
+
+void bench_threads(int threads, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([iterations] {
+            uint8_t buf[32];
+            for (int i = 0; i < iterations; i++) {
+                drbg::randombytes(buf, sizeof(buf));
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double total = double(threads) * iterations;
+    std::printf("%d threads   drbg 32-byte requests %.1f M/s\n", threads, total / elapsed.count() / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : int(std::thread::hardware_concurrency());
+
+    for (size_t len : {size_t(32), size_t(64), size_t(4096)}) {
+        bench_size(len, len > 1024 ? iterations / 16 : iterations);
+    }
+    bench_threads(threads > 0 ? threads : 1, iterations);
+    return 0;
+}
@@ -0,0 +1,247 @@
+// HTTP load against a running server: C connections each with one request in flight
+// for D seconds, over keep-alive connections or a new connection per request. Reports
+// throughput and latency percentiles and, given the server's pid, the server CPU time
+// and context switches per request, which is where the I/O backends (epoll, io_uring)
+// differ for small requests.
+//
+// The client itself is one thread on epoll so that it behaves the same against every
+// server build.
+//
+// Usage: http_load_bench [-c connections] [-d seconds] [-n] [-p server_pid] [-P port]
+//                        [-U unix_socket] [-b body_file] [METHOD PATH]
+// Defaults: 64 connections, 10 seconds, port 5001, GET /verify_cache
+// -U connects to the server's unix domain socket (UNIX_SOCKET) instead of the port.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Connection {
+    int fd = -1;
+    std::string in;
+    Clock::time_point sent_at;
+};
+
+struct ServerSample {
+    double cpu_seconds = 0;
+    long context_switches = 0;
+};
+
+int open_connection(uint16_t port, const std::string &unix_socket) {
+    int fd;
+    int connected;
+    if (!unix_socket.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, unix_socket.c_str(), sizeof(addr.sun_path) - 1);
+        connected = fd >= 0 ? connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) : -1;
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected = fd >= 0 ? connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) : -1;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    if (connected != 0) {
+        std::perror("connect");
+        std::exit(1);
+    }
+    return fd;
+}
+
+void send_all(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno != EINTR) {
+            std::perror("send");
+            std::exit(1);
+        }
+        sent += n > 0 ? size_t(n) : 0;
+    }
+}
+
+// Length of the complete response at the start of in, or 0 while it is incomplete
+size_t response_length(const std::string &in, int &status) {
+    size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        return 0;
+    }
+    status = std::atoi(in.c_str() + in.find(' ') + 1);
+    size_t body_length = 0;
+    std::string headers = in.substr(0, header_end);
+    std::transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+    size_t field = headers.find("content-length:");
+    if (field != std::string::npos) {
+        body_length = std::strtoul(headers.c_str() + field + 15, nullptr, 10);
+    }
+    size_t total = header_end + 4 + body_length;
+    return in.size() >= total ? total : 0;
+}
+
+// CPU time of the whole process and context switches summed over its threads
+ServerSample sample_server(long pid) {
+    ServerSample sample;
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    std::getline(stat, line);
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    for (int i = 3; i <= 15 && fields >> field; i++) {
+        if (i == 14 || i == 15) {
+            sample.cpu_seconds += std::stod(field) / double(sysconf(_SC_CLK_TCK));
+        }
+    }
+
+    std::string tasks = "/proc/" + std::to_string(pid) + "/task";
+    if (DIR *dir = opendir(tasks.c_str())) {
+        while (dirent *entry = readdir(dir)) {
+            std::ifstream status(tasks + "/" + entry->d_name + "/status");
+            while (std::getline(status, line)) {
+                if (line.find("ctxt_switches:") != std::string::npos) {
+                    sample.context_switches += std::atol(line.c_str() + line.find(':') + 1);
+                }
+            }
+        }
+        closedir(dir);
+    }
+    return sample;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int connections = 64;
+    double seconds = 10;
+    bool new_connections = false;
+    long server_pid = 0;
+    uint16_t port = 5001;
+    std::string unix_socket, body, method = "GET", path = "/verify_cache";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:d:np:P:U:b:")) != -1) {
+        switch (opt) {
+        case 'c': connections = std::atoi(optarg); break;
+        case 'd': seconds = std::atof(optarg); break;
+        case 'n': new_connections = true; break;
+        case 'p': server_pid = std::atol(optarg); break;
+        case 'P': port = uint16_t(std::atoi(optarg)); break;
+        case 'U': unix_socket = optarg; break;
+        case 'b': {
+            std::ifstream file(optarg, std::ios::binary);
+            body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            break;
+        }
+        default:
+            std::fprintf(stderr, "usage: %s [-c connections] [-d seconds] [-n] [-p server_pid] [-P port] [-U unix_socket] [-b body_file] [METHOD PATH]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind + 2 <= argc) {
+        method = argv[optind];
+        path = argv[optind + 1];
+    }
+
+    std::string request = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+    if (!body.empty()) {
+        request += "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    request += "\r\n" + body;
+
+    int epoll_fd = epoll_create1(0);
+    std::vector<Connection> pool(connections);
+    auto start_request = [&](size_t i) {
+        Connection &c = pool[i];
+        if (c.fd < 0) {
+            c.fd = open_connection(port, unix_socket);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c.fd, &event);
+        }
+        c.in.clear();
+        c.sent_at = Clock::now();
+        send_all(c.fd, request);
+    };
+
+    ServerSample before = server_pid ? sample_server(server_pid) : ServerSample();
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    for (size_t i = 0; i < pool.size(); i++) {
+        start_request(i);
+    }
+
+    std::vector<uint32_t> latencies_us;
+    size_t errors = 0;
+    std::vector<epoll_event> events(pool.size());
+    char buffer[65536];
+    while (Clock::now() < deadline) {
+        int ready = epoll_wait(epoll_fd, events.data(), int(events.size()), 100);
+        for (int e = 0; e < ready; e++) {
+            size_t i = events[e].data.u64;
+            Connection &c = pool[i];
+            ssize_t n = recv(c.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    continue;
+                }
+                errors++;
+                close(c.fd);
+                c.fd = -1;
+                start_request(i);
+                continue;
+            }
+            c.in.append(buffer, size_t(n));
+            int status = 0;
+            if (!response_length(c.in, status)) {
+                continue;
+            }
+            latencies_us.push_back(uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - c.sent_at).count()));
+            errors += status >= 400;
+            if (new_connections) {
+                close(c.fd);
+                c.fd = -1;
+            }
+            start_request(i);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    ServerSample after = server_pid ? sample_server(server_pid) : ServerSample();
+
+    size_t requests = latencies_us.size();
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto percentile = [&](double p) { return requests ? latencies_us[size_t(p * double(requests - 1))] : 0u; };
+    std::printf("%s %s, %d %s connections, %.1f s\n", method.c_str(), path.c_str(), connections,
+                new_connections ? "new" : "keep-alive", elapsed);
+    std::printf("requests %zu (%zu errors)   %.0f req/s   latency p50 %u us  p99 %u us  max %u us\n",
+                requests, errors, double(requests) / elapsed, percentile(0.50), percentile(0.99), percentile(1.0));
+    if (server_pid && requests) {
+        std::printf("server cpu %.1f us/request   context switches %.2f/request\n",
+                    1e6 * (after.cpu_seconds - before.cpu_seconds) / double(requests),
+                    double(after.context_switches - before.context_switches) / double(requests));
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Runs the epoll build (mlKemAPIDil) and the io_uring build (mlKemAPIDil-uring, from
+# "make io_uring") under the same http_load_bench load, one after the other.
+# Extra arguments go to http_load_bench, e.g.: bench/io_uring_compare.sh -c 256 -d 20
+set -e
+cd "$(dirname "$0")/.."
+
+for server in ./mlKemAPIDil ./mlKemAPIDil-uring; do
+    if [ ! -x "$server" ]; then
+        echo "$server not built, skipped"
+        continue
+    fi
+    echo "== $server"
+    ALGORITHMS_BENCH_MS=0 "$server" > /dev/null 2>&1 &
+    pid=$!
+    sleep 1
+    ./bench/http_load_bench -p "$pid" "$@"
+    ./bench/http_load_bench -n -p "$pid" "$@"
+    kill "$pid"
+    wait "$pid" 2> /dev/null || true
+done
@@ -0,0 +1,148 @@
+// Lookup throughput of the key registry table against a shared_mutex protected
+// unordered_map, for 1 up to hardware_concurrency reader threads. A writer
+// thread keeps registering and removing keys so both tables see some churn.
+//
+// Usage: key_table_bench [keys] [seconds_per_run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "concurrent_table.h"
+
+struct Value {
+    std::vector<uint8_t> public_key = std::vector<uint8_t>(32);
+};
+
+class LockedMap {
+public:
+    bool lookup(const std::string &id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        return it != entries_.end() && it->second->public_key.size() == 32;
+    }
+
+    void insert(const std::string &id) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        entries_.emplace(id, std::make_shared<Value>());
+    }
+
+    void erase(const std::string &id) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        entries_.erase(id);
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<const Value>> entries_;
+};
+
+class EpochTable {
+public:
+    bool lookup(const std::string &id) const {
+        epoch::Guard guard;
+        const Value *value = entries_.find(id);
+        return value && value->public_key.size() == 32;
+    }
+
+    void insert(const std::string &id) {
+        epoch::Guard guard;
+        entries_.insert(id, std::make_unique<Value>());
+    }
+
+    void erase(const std::string &id) {
+        entries_.erase(id);
+    }
+
+private:
+    ConcurrentTable<Value> entries_;
+};
+
+std::string make_id(uint64_t n) {
+    char buffer[33];
+    std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+                  static_cast<unsigned long long>(n * 0x9e3779b97f4a7c15ULL),
+                  static_cast<unsigned long long>(n));
+    return buffer;
+}
+
+// Returns lookups per second over all reader threads
+template <typename Table>
+double run(Table &table, const std::vector<std::string> &ids, unsigned readers, double seconds) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < readers; t++) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            uint64_t done = 0;
+            uint64_t found = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; i++) {
+                    found += table.lookup(ids[rng() % ids.size()]);
+                }
+                done += 256;
+            }
+            total += done;
+            if (found == 0) {
+                std::fprintf(stderr, "no keys found\n");
+            }
+        });
+    }
+
+    // Churn: register and remove keys outside the looked-up set
+    std::thread writer([&] {
+        uint64_t n = ids.size();
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::string id = make_id(n++);
+            table.insert(id);
+            table.erase(id);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    writer.join();
+    return total / seconds;
+}
+
+int main(int argc, char **argv) {
+    size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> ids;
+    LockedMap locked;
+    EpochTable lock_free;
+    for (size_t i = 0; i < keys; i++) {
+        ids.push_back(make_id(i));
+        locked.insert(ids.back());
+        lock_free.insert(ids.back());
+    }
+
+    std::printf("%zu keys, %.1f s per run\n", keys, seconds);
+    std::printf("%8s %18s %18s %8s\n", "threads", "shared_mutex/s", "concurrent/s", "speedup");
+    for (unsigned readers = 1; readers <= max_threads; readers *= 2) {
+        double a = run(locked, ids, readers, seconds);
+        double b = run(lock_free, ids, readers, seconds);
+        std::printf("%8u %18.0f %18.0f %7.2fx\n", readers, a, b, b / a);
+        if (readers < max_threads && readers * 2 > max_threads) {
+            readers = max_threads / 2;
+        }
+    }
+    return 0;
+}
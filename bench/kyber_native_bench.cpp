@@ -0,0 +1,103 @@
+// Timing of the native Kyber engine: the Keccak permutation one and four states at
+// a time, the polynomial kernels with the scalar and AVX2 implementations, and
+// keygen/encrypt/decrypt for each parameter set.
+//
+// Usage: kyber_native_bench [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "native/fips202x4.h"
+#include "native/kyber.h"
+
+namespace {
+
+template <typename F>
+double time_us(int iterations, F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        f();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void bench_keccak(int iterations) {
+    uint64_t state[25] = {};
+    alignas(32) uint64_t states[25][4] = {};
+    double x1 = time_us(iterations, [&] { fips202::keccak_f1600(state); });
+    double x4 = time_us(iterations, [&] { fips202::keccak_f1600_x4(states); });
+    std::printf("keccak   x1 %8.3f us   x4 %8.3f us (%s)\n", x1, x4,
+                fips202::x4_avx2_enabled() ? "avx2" : "scalar");
+}
+
+void bench_kernels(const char *label, int iterations) {
+    kyber::Poly a, b, r;
+    for (int i = 0; i < kyber::n; i++) {
+        a.coeffs[i] = int16_t((i * 7919) % kyber::q);
+        b.coeffs[i] = int16_t((i * 104729) % kyber::q);
+    }
+    double ntt = time_us(iterations, [&] { kyber::Poly t = a; kyber::poly_ntt(t); });
+    double invntt = time_us(iterations, [&] { kyber::Poly t = a; kyber::poly_invntt(t, kyber::inv128); });
+    double basemul = time_us(iterations, [&] { kyber::poly_basemul_montgomery(r, a, b); });
+    std::printf("%-8s ntt %8.3f us   invntt %8.3f us   basemul %8.3f us\n", label, ntt, invntt, basemul);
+}
+
+void bench_scheme(const kyber::Params &params, int iterations) {
+    std::vector<uint8_t> pk(params.public_key_bytes()), sk(params.secret_key_bytes()), ct(params.ciphertext_bytes());
+    uint8_t seed[32] = {1}, msg[32] = {2}, coins[32] = {3}, out[32];
+    double keygen = time_us(iterations, [&] { kyber::keygen(params, pk.data(), sk.data(), seed); seed[0]++; });
+    double encrypt = time_us(iterations, [&] { kyber::encrypt(params, ct.data(), pk.data(), msg, coins); coins[0]++; });
+    double decrypt = time_us(iterations, [&] { kyber::decrypt(params, out, ct.data(), sk.data()); });
+    std::printf("%-10s keygen %8.2f us   encrypt %8.2f us   decrypt %8.2f us\n", params.name, keygen, encrypt, decrypt);
+}
+
+// ML-KEM encapsulation one at a time and through encaps_batch on the same key. The
+// public key comes from the Kyber keygen: both use the same t || rho layout.
+void bench_mlkem(const kyber::Params &kyber_params, const char *name, int iterations) {
+    const kyber::Params &params = *kyber::mlkem::params_by_name(name);
+    std::vector<uint8_t> pk(params.public_key_bytes()), sk(params.secret_key_bytes());
+    uint8_t seed[32] = {4};
+    kyber::keygen(kyber_params, pk.data(), sk.data(), seed);
+    kyber::mlkem::EncapsulationKey key;
+    kyber::mlkem::load_encapsulation_key(key, params, pk.data(), pk.size());
+
+    constexpr int batch = 64;
+    std::vector<uint8_t> ct(batch * params.ciphertext_bytes()), ss(32 * batch), m(32 * batch, 5);
+    std::vector<const kyber::mlkem::EncapsulationKey *> keys(batch, &key);
+    double single = time_us(iterations, [&] { kyber::mlkem::encaps(key, ct.data(), ss.data(), m.data()); m[0]++; });
+    double batched = time_us(iterations / batch + 1, [&] {
+        kyber::mlkem::encaps_batch(keys.data(), batch, ct.data(), ss.data(), m.data());
+        m[0]++;
+    }) / batch;
+    std::printf("%-11s encaps %8.2f us   batched %8.2f us\n", name, single, batched);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    bench_keccak(iterations * 10);
+
+    bool has_avx2 = kyber::avx2_enabled();
+    if (has_avx2) {
+        bench_kernels("avx2", iterations * 10);
+        bench_scheme(kyber::kyber512, iterations);
+        bench_scheme(kyber::kyber768, iterations);
+        bench_scheme(kyber::kyber1024, iterations);
+        bench_mlkem(kyber::kyber512, "ML-KEM-512", iterations);
+        bench_mlkem(kyber::kyber768, "ML-KEM-768", iterations);
+        bench_mlkem(kyber::kyber1024, "ML-KEM-1024", iterations);
+        kyber::disable_avx2();
+    }
+    bench_kernels("scalar", iterations * 10);
+    bench_scheme(kyber::kyber512, iterations);
+    bench_scheme(kyber::kyber768, iterations);
+    bench_scheme(kyber::kyber1024, iterations);
+    bench_mlkem(kyber::kyber512, "ML-KEM-512", iterations);
+    bench_mlkem(kyber::kyber768, "ML-KEM-768", iterations);
+    bench_mlkem(kyber::kyber1024, "ML-KEM-1024", iterations);
+    return 0;
+}
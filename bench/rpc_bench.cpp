@@ -0,0 +1,188 @@
+// Load for the binary RPC listener (RPC_PORT): C connections, each keeping W requests
+// in flight for D seconds. Reports operations per second and how many responses came
+// back out of request order. The key pair is generated here and sent inline.
+//
+// Usage: rpc_bench [-c connections] [-w window] [-d seconds] [-P port] [-m message_bytes]
+//                  [-a ML-DSA-44|ML-DSA-65|ML-DSA-87] [sign|verify]
+// Defaults: 4 connections, window 32, 10 seconds, port 5002, 32-byte messages, ML-DSA-44, verify
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <oqs/oqs.h>
+#include "rpc.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Totals {
+    std::atomic<uint64_t> responses{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> out_of_order{0};
+};
+
+int open_connection(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        std::perror("connect");
+        std::exit(1);
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+void send_all(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            std::perror("send");
+            std::exit(1);
+        }
+        sent += size_t(n);
+    }
+}
+
+// One connection: window requests are sent up front and each response is answered
+// with the next request, until the deadline
+void run_connection(uint16_t port, int window, Clock::time_point deadline, rpc::Request request, Totals &totals) {
+    int fd = open_connection(port);
+    std::string out;
+    for (int i = 0; i < window; i++) {
+        request.id++;
+        rpc::encode_request(request, out);
+    }
+    send_all(fd, out);
+
+    uint32_t expected_id = 1;
+    std::string in;
+    char buffer[65536];
+    while (Clock::now() < deadline) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            std::fprintf(stderr, "connection closed by the server\n");
+            break;
+        }
+        in.append(buffer, size_t(n));
+
+        out.clear();
+        size_t pos = 0;
+        size_t length;
+        while ((length = rpc::response_frame_length(std::string_view(in).substr(pos))) != 0 && length <= in.size() - pos) {
+            rpc::Op op;
+            uint32_t id;
+            rpc::Response response;
+            rpc::decode_response(std::string_view(in).substr(pos, length), op, id, response);
+            pos += length;
+
+            totals.responses++;
+            totals.errors += response.status != rpc::Status::Ok;
+            totals.out_of_order += id != expected_id;
+            expected_id = id + 1;
+
+            request.id++;
+            rpc::encode_request(request, out);
+        }
+        in.erase(0, pos);
+        send_all(fd, out);
+    }
+    close(fd);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int connections = 4;
+    int window = 32;
+    double seconds = 10;
+    uint16_t port = 5002;
+    size_t message_bytes = 32;
+    std::string algorithm = "ML-DSA-44";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:w:d:P:m:a:")) != -1) {
+        switch (opt) {
+        case 'c': connections = std::atoi(optarg); break;
+        case 'w': window = std::atoi(optarg); break;
+        case 'd': seconds = std::atof(optarg); break;
+        case 'P': port = uint16_t(std::atoi(optarg)); break;
+        case 'm': message_bytes = std::strtoul(optarg, nullptr, 10); break;
+        case 'a': algorithm = optarg; break;
+        default:
+            std::fprintf(stderr, "usage: %s [-c connections] [-w window] [-d seconds] [-P port] [-m message_bytes] [-a algorithm] [sign|verify]\n", argv[0]);
+            return 1;
+        }
+    }
+    bool sign = optind < argc && std::strcmp(argv[optind], "sign") == 0;
+
+    rpc::Request request;
+    request.op = sign ? rpc::Op::Sign : rpc::Op::Verify;
+    request.algorithm = algorithm == "ML-DSA-65" ? rpc::Algorithm::MlDsa65
+                      : algorithm == "ML-DSA-87" ? rpc::Algorithm::MlDsa87 : rpc::Algorithm::MlDsa44;
+    request.message.assign(message_bytes, 'm');
+
+    OQS_SIG *sig = OQS_SIG_new(rpc::algorithm_name(request.algorithm));
+    if (sig == nullptr) {
+        std::fprintf(stderr, "%s is not enabled in liboqs\n", algorithm.c_str());
+        return 1;
+    }
+    std::string public_key(sig->length_public_key, '\0');
+    std::string secret_key(sig->length_secret_key, '\0');
+    std::string signature(sig->length_signature, '\0');
+    size_t signature_len = signature.size();
+    OQS_SIG_keypair(sig, reinterpret_cast<uint8_t *>(&public_key[0]), reinterpret_cast<uint8_t *>(&secret_key[0]));
+    OQS_SIG_sign(sig, reinterpret_cast<uint8_t *>(&signature[0]), &signature_len,
+                 reinterpret_cast<const uint8_t *>(request.message.data()), request.message.size(),
+                 reinterpret_cast<const uint8_t *>(secret_key.data()));
+    signature.resize(signature_len);
+    OQS_SIG_free(sig);
+    if (sign) {
+        request.key = secret_key;
+    } else {
+        request.key = public_key;
+        request.signature = signature;
+    }
+
+    Totals totals;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < connections; i++) {
+        threads.emplace_back([&] {
+            rpc::Request copy;
+            copy.op = request.op;
+            copy.algorithm = request.algorithm;
+            copy.key = request.key;
+            copy.message = request.message;
+            copy.signature = request.signature;
+            run_connection(port, window, deadline, std::move(copy), totals);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%s %s, %d connections, window %d, %zu-byte messages, %.1f s\n", sign ? "sign" : "verify",
+                algorithm.c_str(), connections, window, message_bytes, elapsed);
+    std::printf("responses %llu (%llu errors, %llu out of order)   %.0f ops/s\n",
+                (unsigned long long)totals.responses, (unsigned long long)totals.errors,
+                (unsigned long long)totals.out_of_order, double(totals.responses) / elapsed);
+    return 0;
+}
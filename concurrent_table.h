@@ -0,0 +1,235 @@
+#ifndef CONCURRENT_TABLE_H
+#define CONCURRENT_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include "epoch.h"
+
+// Hash table keyed by string for read-mostly data such as the key registry.
+//
+// The table is split into shards, each an open-addressing array of buckets that
+// readers probe without taking any lock. Writers serialize per shard, publish
+// with atomic stores and retire replaced nodes and arrays through epoch-based
+// reclamation, so every pointer returned by find() stays valid while the
+// caller holds an epoch::Guard.
+template <typename T>
+class ConcurrentTable {
+public:
+    explicit ConcurrentTable(size_t shard_bits = 6)
+        : shard_bits_(shard_bits), shards_(new Shard[size_t(1) << shard_bits]) {
+        for (size_t i = 0; i < shard_count(); i++) {
+            shards_[i].table.store(Table::create(initial_capacity), std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentTable() {
+        for (size_t i = 0; i < shard_count(); i++) {
+            Table *table = shards_[i].table.load(std::memory_order_relaxed);
+            for (size_t b = 0; b <= table->mask; b++) {
+                Node *node = table->buckets[b].node.load(std::memory_order_relaxed);
+                if (node && node != tombstone()) {
+                    delete node;
+                }
+            }
+            Table::destroy(table);
+        }
+    }
+
+    ConcurrentTable(const ConcurrentTable &) = delete;
+    ConcurrentTable &operator=(const ConcurrentTable &) = delete;
+
+    // Lock-free lookup. The caller must hold an epoch::Guard while using the result.
+    const T *find(const std::string &key) const {
+        uint64_t hash = hash_key(key);
+        const Table *table = shard_for(hash).table.load(std::memory_order_acquire);
+        for (size_t i = hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, probes++) {
+            const Bucket &bucket = table->buckets[i];
+            uint64_t bucket_hash = bucket.hash.load(std::memory_order_acquire);
+            if (bucket_hash == 0) {
+                return nullptr;
+            }
+            if (bucket_hash == hash) {
+                const Node *node = bucket.node.load(std::memory_order_acquire);
+                if (node && node != tombstone() && node->key == key) {
+                    return node->value.get();
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(const std::string &key) const {
+        epoch::Guard guard;
+        return find(key) != nullptr;
+    }
+
+    // Insert the value unless the key is present. Returns the stored value, which is
+    // the existing one if the key was already there. The caller must hold an
+    // epoch::Guard while using the result.
+    const T *insert(const std::string &key, std::unique_ptr<T> value) {
+        uint64_t hash = hash_key(key);
+        Shard &shard = shard_for(hash);
+        std::lock_guard<std::mutex> lock(shard.write_mutex);
+
+        Table *table = shard.table.load(std::memory_order_relaxed);
+        if (2 * (shard.used + 1) > table->mask + 1) {
+            table = grow(shard, table);
+        }
+
+        Bucket *free_bucket = nullptr;
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            Bucket &bucket = table->buckets[i];
+            Node *node = bucket.node.load(std::memory_order_relaxed);
+            if (!node) {
+                if (!free_bucket) {
+                    free_bucket = &bucket;
+                    shard.used++;
+                }
+                break;
+            }
+            if (node == tombstone()) {
+                if (!free_bucket) free_bucket = &bucket;
+            } else if (bucket.hash.load(std::memory_order_relaxed) == hash && node->key == key) {
+                return node->value.get();
+            }
+        }
+
+        Node *node = new Node{hash, key, std::move(value)};
+        // Node before hash: a reader that sees the new hash also sees the node
+        free_bucket->node.store(node, std::memory_order_seq_cst);
+        free_bucket->hash.store(hash, std::memory_order_release);
+        shard.live.fetch_add(1, std::memory_order_relaxed);
+        return node->value.get();
+    }
+
+    // Remove the key. The value is destroyed once no reader can still see it.
+    bool erase(const std::string &key) {
+        uint64_t hash = hash_key(key);
+        Shard &shard = shard_for(hash);
+        std::lock_guard<std::mutex> lock(shard.write_mutex);
+
+        Table *table = shard.table.load(std::memory_order_relaxed);
+        for (size_t i = hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, probes++) {
+            Bucket &bucket = table->buckets[i];
+            Node *node = bucket.node.load(std::memory_order_relaxed);
+            if (!node) {
+                return false;
+            }
+            if (node != tombstone() && bucket.hash.load(std::memory_order_relaxed) == hash && node->key == key) {
+                bucket.node.store(tombstone(), std::memory_order_seq_cst);
+                shard.live.fetch_sub(1, std::memory_order_relaxed);
+                epoch::retire(node);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count(); i++) {
+            total += shards_[i].live.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    static constexpr size_t initial_capacity = 16;
+
+    struct Node {
+        uint64_t hash;
+        std::string key;
+        std::unique_ptr<T> value;
+    };
+
+    // Four buckets per cache line; the hash lets readers skip nodes without touching them
+    struct Bucket {
+        std::atomic<uint64_t> hash{0};   // 0 only for buckets that never held a node
+        std::atomic<Node *> node{nullptr};
+    };
+
+    struct Table {
+        size_t mask;
+        alignas(64) Bucket buckets[1];
+
+        static Table *create(size_t capacity) {
+            size_t bytes = offsetof(Table, buckets) + capacity * sizeof(Bucket);
+            void *memory = ::operator new(bytes, std::align_val_t(64));
+            Table *table = static_cast<Table *>(memory);
+            table->mask = capacity - 1;
+            for (size_t i = 0; i < capacity; i++) {
+                new (&table->buckets[i]) Bucket();
+            }
+            return table;
+        }
+
+        static void destroy(Table *table) {
+            ::operator delete(table, std::align_val_t(64));
+        }
+    };
+
+    // Writer state sits on its own cache line, away from the table pointer readers load
+    struct alignas(64) Shard {
+        std::atomic<Table *> table{nullptr};
+        alignas(64) std::mutex write_mutex;
+        size_t used = 0;                 // Buckets holding a node or a tombstone
+        std::atomic<size_t> live{0};
+    };
+
+    static Node *tombstone() {
+        static Node marker{0, std::string(), nullptr};
+        return &marker;
+    }
+
+    static uint64_t hash_key(const std::string &key) {
+        // Never 0, which marks a bucket that was never used
+        return static_cast<uint64_t>(std::hash<std::string>()(key)) | 1;
+    }
+
+    size_t shard_count() const {
+        return size_t(1) << shard_bits_;
+    }
+
+    Shard &shard_for(uint64_t hash) const {
+        return shards_[(hash >> 40) & (shard_count() - 1)];
+    }
+
+    // Copy the live nodes into a larger array, publish it and retire the old one
+    Table *grow(Shard &shard, Table *old_table) {
+        size_t live = shard.live.load(std::memory_order_relaxed);
+        size_t capacity = initial_capacity;
+        while (capacity < 4 * (live + 1)) {
+            capacity *= 2;
+        }
+
+        Table *table = Table::create(capacity);
+        for (size_t b = 0; b <= old_table->mask; b++) {
+            Node *node = old_table->buckets[b].node.load(std::memory_order_relaxed);
+            if (!node || node == tombstone()) {
+                continue;
+            }
+            for (size_t i = node->hash & table->mask;; i = (i + 1) & table->mask) {
+                if (!table->buckets[i].node.load(std::memory_order_relaxed)) {
+                    table->buckets[i].node.store(node, std::memory_order_relaxed);
+                    table->buckets[i].hash.store(node->hash, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+
+        shard.table.store(table, std::memory_order_seq_cst);
+        shard.used = live;
+        epoch::retire(old_table, [](void *p) { Table::destroy(static_cast<Table *>(p)); });
+        return table;
+    }
+
+    size_t shard_bits_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+#endif // CONCURRENT_TABLE_H
@@ -0,0 +1,157 @@
+#include "drbg.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <oqs/oqs.h>
+#include <pthread.h>
+#include <sys/random.h>
+
+namespace drbg {
+
+namespace {
+
+// Bumped in the child after every fork(); threads compare it with the value they
+// were seeded under
+std::atomic<uint64_t> fork_generation{0};
+
+void on_fork_child() {
+    fork_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+// getrandom() until len bytes are read. There is no way to report a failure through
+// OQS_randombytes, and continuing without entropy is not an option.
+void system_random(uint8_t *out, size_t len) {
+    while (len > 0) {
+        ssize_t n = getrandom(out, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::perror("getrandom");
+            std::abort();
+        }
+        out += n;
+        len -= size_t(n);
+    }
+}
+
+inline uint32_t rotl(uint32_t x, int s) {
+    return (x << s) | (x >> (32 - s));
+}
+
+inline void quarter_round(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d) {
+    a += b; d ^= a; d = rotl(d, 16);
+    c += d; b ^= c; b = rotl(b, 12);
+    a += b; d ^= a; d = rotl(d, 8);
+    c += d; b ^= c; b = rotl(b, 7);
+}
+
+inline uint32_t load32(const uint8_t *p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+inline void store32(uint8_t *p, uint32_t x) {
+    p[0] = uint8_t(x);
+    p[1] = uint8_t(x >> 8);
+    p[2] = uint8_t(x >> 16);
+    p[3] = uint8_t(x >> 24);
+}
+
+struct State {
+    uint32_t key[8];
+    uint8_t buffer[buffer_bytes];
+    size_t pos = buffer_bytes;  // next unused byte of buffer
+    uint64_t served = 0;        // bytes since the last seed
+    uint64_t generation = 0;
+    bool seeded = false;
+
+    ~State() { OQS_MEM_cleanse(this, sizeof(*this)); }
+
+    void reseed() {
+        uint8_t seed[32];
+        system_random(seed, sizeof(seed));
+        for (int i = 0; i < 8; i++) {
+            key[i] = load32(seed + 4 * i);
+        }
+        OQS_MEM_cleanse(seed, sizeof(seed));
+        OQS_MEM_cleanse(buffer, sizeof(buffer));
+        pos = buffer_bytes;
+        served = 0;
+        generation = fork_generation.load(std::memory_order_relaxed);
+        seeded = true;
+    }
+
+    // A fresh key per refill lets the counter start at 0 with a zero nonce
+    void refill() {
+        static const uint32_t nonce[3] = {0, 0, 0};
+        for (size_t block = 0; block < buffer_bytes / 64; block++) {
+            chacha20_block(buffer + 64 * block, key, uint32_t(block), nonce);
+        }
+        for (int i = 0; i < 8; i++) {
+            key[i] = load32(buffer + 4 * i);
+        }
+        std::memset(buffer, 0, sizeof(key));
+        pos = sizeof(key);
+    }
+};
+
+thread_local State state;
+
+} // namespace
+
+void chacha20_block(uint8_t out[64], const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]) {
+    const uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        counter, nonce[0], nonce[1], nonce[2],
+    };
+    uint32_t x[16];
+    std::memcpy(x, input, sizeof(x));
+    for (int round = 0; round < 10; round++) {
+        quarter_round(x[0], x[4], x[8], x[12]);
+        quarter_round(x[1], x[5], x[9], x[13]);
+        quarter_round(x[2], x[6], x[10], x[14]);
+        quarter_round(x[3], x[7], x[11], x[15]);
+        quarter_round(x[0], x[5], x[10], x[15]);
+        quarter_round(x[1], x[6], x[11], x[12]);
+        quarter_round(x[2], x[7], x[8], x[13]);
+        quarter_round(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        store32(out + 4 * i, x[i] + input[i]);
+    }
+}
+
+void randombytes(uint8_t *out, size_t len) {
+    State &s = state;
+    if (!s.seeded || s.served >= reseed_interval ||
+        s.generation != fork_generation.load(std::memory_order_relaxed)) {
+        s.reseed();
+    }
+    s.served += len;
+
+    while (len > 0) {
+        if (s.pos == buffer_bytes) {
+            s.refill();
+        }
+        size_t n = std::min(len, buffer_bytes - s.pos);
+        std::memcpy(out, s.buffer + s.pos, n);
+        std::memset(s.buffer + s.pos, 0, n);
+        s.pos += n;
+        out += n;
+        len -= n;
+    }
+}
+
+void install() {
+    static std::once_flag once;
+    std::call_once(once, [] { pthread_atfork(nullptr, nullptr, on_fork_child); });
+    OQS_randombytes_custom_algorithm(randombytes);
+}
+
+} // namespace drbg
@@ -0,0 +1,32 @@
+#ifndef DRBG_H
+#define DRBG_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Per-thread ChaCha20 DRBG behind liboqs' OQS_randombytes.
+//
+// Each thread keys its own ChaCha20 from getrandom() and serves requests from a
+// buffer of keystream, so a keygen or encapsulation costs a memcpy instead of a
+// system call. Every refill replaces the key with the first 32 bytes of the new
+// keystream and bytes are wiped from the buffer as they are handed out, so the state
+// of a thread never reveals output it has already produced. A thread reseeds from
+// getrandom() after reseed_interval bytes, and the child of a fork() reseeds before
+// its first request so it never repeats the parent's stream.
+namespace drbg {
+
+constexpr size_t buffer_bytes = 1024;           // 16 ChaCha20 blocks per refill
+constexpr uint64_t reseed_interval = 1u << 20;  // bytes served per getrandom() seed
+
+// Fill out with len random bytes; usable as OQS_randombytes_custom_algorithm
+void randombytes(uint8_t *out, size_t len);
+
+// Route OQS_randombytes through randombytes() for the whole process
+void install();
+
+// The ChaCha20 block function of RFC 8439
+void chacha20_block(uint8_t out[64], const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]);
+
+} // namespace drbg
+
+#endif // DRBG_H
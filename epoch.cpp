@@ -0,0 +1,146 @@
+#include "epoch.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace epoch {
+namespace {
+
+constexpr size_t max_threads = 1024;
+
+// One announcement slot per thread, each on its own cache line so that
+// readers entering and leaving never write to a line another core reads.
+struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch{0};  // 0 while the thread is outside any guard
+    std::atomic<bool> in_use{false};
+};
+
+struct Retired {
+    void *ptr;
+    void (*deleter)(void *);
+    uint64_t epoch;
+};
+
+Slot slots[max_threads];
+alignas(64) std::atomic<uint64_t> global_epoch{1};
+std::mutex retired_mutex;
+std::vector<Retired> retired;
+
+struct ThreadState {
+    Slot *slot = nullptr;
+    unsigned depth = 0;
+
+    Slot &claim() {
+        if (!slot) {
+            for (Slot &candidate : slots) {
+                bool expected = false;
+                if (!candidate.in_use.load(std::memory_order_relaxed) &&
+                    candidate.in_use.compare_exchange_strong(expected, true)) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (!slot) {
+                throw std::runtime_error("epoch: too many threads");
+            }
+        }
+        return *slot;
+    }
+
+    ~ThreadState() {
+        if (slot) {
+            slot->epoch.store(0, std::memory_order_release);
+            slot->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadState thread_state;
+
+void enter() {
+    if (thread_state.depth++ == 0) {
+        Slot &slot = thread_state.claim();
+        slot.epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // Order the announcement before any load from the protected structure
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void leave() {
+    if (--thread_state.depth == 0) {
+        thread_state.slot->epoch.store(0, std::memory_order_release);
+    }
+}
+
+// Caller holds retired_mutex
+void reclaim_locked() {
+    uint64_t oldest = UINT64_MAX;
+    for (const Slot &slot : slots) {
+        uint64_t announced = slot.epoch.load(std::memory_order_seq_cst);
+        if (announced != 0 && announced < oldest) {
+            oldest = announced;
+        }
+    }
+
+    size_t kept = 0;
+    for (const Retired &item : retired) {
+        if (item.epoch < oldest) {
+            item.deleter(item.ptr);
+        } else {
+            retired[kept++] = item;
+        }
+    }
+    retired.resize(kept);
+}
+
+} // namespace
+
+Guard::Guard() : active_(true) {
+    enter();
+}
+
+Guard::~Guard() {
+    release();
+}
+
+Guard::Guard(Guard &&other) noexcept : active_(other.active_) {
+    other.active_ = false;
+}
+
+Guard &Guard::operator=(Guard &&other) noexcept {
+    if (this != &other) {
+        release();
+        active_ = other.active_;
+        other.active_ = false;
+    }
+    return *this;
+}
+
+Guard Guard::empty() {
+    return Guard(false);
+}
+
+void Guard::release() {
+    if (active_) {
+        active_ = false;
+        leave();
+    }
+}
+
+void retire(void *ptr, void (*deleter)(void *)) {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    // The object is already unlinked. Readers announcing a later epoch started
+    // after the unlink and cannot reach it.
+    uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst);
+    retired.push_back({ptr, deleter, epoch});
+    reclaim_locked();
+}
+
+void reclaim() {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    global_epoch.fetch_add(1, std::memory_order_seq_cst);
+    reclaim_locked();
+}
+
+} // namespace epoch
@@ -0,0 +1,49 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+
+// Epoch-based reclamation for data structures whose readers take no locks.
+//
+// Readers hold a Guard while they use pointers loaded from the structure.
+// Writers unlink an object and hand it to retire(); it is freed once every
+// thread that was inside a Guard at that point has left it.
+namespace epoch {
+
+class Guard {
+public:
+    Guard();
+    ~Guard();
+
+    Guard(Guard &&other) noexcept;
+    Guard &operator=(Guard &&other) noexcept;
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+    // Guard that is not inside the epoch, for use as a placeholder
+    static Guard empty();
+
+    // Leave the epoch early. Pointers obtained under this guard must not be used afterwards.
+    void release();
+
+private:
+    explicit Guard(bool active) : active_(active) {}
+
+    bool active_;
+};
+
+// Free ptr with deleter once no reader can still hold it
+void retire(void *ptr, void (*deleter)(void *));
+
+template <typename T>
+void retire(T *ptr) {
+    retire(static_cast<void *>(ptr), [](void *p) { delete static_cast<T *>(p); });
+}
+
+// Free every retired object that is no longer reachable by a reader
+void reclaim();
+
+} // namespace epoch
+
+#endif // EPOCH_H
@@ -0,0 +1,235 @@
+#include "hybrid_kem.h"
+
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <oqs/oqs.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+
+namespace hybrid {
+namespace {
+
+constexpr size_t x25519_length = 32;
+
+// Below this many items the halves run one after the other on the calling thread
+constexpr size_t parallel_batch = 16;
+
+// Label mixed into the KDF so the secret cannot be confused with one from another construction
+constexpr char kdf_label[] = "Kyber-API hybrid X25519MLKEM768";
+
+using PkeyPtr = std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)>;
+using PkeyCtxPtr = std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)>;
+using KemPtr = std::unique_ptr<OQS_KEM, decltype(&OQS_KEM_free)>;
+
+KemPtr new_mlkem() {
+    KemPtr kem(OQS_KEM_new(OQS_KEM_alg_ml_kem_768), OQS_KEM_free);
+    if (!kem) {
+        throw std::runtime_error("Error initializing the ML-KEM-768 algorithm");
+    }
+    return kem;
+}
+
+const KemPtr &mlkem() {
+    static const KemPtr kem = new_mlkem();
+    return kem;
+}
+
+// Generate an X25519 key pair into the two 32-byte buffers
+void x25519_keypair(uint8_t *public_key, uint8_t *secret_key) {
+    PkeyCtxPtr ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_X25519, nullptr), EVP_PKEY_CTX_free);
+    EVP_PKEY *raw = nullptr;
+    if (!ctx || EVP_PKEY_keygen_init(ctx.get()) <= 0 || EVP_PKEY_keygen(ctx.get(), &raw) <= 0) {
+        throw std::runtime_error("X25519 key generation failed");
+    }
+    PkeyPtr pkey(raw, EVP_PKEY_free);
+
+    size_t public_len = x25519_length, secret_len = x25519_length;
+    if (EVP_PKEY_get_raw_public_key(pkey.get(), public_key, &public_len) <= 0 ||
+        EVP_PKEY_get_raw_private_key(pkey.get(), secret_key, &secret_len) <= 0) {
+        throw std::runtime_error("X25519 key export failed");
+    }
+}
+
+// Compute the X25519 shared secret, optionally returning our own public key as well
+void x25519_derive(const uint8_t *secret_key, const uint8_t *peer_public_key, uint8_t *shared_secret, uint8_t *own_public_key) {
+    PkeyPtr own(EVP_PKEY_new_raw_private_key(EVP_PKEY_X25519, nullptr, secret_key, x25519_length), EVP_PKEY_free);
+    PkeyPtr peer(EVP_PKEY_new_raw_public_key(EVP_PKEY_X25519, nullptr, peer_public_key, x25519_length), EVP_PKEY_free);
+    if (!own || !peer) {
+        throw std::runtime_error("X25519 key import failed");
+    }
+    if (own_public_key) {
+        size_t public_len = x25519_length;
+        if (EVP_PKEY_get_raw_public_key(own.get(), own_public_key, &public_len) <= 0) {
+            throw std::runtime_error("X25519 key export failed");
+        }
+    }
+
+    PkeyCtxPtr ctx(EVP_PKEY_CTX_new(own.get(), nullptr), EVP_PKEY_CTX_free);
+    size_t secret_len = x25519_length;
+    if (!ctx || EVP_PKEY_derive_init(ctx.get()) <= 0 || EVP_PKEY_derive_set_peer(ctx.get(), peer.get()) <= 0 ||
+        EVP_PKEY_derive(ctx.get(), shared_secret, &secret_len) <= 0) {
+        // OpenSSL rejects low-order peer points, which would give an all-zero secret
+        throw std::invalid_argument("Invalid X25519 public key");
+    }
+}
+
+// HKDF-SHA256(ikm = ss_mlkem || ss_x25519, info = label || ct_x25519 || pk_x25519)
+void combine(const uint8_t *mlkem_secret, size_t mlkem_secret_len, const uint8_t *x25519_secret,
+             const uint8_t *x25519_ciphertext, const uint8_t *x25519_public_key, uint8_t *out) {
+    std::vector<uint8_t> ikm(mlkem_secret, mlkem_secret + mlkem_secret_len);
+    ikm.insert(ikm.end(), x25519_secret, x25519_secret + x25519_length);
+
+    std::vector<uint8_t> info(kdf_label, kdf_label + sizeof(kdf_label) - 1);
+    info.insert(info.end(), x25519_ciphertext, x25519_ciphertext + x25519_length);
+    info.insert(info.end(), x25519_public_key, x25519_public_key + x25519_length);
+
+    PkeyCtxPtr ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr), EVP_PKEY_CTX_free);
+    size_t out_len = shared_secret_length;
+    bool ok = ctx && EVP_PKEY_derive_init(ctx.get()) > 0 &&
+              EVP_PKEY_CTX_set_hkdf_md(ctx.get(), EVP_sha256()) > 0 &&
+              EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), ikm.data(), ikm.size()) > 0 &&
+              EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), info.data(), info.size()) > 0 &&
+              EVP_PKEY_derive(ctx.get(), out, &out_len) > 0;
+    OQS_MEM_cleanse(ikm.data(), ikm.size());
+    if (!ok) {
+        throw std::runtime_error("Hybrid key derivation failed");
+    }
+}
+
+// Run the ML-KEM and X25519 halves of a batch, concurrently when it is large enough
+template <typename MlKemHalf, typename X25519Half>
+void run_halves(size_t count, MlKemHalf mlkem_half, X25519Half x25519_half) {
+    if (count < parallel_batch) {
+        mlkem_half();
+        x25519_half();
+        return;
+    }
+    auto x25519_done = std::async(std::launch::async, x25519_half);
+    mlkem_half();
+    x25519_done.get();
+}
+
+void check_length(const std::vector<uint8_t> &value, size_t expected, const char *what, size_t index) {
+    if (value.size() != expected) {
+        throw std::invalid_argument(std::string("Invalid ") + what + " length at index " + std::to_string(index));
+    }
+}
+
+} // namespace
+
+size_t public_key_length() {
+    return mlkem()->length_public_key + x25519_length;
+}
+
+size_t secret_key_length() {
+    return mlkem()->length_secret_key + x25519_length;
+}
+
+size_t ciphertext_length() {
+    return mlkem()->length_ciphertext + x25519_length;
+}
+
+std::vector<KeyPair> generate_keys(size_t count) {
+    const OQS_KEM *kem = mlkem().get();
+    std::vector<KeyPair> keys(count);
+    for (KeyPair &key : keys) {
+        key.public_key.resize(public_key_length());
+        key.secret_key.resize(secret_key_length());
+    }
+
+    run_halves(count, [&] {
+        for (KeyPair &key : keys) {
+            if (OQS_KEM_keypair(kem, key.public_key.data(), key.secret_key.data()) != OQS_SUCCESS) {
+                throw std::runtime_error("ML-KEM-768 key generation failed");
+            }
+        }
+    }, [&] {
+        for (KeyPair &key : keys) {
+            x25519_keypair(key.public_key.data() + kem->length_public_key, key.secret_key.data() + kem->length_secret_key);
+        }
+    });
+    return keys;
+}
+
+std::vector<Encapsulation> encaps(const std::vector<std::vector<uint8_t>> &public_keys) {
+    const OQS_KEM *kem = mlkem().get();
+    size_t count = public_keys.size();
+    for (size_t i = 0; i < count; i++) {
+        check_length(public_keys[i], public_key_length(), "public key", i);
+    }
+
+    std::vector<Encapsulation> results(count);
+    std::vector<uint8_t> mlkem_secrets(count * kem->length_shared_secret);
+    std::vector<uint8_t> x25519_secrets(count * x25519_length);
+    for (Encapsulation &result : results) {
+        result.ciphertext.resize(ciphertext_length());
+        result.shared_secret.resize(shared_secret_length);
+    }
+
+    run_halves(count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            if (OQS_KEM_encaps(kem, results[i].ciphertext.data(), &mlkem_secrets[i * kem->length_shared_secret],
+                               public_keys[i].data()) != OQS_SUCCESS) {
+                throw std::runtime_error("ML-KEM-768 encapsulation failed");
+            }
+        }
+    }, [&] {
+        // The X25519 ciphertext is a fresh ephemeral public key
+        uint8_t ephemeral_secret[x25519_length];
+        for (size_t i = 0; i < count; i++) {
+            x25519_keypair(results[i].ciphertext.data() + kem->length_ciphertext, ephemeral_secret);
+            x25519_derive(ephemeral_secret, public_keys[i].data() + kem->length_public_key, &x25519_secrets[i * x25519_length], nullptr);
+        }
+        OQS_MEM_cleanse(ephemeral_secret, sizeof(ephemeral_secret));
+    });
+
+    for (size_t i = 0; i < count; i++) {
+        combine(&mlkem_secrets[i * kem->length_shared_secret], kem->length_shared_secret, &x25519_secrets[i * x25519_length],
+                results[i].ciphertext.data() + kem->length_ciphertext, public_keys[i].data() + kem->length_public_key,
+                results[i].shared_secret.data());
+    }
+    OQS_MEM_cleanse(mlkem_secrets.data(), mlkem_secrets.size());
+    OQS_MEM_cleanse(x25519_secrets.data(), x25519_secrets.size());
+    return results;
+}
+
+std::vector<std::vector<uint8_t>> decaps(const std::vector<Ciphertext> &items) {
+    const OQS_KEM *kem = mlkem().get();
+    size_t count = items.size();
+    for (size_t i = 0; i < count; i++) {
+        check_length(items[i].secret_key, secret_key_length(), "secret key", i);
+        check_length(items[i].ciphertext, ciphertext_length(), "ciphertext", i);
+    }
+
+    std::vector<std::vector<uint8_t>> results(count, std::vector<uint8_t>(shared_secret_length));
+    std::vector<uint8_t> mlkem_secrets(count * kem->length_shared_secret);
+    std::vector<uint8_t> x25519_secrets(count * x25519_length);
+    std::vector<uint8_t> x25519_public_keys(count * x25519_length);
+
+    run_halves(count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            if (OQS_KEM_decaps(kem, &mlkem_secrets[i * kem->length_shared_secret], items[i].ciphertext.data(),
+                               items[i].secret_key.data()) != OQS_SUCCESS) {
+                throw std::runtime_error("ML-KEM-768 decapsulation failed");
+            }
+        }
+    }, [&] {
+        for (size_t i = 0; i < count; i++) {
+            x25519_derive(items[i].secret_key.data() + kem->length_secret_key, items[i].ciphertext.data() + kem->length_ciphertext,
+                          &x25519_secrets[i * x25519_length], &x25519_public_keys[i * x25519_length]);
+        }
+    });
+
+    for (size_t i = 0; i < count; i++) {
+        combine(&mlkem_secrets[i * kem->length_shared_secret], kem->length_shared_secret, &x25519_secrets[i * x25519_length],
+                items[i].ciphertext.data() + kem->length_ciphertext, &x25519_public_keys[i * x25519_length],
+                results[i].data());
+    }
+    OQS_MEM_cleanse(mlkem_secrets.data(), mlkem_secrets.size());
+    OQS_MEM_cleanse(x25519_secrets.data(), x25519_secrets.size());
+    return results;
+}
+
+} // namespace hybrid
@@ -0,0 +1,55 @@
+#ifndef HYBRID_KEM_H
+#define HYBRID_KEM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hybrid key exchange combining X25519 (OpenSSL) with ML-KEM-768 (liboqs), so that a
+// single request yields a secret that stays safe as long as either half is unbroken.
+//
+// Encodings follow the X25519MLKEM768 TLS group: the ML-KEM part comes first and
+// the X25519 part second in public keys, secret keys and ciphertexts. The combined
+// secret is HKDF-SHA256 over both shared secrets, bound to the X25519 ciphertext
+// and public key.
+//
+// The batch functions split the work into its ML-KEM and X25519 halves, which run
+// on separate threads once the batch is large enough to cover the thread start.
+// Invalid input throws std::invalid_argument and library failures std::runtime_error.
+namespace hybrid {
+
+constexpr const char *algorithm_name = "X25519MLKEM768";
+constexpr size_t shared_secret_length = 32;
+
+struct KeyPair {
+    std::vector<uint8_t> public_key;
+    std::vector<uint8_t> secret_key;
+};
+
+struct Encapsulation {
+    std::vector<uint8_t> ciphertext;
+    std::vector<uint8_t> shared_secret;
+};
+
+// Input for decapsulation: the recipient's hybrid secret key and the ciphertext
+struct Ciphertext {
+    std::vector<uint8_t> secret_key;
+    std::vector<uint8_t> ciphertext;
+};
+
+size_t public_key_length();
+size_t secret_key_length();
+size_t ciphertext_length();
+
+// Generate count hybrid key pairs
+std::vector<KeyPair> generate_keys(size_t count);
+
+// Encapsulate a fresh shared secret to each hybrid public key
+std::vector<Encapsulation> encaps(const std::vector<std::vector<uint8_t>> &public_keys);
+
+// Recover the shared secret of each ciphertext
+std::vector<std::vector<uint8_t>> decaps(const std::vector<Ciphertext> &items);
+
+} // namespace hybrid
+
+#endif // HYBRID_KEM_H
@@ -0,0 +1,183 @@
+#include "key_registry.h"
+
+#include <stdexcept>
+
+namespace {
+
+// Random 128-bit identifier encoded as lowercase hex
+std::string new_key_id() {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t raw[16];
+    OQS_randombytes(raw, sizeof(raw));
+    std::string id;
+    id.reserve(2 * sizeof(raw));
+    for (uint8_t byte : raw) {
+        id += hex[byte >> 4];
+        id += hex[byte & 0x0f];
+    }
+    return id;
+}
+
+// Create the entry with its liboqs context for the algorithm
+std::unique_ptr<KeyEntry> new_entry(KeyKind kind, const std::string &algorithm) {
+    auto entry = std::make_unique<KeyEntry>();
+    entry->kind = kind;
+    entry->algorithm = algorithm;
+    if (kind == KeyKind::Kem) {
+        entry->kem = OQS_KEM_new(algorithm.c_str());
+        if (!entry->kem) {
+            throw std::invalid_argument("Unsupported KEM algorithm: " + algorithm);
+        }
+    } else {
+        entry->sig = OQS_SIG_new(algorithm.c_str());
+        if (!entry->sig) {
+            throw std::invalid_argument("Unsupported signature algorithm: " + algorithm);
+        }
+    }
+    return entry;
+}
+
+// Decode an ML-KEM public key once for the native engine. A key that fails the
+// FIPS 203 checks is left to the per-request path, which reports it.
+void prepare_native_key(KeyEntry &entry) {
+    const kyber::Params *params = entry.kind == KeyKind::Kem ? kyber::mlkem::params_by_name(entry.algorithm) : nullptr;
+    if (!params || entry.public_key.empty()) {
+        return;
+    }
+    auto key = std::make_unique<kyber::mlkem::EncapsulationKey>();
+    if (kyber::mlkem::load_encapsulation_key(*key, *params, entry.public_key.data(), entry.public_key.size())) {
+        entry.mlkem_key = std::move(key);
+    }
+}
+
+} // namespace
+
+KeyEntry::~KeyEntry() {
+    if (!secret_key.empty()) {
+        OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+    }
+    if (kem) {
+        OQS_KEM_free(kem);
+    }
+    if (sig) {
+        OQS_SIG_free(sig);
+    }
+}
+
+const char *key_kind_name(KeyKind kind) {
+    return kind == KeyKind::Kem ? "kem" : "signature";
+}
+
+KeyRef KeyRegistry::generate(KeyKind kind, const std::string &algorithm) {
+    auto entry = new_entry(kind, algorithm);
+
+    OQS_STATUS status;
+    if (kind == KeyKind::Kem) {
+        entry->public_key.resize(entry->kem->length_public_key);
+        entry->secret_key.resize(entry->kem->length_secret_key);
+        status = OQS_KEM_keypair(entry->kem, entry->public_key.data(), entry->secret_key.data());
+    } else {
+        entry->public_key.resize(entry->sig->length_public_key);
+        entry->secret_key.resize(entry->sig->length_secret_key);
+        status = OQS_SIG_keypair(entry->sig, entry->public_key.data(), entry->secret_key.data());
+    }
+    if (status != OQS_SUCCESS) {
+        throw std::runtime_error("Failed to generate key pair");
+    }
+
+    return insert(std::move(entry));
+}
+
+KeyRef KeyRegistry::add(KeyKind kind, const std::string &algorithm,
+                        std::vector<uint8_t> public_key, std::vector<uint8_t> secret_key) {
+    auto entry = new_entry(kind, algorithm);
+
+    size_t public_key_len = kind == KeyKind::Kem ? entry->kem->length_public_key : entry->sig->length_public_key;
+    size_t secret_key_len = kind == KeyKind::Kem ? entry->kem->length_secret_key : entry->sig->length_secret_key;
+    if (public_key.empty() && secret_key.empty()) {
+        throw std::invalid_argument("A public or secret key is required");
+    }
+    if (!public_key.empty() && public_key.size() != public_key_len) {
+        throw std::invalid_argument("Invalid public key length for " + algorithm);
+    }
+    if (!secret_key.empty() && secret_key.size() != secret_key_len) {
+        OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+        throw std::invalid_argument("Invalid secret key length for " + algorithm);
+    }
+
+    entry->public_key = std::move(public_key);
+    entry->secret_key = std::move(secret_key);
+    return insert(std::move(entry));
+}
+
+KeyRef KeyRegistry::find(const std::string &id) const {
+    epoch::Guard guard;
+    if (const KeyEntry *entry = entries_.find(id)) {
+        return KeyRef(std::move(guard), entry);
+    }
+    guard.release();
+    return store_ ? load(id) : KeyRef();
+}
+
+bool KeyRegistry::erase(const std::string &id) {
+    // Store first, so that a concurrent load() cannot bring the key back
+    bool erased = store_ && store_->remove(id);
+    erased = entries_.erase(id) || erased;
+    return erased;
+}
+
+KeyRef KeyRegistry::load(const std::string &id) const {
+    KeyStore::Record record;
+    if (!store_->lookup(id, record)) {
+        return KeyRef();
+    }
+
+    KeyKind kind = record.kind == static_cast<uint8_t>(KeyKind::Kem) ? KeyKind::Kem : KeyKind::Signature;
+    std::unique_ptr<KeyEntry> entry;
+    try {
+        entry = new_entry(kind, record.algorithm);
+    } catch (const std::invalid_argument &) {
+        // Stored by a build with a different set of enabled algorithms
+        return KeyRef();
+    }
+    entry->id = id;
+    entry->public_key = std::move(record.public_key);
+    entry->secret_key = std::move(record.secret_key);
+    entry->persistent = true;
+    prepare_native_key(*entry);
+
+    // Another worker may have loaded the same key in the meantime, in which case
+    // insert() returns its entry. If the key was erased while it was being read,
+    // take it back out so the erase wins.
+    epoch::Guard guard;
+    const KeyEntry *stored = entries_.insert(id, std::move(entry));
+    if (!store_->contains(id)) {
+        entries_.erase(id);
+        guard.release();
+        return KeyRef();
+    }
+    return KeyRef(std::move(guard), stored);
+}
+
+size_t KeyRegistry::size() const {
+    return entries_.size();
+}
+
+KeyRef KeyRegistry::insert(std::unique_ptr<KeyEntry> entry) {
+    prepare_native_key(*entry);
+    do {
+        entry->id = new_key_id();
+    } while (entries_.contains(entry->id) || (store_ && store_->contains(entry->id)));
+
+    // Keys larger than a store record stay in memory only
+    if (store_ && entry->public_key.size() + entry->secret_key.size() <= store_->max_key_bytes()) {
+        KeyStore::Record record{static_cast<uint8_t>(entry->kind), entry->algorithm, entry->public_key, entry->secret_key};
+        store_->append(entry->id, record);
+        OQS_MEM_cleanse(record.secret_key.data(), record.secret_key.size());
+        entry->persistent = true;
+    }
+
+    epoch::Guard guard;
+    std::string id = entry->id;
+    return KeyRef(std::move(guard), entries_.insert(id, std::move(entry)));
+}
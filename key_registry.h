@@ -0,0 +1,101 @@
+#ifndef KEY_REGISTRY_H
+#define KEY_REGISTRY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <oqs/oqs.h>
+#include "concurrent_table.h"
+#include "epoch.h"
+#include "key_store.h"
+#include "native/kyber.h"
+
+// Kind of key material held by a registry entry. The values are stored in the
+// persistent key store, so they must not change.
+enum class KeyKind : uint8_t {
+    Kem = 0,
+    Signature = 1
+};
+
+// A key that has already been decoded and prepared for use by the crypto routes.
+// The liboqs context is created once at registration so that requests referencing
+// the key by id skip the base64 decoding and the OQS_*_new call. An ML-KEM public
+// key is also decoded for the native engine, with its matrix already expanded.
+struct KeyEntry {
+    std::string id;
+    KeyKind kind;
+    std::string algorithm;
+    std::vector<uint8_t> public_key;
+    std::vector<uint8_t> secret_key;  // Empty when only a public key was registered
+    OQS_KEM *kem = nullptr;           // Set when kind == KeyKind::Kem
+    OQS_SIG *sig = nullptr;           // Set when kind == KeyKind::Signature
+    std::unique_ptr<kyber::mlkem::EncapsulationKey> mlkem_key;  // Set for an ML-KEM public key that loads
+    bool persistent = false;          // Also written to the persistent key store
+
+    KeyEntry() = default;
+    KeyEntry(const KeyEntry &) = delete;
+    KeyEntry &operator=(const KeyEntry &) = delete;
+    ~KeyEntry();
+
+    bool has_secret_key() const { return !secret_key.empty(); }
+};
+
+// Reference to a registry entry. It keeps the calling thread inside an epoch so
+// the entry cannot be freed while in use, even if another worker erases it; drop
+// it before the handler returns and on the thread that obtained it.
+class KeyRef {
+public:
+    KeyRef() = default;
+    KeyRef(epoch::Guard guard, const KeyEntry *entry) : guard_(std::move(guard)), entry_(entry) {
+        if (!entry_) {
+            guard_.release();
+        }
+    }
+
+    const KeyEntry *get() const { return entry_; }
+    const KeyEntry *operator->() const { return entry_; }
+    const KeyEntry &operator*() const { return *entry_; }
+    explicit operator bool() const { return entry_ != nullptr; }
+
+private:
+    epoch::Guard guard_ = epoch::Guard::empty();
+    const KeyEntry *entry_ = nullptr;
+};
+
+// In-memory table of registered keys, safe for concurrent use by the Crow workers.
+// Lookups take no lock (see ConcurrentTable), since every request that references
+// a key_id goes through find() while registration and removal are comparatively rare.
+// With a persistent store, new keys are also appended to it and keys missing from
+// the table are loaded from it on first use, so only the working set is in memory.
+class KeyRegistry {
+public:
+    explicit KeyRegistry(KeyStore *store = nullptr) : store_(store) {}
+
+    // Generate a fresh key pair for the algorithm and register it
+    KeyRef generate(KeyKind kind, const std::string &algorithm);
+
+    // Register existing key material. secret_key may be empty for public-only keys.
+    KeyRef add(KeyKind kind, const std::string &algorithm,
+               std::vector<uint8_t> public_key, std::vector<uint8_t> secret_key);
+
+    // Return the entry for the id, or an empty reference if it is not registered
+    KeyRef find(const std::string &id) const;
+
+    // Remove the entry for the id. Returns false if it was not registered.
+    bool erase(const std::string &id);
+
+    size_t size() const;
+
+private:
+    KeyRef insert(std::unique_ptr<KeyEntry> entry);
+    KeyRef load(const std::string &id) const;
+
+    KeyStore *store_;
+    mutable ConcurrentTable<KeyEntry> entries_;
+};
+
+// Name used for the kind in JSON requests and responses ("kem" or "signature")
+const char *key_kind_name(KeyKind kind);
+
+#endif // KEY_REGISTRY_H
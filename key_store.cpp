@@ -0,0 +1,624 @@
+#include "key_store.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char data_magic[8] = {'K', 'Y', 'S', 'T', 'O', 'R', 'E', '1'};
+constexpr char index_magic[8] = {'K', 'Y', 'I', 'N', 'D', 'E', 'X', '1'};
+constexpr uint32_t format_version = 1;
+constexpr size_t header_size = 4096;
+constexpr size_t initial_data_slots = 64;
+constexpr size_t initial_index_buckets = 1024;
+
+constexpr uint32_t state_live = 0x4556494c;  // "LIVE"
+constexpr uint32_t state_dead = 0x44414544;  // "DEAD"
+
+std::runtime_error system_error(const std::string &what, const std::string &path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+uint32_t crc32(const uint8_t *data, size_t len) {
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+bool parse_id(const std::string &hex, uint8_t *id) {
+    if (hex.size() != 32) {
+        return false;
+    }
+    for (size_t i = 0; i < 16; i++) {
+        int value = 0;
+        for (size_t j = 0; j < 2; j++) {
+            char c = hex[2 * i + j];
+            int nibble;
+            if (c >= '0' && c <= '9') nibble = c - '0';
+            else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+            else return false;
+            value = (value << 4) | nibble;
+        }
+        id[i] = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+uint64_t id_hash(const uint8_t *id) {
+    uint64_t h;
+    std::memcpy(&h, id, sizeof(h));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+void sync_range(uint8_t *base, size_t offset, size_t len) {
+    if (msync(base + offset, len, MS_SYNC) != 0) {
+        throw std::runtime_error(std::string("msync failed: ") + std::strerror(errno));
+    }
+}
+
+uint8_t *map_file(int fd, size_t size, const std::string &path) {
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        throw system_error("Cannot map", path);
+    }
+    return static_cast<uint8_t *>(mapping);
+}
+
+} // namespace
+
+struct KeyStore::DataHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t slot_count;  // Records appended, including deleted ones
+    uint64_t live_count;
+    uint64_t dead_count;
+    uint64_t generation;  // Bumped by every compaction
+};
+
+struct KeyStore::IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t dirty;       // Set while buckets are rewritten (rebuild, growth, replay)
+    uint64_t capacity;    // Number of buckets, a power of two
+    uint64_t count;       // Used buckets
+    uint64_t data_slots;  // Data records covered by the index
+    uint64_t generation;  // Generation of the data file the index was built from
+};
+
+struct KeyStore::RecordHeader {
+    uint32_t state;
+    uint32_t crc;  // Over everything after this field, up to the end of the secret key
+    uint8_t id[16];
+    uint8_t kind;
+    uint8_t algorithm_len;
+    uint16_t reserved;
+    char algorithm[44];
+    uint32_t public_key_len;
+    uint32_t secret_key_len;
+};
+
+struct KeyStore::Bucket {
+    uint8_t id[16];
+    uint64_t slot_plus_one;  // 0 marks an empty bucket
+};
+
+KeyStore::KeyStore(const std::string &directory, uint32_t record_size)
+    : directory_(directory), record_size_(record_size) {
+    if (record_size_ % 4096 != 0 || record_size_ < 4096) {
+        throw std::invalid_argument("Key store record size must be a multiple of 4096");
+    }
+    open_data();
+    open_index();
+
+    // Reclaim space once deleted records outnumber live ones
+    auto *header = reinterpret_cast<DataHeader *>(data_);
+    if (header->dead_count >= initial_data_slots && header->dead_count > header->live_count) {
+        compact();
+    }
+}
+
+KeyStore::~KeyStore() {
+    try {
+        sync_index();
+    } catch (...) {
+        // The index is rebuilt from the data file on the next open
+    }
+    close_files();
+}
+
+size_t KeyStore::max_key_bytes() const {
+    return record_size_ - sizeof(RecordHeader);
+}
+
+KeyStore::RecordHeader *KeyStore::slot_at(uint64_t slot) const {
+    return reinterpret_cast<RecordHeader *>(data_ + header_size + slot * record_size_);
+}
+
+bool KeyStore::slot_is_live(uint64_t slot) const {
+    const RecordHeader *record = slot_at(slot);
+    if (record->state != state_live) {
+        return false;
+    }
+    size_t payload = static_cast<size_t>(record->public_key_len) + record->secret_key_len;
+    if (payload > max_key_bytes()) {
+        return false;
+    }
+    const uint8_t *begin = reinterpret_cast<const uint8_t *>(record) + offsetof(RecordHeader, id);
+    return crc32(begin, sizeof(RecordHeader) - offsetof(RecordHeader, id) + payload) == record->crc;
+}
+
+void KeyStore::map_data(size_t capacity_slots) {
+    std::string path = directory_ + "/keys.dat";
+    size_t size = header_size + capacity_slots * record_size_;
+    if (data_) {
+        munmap(data_, data_size_);
+        data_ = nullptr;
+    }
+    if (ftruncate(data_fd_, static_cast<off_t>(size)) != 0) {
+        throw system_error("Cannot resize", path);
+    }
+    data_ = map_file(data_fd_, size, path);
+    data_size_ = size;
+}
+
+void KeyStore::open_data() {
+    std::string path = directory_ + "/keys.dat";
+    data_fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (data_fd_ < 0) {
+        throw system_error("Cannot open", path);
+    }
+
+    struct stat st;
+    if (fstat(data_fd_, &st) != 0) {
+        throw system_error("Cannot stat", path);
+    }
+
+    if (st.st_size == 0) {
+        map_data(initial_data_slots);
+        auto *header = reinterpret_cast<DataHeader *>(data_);
+        std::memcpy(header->magic, data_magic, sizeof(data_magic));
+        header->version = format_version;
+        header->record_size = record_size_;
+        sync_range(data_, 0, header_size);
+        return;
+    }
+
+    if (static_cast<size_t>(st.st_size) < header_size) {
+        throw std::runtime_error("Corrupt key store " + path);
+    }
+    data_ = map_file(data_fd_, static_cast<size_t>(st.st_size), path);
+    data_size_ = static_cast<size_t>(st.st_size);
+
+    auto *header = reinterpret_cast<DataHeader *>(data_);
+    if (std::memcmp(header->magic, data_magic, sizeof(data_magic)) != 0 || header->version != format_version) {
+        throw std::runtime_error("Unsupported key store format in " + path);
+    }
+    record_size_ = header->record_size;
+
+    // A record that was synced as LIVE but not yet counted in the header
+    size_t capacity = (data_size_ - header_size) / record_size_;
+    bool recovered = false;
+    while (header->slot_count < capacity && slot_is_live(header->slot_count)) {
+        header->slot_count++;
+        header->live_count++;
+        recovered = true;
+    }
+    if (recovered) {
+        sync_range(data_, 0, header_size);
+    }
+}
+
+void KeyStore::map_index(size_t capacity) {
+    std::string path = directory_ + "/keys.idx";
+    size_t size = header_size + capacity * sizeof(Bucket);
+    if (index_) {
+        munmap(index_, index_size_);
+        index_ = nullptr;
+    }
+    if (ftruncate(index_fd_, static_cast<off_t>(size)) != 0) {
+        throw system_error("Cannot resize", path);
+    }
+    index_ = map_file(index_fd_, size, path);
+    index_size_ = size;
+}
+
+void KeyStore::open_index() {
+    std::string path = directory_ + "/keys.idx";
+    index_fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (index_fd_ < 0) {
+        throw system_error("Cannot open", path);
+    }
+
+    auto *data_header = reinterpret_cast<DataHeader *>(data_);
+    size_t wanted_capacity = initial_index_buckets;
+    while (wanted_capacity < 4 * data_header->live_count) {
+        wanted_capacity *= 2;
+    }
+
+    struct stat st;
+    if (fstat(index_fd_, &st) != 0 || static_cast<size_t>(st.st_size) < header_size) {
+        rebuild_index(wanted_capacity);
+        return;
+    }
+
+    index_ = map_file(index_fd_, static_cast<size_t>(st.st_size), path);
+    index_size_ = static_cast<size_t>(st.st_size);
+    auto *header = reinterpret_cast<IndexHeader *>(index_);
+    bool usable = std::memcmp(header->magic, index_magic, sizeof(index_magic)) == 0 &&
+                  header->version == format_version &&
+                  header->dirty == 0 &&
+                  header->generation == data_header->generation &&
+                  header->data_slots <= data_header->slot_count &&
+                  header->capacity != 0 && (header->capacity & (header->capacity - 1)) == 0 &&
+                  index_size_ == header_size + header->capacity * sizeof(Bucket);
+    if (!usable) {
+        rebuild_index(wanted_capacity);
+        return;
+    }
+
+    // Records appended after the last published data_slots. Their buckets may already be
+    // on disk without the count that went with them; counting them again only makes the
+    // table grow a little early, while missing one could let it fill up.
+    if (header->data_slots < data_header->slot_count) {
+        mark_index_dirty();
+        for (uint64_t slot = header->data_slots; slot < data_header->slot_count; slot++) {
+            if (slot_at(slot)->state == state_live) {
+                bool uncounted = index_find(slot_at(slot)->id) == static_cast<int64_t>(slot);
+                index_insert(slot_at(slot)->id, slot);
+                if (uncounted) {
+                    reinterpret_cast<IndexHeader *>(index_)->count++;
+                }
+            }
+        }
+        header = reinterpret_cast<IndexHeader *>(index_);
+        header->data_slots = data_header->slot_count;
+        sync_index();
+    }
+}
+
+void KeyStore::rebuild_index(size_t capacity) {
+    map_index(capacity);
+    std::memset(index_, 0, index_size_);
+    auto *header = reinterpret_cast<IndexHeader *>(index_);
+    auto *data_header = reinterpret_cast<DataHeader *>(data_);
+    std::memcpy(header->magic, index_magic, sizeof(index_magic));
+    header->version = format_version;
+    header->dirty = 1;
+    header->capacity = capacity;
+    header->generation = data_header->generation;
+
+    for (uint64_t slot = 0; slot < data_header->slot_count; slot++) {
+        if (slot_at(slot)->state == state_live) {
+            index_insert(slot_at(slot)->id, slot);
+        }
+    }
+    header = reinterpret_cast<IndexHeader *>(index_);
+    header->data_slots = data_header->slot_count;
+    sync_index();
+}
+
+size_t KeyStore::index_insert(const uint8_t *id, uint64_t slot) {
+    auto *header = reinterpret_cast<IndexHeader *>(index_);
+    if (2 * (header->count + 1) > header->capacity) {
+        // Rehash from the old table; the data file is not touched. Every bucket moves, so
+        // the index is only trusted again once the whole file has been synced.
+        mark_index_dirty();
+        header = reinterpret_cast<IndexHeader *>(index_);
+        std::vector<Bucket> used;
+        used.reserve(header->count);
+        auto *buckets = reinterpret_cast<Bucket *>(index_ + header_size);
+        for (uint64_t i = 0; i < header->capacity; i++) {
+            if (buckets[i].slot_plus_one != 0) {
+                used.push_back(buckets[i]);
+            }
+        }
+        IndexHeader saved = *header;
+        map_index(2 * saved.capacity);
+        std::memset(index_, 0, index_size_);
+        header = reinterpret_cast<IndexHeader *>(index_);
+        *header = saved;
+        header->capacity = 2 * saved.capacity;
+        header->count = 0;
+        for (const Bucket &bucket : used) {
+            index_insert(bucket.id, bucket.slot_plus_one - 1);
+        }
+    }
+
+    auto *buckets = reinterpret_cast<Bucket *>(index_ + header_size);
+    uint64_t mask = header->capacity - 1;
+    for (uint64_t i = id_hash(id) & mask;; i = (i + 1) & mask) {
+        if (buckets[i].slot_plus_one == 0) {
+            std::memcpy(buckets[i].id, id, 16);
+            buckets[i].slot_plus_one = slot + 1;
+            header->count++;
+            return header_size + i * sizeof(Bucket);
+        }
+        if (std::memcmp(buckets[i].id, id, 16) == 0) {
+            buckets[i].slot_plus_one = slot + 1;
+            return header_size + i * sizeof(Bucket);
+        }
+    }
+}
+
+int64_t KeyStore::index_find(const uint8_t *id) const {
+    auto *header = reinterpret_cast<const IndexHeader *>(index_);
+    auto *buckets = reinterpret_cast<const Bucket *>(index_ + header_size);
+    auto *data_header = reinterpret_cast<const DataHeader *>(data_);
+    uint64_t mask = header->capacity - 1;
+    for (uint64_t i = id_hash(id) & mask; buckets[i].slot_plus_one != 0; i = (i + 1) & mask) {
+        if (std::memcmp(buckets[i].id, id, 16) == 0) {
+            uint64_t slot = buckets[i].slot_plus_one - 1;
+            // Buckets are not trusted blindly: the record must carry the same id
+            if (slot < data_header->slot_count && std::memcmp(slot_at(slot)->id, id, 16) == 0) {
+                return static_cast<int64_t>(slot);
+            }
+            return -1;
+        }
+    }
+    return -1;
+}
+
+void KeyStore::mark_index_dirty() {
+    auto *header = reinterpret_cast<IndexHeader *>(index_);
+    if (header->dirty == 0) {
+        header->dirty = 1;
+        sync_range(index_, 0, header_size);
+    }
+}
+
+void KeyStore::sync_index() {
+    if (!index_) {
+        return;
+    }
+    auto *header = reinterpret_cast<IndexHeader *>(index_);
+    if (header->dirty == 0) {
+        return;
+    }
+    sync_range(index_, 0, index_size_);
+    header->dirty = 0;
+    sync_range(index_, 0, header_size);
+}
+
+void KeyStore::close_files() {
+    if (data_) munmap(data_, data_size_);
+    if (index_) munmap(index_, index_size_);
+    if (data_fd_ >= 0) ::close(data_fd_);
+    if (index_fd_ >= 0) ::close(index_fd_);
+    data_ = index_ = nullptr;
+    data_fd_ = index_fd_ = -1;
+}
+
+void KeyStore::append(const std::string &id, const Record &record) {
+    uint8_t raw_id[16];
+    if (!parse_id(id, raw_id)) {
+        throw std::invalid_argument("Invalid key id for the key store: " + id);
+    }
+    size_t payload = record.public_key.size() + record.secret_key.size();
+    if (payload > max_key_bytes()) {
+        throw std::length_error("Key does not fit in a key store record");
+    }
+    if (record.algorithm.size() > sizeof(RecordHeader::algorithm)) {
+        throw std::length_error("Algorithm name does not fit in a key store record");
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    int64_t existing = index_find(raw_id);
+    if (existing >= 0 && slot_at(static_cast<uint64_t>(existing))->state == state_live) {
+        throw std::invalid_argument("Key id already stored: " + id);
+    }
+
+    auto *header = reinterpret_cast<DataHeader *>(data_);
+    uint64_t slot = header->slot_count;
+    size_t capacity = (data_size_ - header_size) / record_size_;
+    if (slot == capacity) {
+        map_data(2 * capacity);
+        header = reinterpret_cast<DataHeader *>(data_);
+    }
+
+    // 1. Write and sync the record body while its state is still EMPTY
+    RecordHeader *out = slot_at(slot);
+    std::memset(out, 0, record_size_);
+    std::memcpy(out->id, raw_id, sizeof(raw_id));
+    out->kind = record.kind;
+    out->algorithm_len = static_cast<uint8_t>(record.algorithm.size());
+    std::memcpy(out->algorithm, record.algorithm.data(), record.algorithm.size());
+    out->public_key_len = static_cast<uint32_t>(record.public_key.size());
+    out->secret_key_len = static_cast<uint32_t>(record.secret_key.size());
+    uint8_t *payload_out = reinterpret_cast<uint8_t *>(out + 1);
+    if (!record.public_key.empty()) {
+        std::memcpy(payload_out, record.public_key.data(), record.public_key.size());
+    }
+    if (!record.secret_key.empty()) {
+        std::memcpy(payload_out + record.public_key.size(), record.secret_key.data(), record.secret_key.size());
+    }
+    const uint8_t *crc_begin = reinterpret_cast<const uint8_t *>(out) + offsetof(RecordHeader, id);
+    out->crc = crc32(crc_begin, sizeof(RecordHeader) - offsetof(RecordHeader, id) + payload);
+    size_t slot_offset = header_size + slot * record_size_;
+    sync_range(data_, slot_offset, record_size_);
+
+    // 2. Publish the record, then count it in the header
+    out->state = state_live;
+    sync_range(data_, slot_offset, 4096);
+    header->slot_count = slot + 1;
+    header->live_count++;
+    sync_range(data_, 0, header_size);
+
+    // 3. Sync the bucket, then publish it by covering the slot with data_slots. The index
+    //    stays clean: a crash before the header sync only leaves this record to be
+    //    replayed at open, which is what keeps restarts from rescanning the log.
+    size_t bucket_offset = index_insert(raw_id, slot);
+    auto *index_header = reinterpret_cast<IndexHeader *>(index_);
+    if (index_header->dirty != 0) {
+        index_header->data_slots = header->slot_count;
+        sync_index();
+        return;
+    }
+    size_t page = bucket_offset & ~size_t(4095);
+    sync_range(index_, page, bucket_offset + sizeof(Bucket) - page);
+    index_header->data_slots = header->slot_count;
+    sync_range(index_, 0, header_size);
+}
+
+bool KeyStore::lookup(const std::string &id, Record &record) const {
+    uint8_t raw_id[16];
+    if (!parse_id(id, raw_id)) {
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    int64_t slot = index_find(raw_id);
+    if (slot < 0) {
+        return false;
+    }
+    const RecordHeader *in = slot_at(static_cast<uint64_t>(slot));
+    if (in->state != state_live) {
+        return false;
+    }
+
+    const uint8_t *payload = reinterpret_cast<const uint8_t *>(in + 1);
+    record.kind = in->kind;
+    record.algorithm.assign(in->algorithm, in->algorithm_len);
+    record.public_key.assign(payload, payload + in->public_key_len);
+    record.secret_key.assign(payload + in->public_key_len, payload + in->public_key_len + in->secret_key_len);
+    return true;
+}
+
+bool KeyStore::contains(const std::string &id) const {
+    uint8_t raw_id[16];
+    if (!parse_id(id, raw_id)) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    int64_t slot = index_find(raw_id);
+    return slot >= 0 && slot_at(static_cast<uint64_t>(slot))->state == state_live;
+}
+
+bool KeyStore::remove(const std::string &id) {
+    uint8_t raw_id[16];
+    if (!parse_id(id, raw_id)) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    int64_t slot = index_find(raw_id);
+    if (slot < 0 || slot_at(static_cast<uint64_t>(slot))->state != state_live) {
+        return false;
+    }
+
+    size_t slot_offset = header_size + static_cast<size_t>(slot) * record_size_;
+    RecordHeader *record = slot_at(static_cast<uint64_t>(slot));
+    record->state = state_dead;
+    // Do not leave secret key bytes behind in the log
+    std::memset(reinterpret_cast<uint8_t *>(record + 1) + record->public_key_len, 0, record->secret_key_len);
+    sync_range(data_, slot_offset, record_size_);
+
+    auto *header = reinterpret_cast<DataHeader *>(data_);
+    header->live_count--;
+    header->dead_count++;
+    sync_range(data_, 0, header_size);
+    return true;
+}
+
+void KeyStore::compact() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto *header = reinterpret_cast<DataHeader *>(data_);
+
+    size_t capacity = initial_data_slots;
+    while (capacity < header->live_count) {
+        capacity *= 2;
+    }
+
+    std::string path = directory_ + "/keys.dat";
+    std::string tmp_path = path + ".compact";
+    int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        throw system_error("Cannot open", tmp_path);
+    }
+    if (ftruncate(fd, static_cast<off_t>(header_size + capacity * record_size_)) != 0) {
+        ::close(fd);
+        throw system_error("Cannot resize", tmp_path);
+    }
+
+    uint64_t written = 0;
+    for (uint64_t slot = 0; slot < header->slot_count; slot++) {
+        if (slot_at(slot)->state != state_live) {
+            continue;
+        }
+        off_t offset = static_cast<off_t>(header_size + written * record_size_);
+        if (pwrite(fd, slot_at(slot), record_size_, offset) != static_cast<ssize_t>(record_size_)) {
+            ::close(fd);
+            throw system_error("Cannot write", tmp_path);
+        }
+        written++;
+    }
+
+    DataHeader compacted = *header;
+    compacted.slot_count = written;
+    compacted.live_count = written;
+    compacted.dead_count = 0;
+    compacted.generation = header->generation + 1;
+    std::vector<uint8_t> header_page(header_size, 0);
+    std::memcpy(header_page.data(), &compacted, sizeof(compacted));
+    if (pwrite(fd, header_page.data(), header_size, 0) != static_cast<ssize_t>(header_size) || fsync(fd) != 0) {
+        ::close(fd);
+        throw system_error("Cannot write", tmp_path);
+    }
+    ::close(fd);
+
+    // The rename is the commit point. A stale index is detected by its
+    // generation and rebuilt when the store is opened again.
+    if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw system_error("Cannot replace", path);
+    }
+    int dir_fd = ::open(directory_.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    close_files();
+    open_data();
+    index_fd_ = ::open((directory_ + "/keys.idx").c_str(), O_RDWR | O_CREAT, 0600);
+    if (index_fd_ < 0) {
+        throw system_error("Cannot open", directory_ + "/keys.idx");
+    }
+    size_t index_capacity = initial_index_buckets;
+    while (index_capacity < 4 * written) {
+        index_capacity *= 2;
+    }
+    rebuild_index(index_capacity);
+}
+
+size_t KeyStore::live_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return reinterpret_cast<const DataHeader *>(data_)->live_count;
+}
+
+size_t KeyStore::dead_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return reinterpret_cast<const DataHeader *>(data_)->dead_count;
+}
@@ -0,0 +1,96 @@
+#ifndef KEY_STORE_H
+#define KEY_STORE_H
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Persistent key store made of two memory-mapped files in one directory:
+//
+//   keys.dat  append-only log of fixed-size records, one per key. A record is
+//             written and synced before its state word is set to LIVE, and the
+//             header slot count is only advanced after that, so a crash leaves
+//             at most one unreferenced record at the tail.
+//   keys.idx  open-addressing hash table from key id to record number, derived
+//             from keys.dat. An append syncs its bucket before advancing the
+//             header's count of covered records, so after a crash only the
+//             uncovered tail is replayed; the table is rebuilt from the whole
+//             log only if a growth or compaction did not finish.
+//
+// Opening the store only maps both files; key bytes are read from the mapping
+// on lookup, so they are faulted in by the page cache as they are used.
+class KeyStore {
+public:
+    static constexpr uint32_t default_record_size = 8192;
+
+    struct Record {
+        uint8_t kind;
+        std::string algorithm;
+        std::vector<uint8_t> public_key;
+        std::vector<uint8_t> secret_key;
+    };
+
+    // Open (or create) the store in an existing directory. record_size is only
+    // used when the data file is created.
+    explicit KeyStore(const std::string &directory, uint32_t record_size = default_record_size);
+    ~KeyStore();
+
+    KeyStore(const KeyStore &) = delete;
+    KeyStore &operator=(const KeyStore &) = delete;
+
+    // Largest public + secret key length that fits in one record
+    size_t max_key_bytes() const;
+
+    // Durably append a key under a 32-character hex id
+    void append(const std::string &id, const Record &record);
+
+    // Copy the live record for the id out of the mapping
+    bool lookup(const std::string &id, Record &record) const;
+
+    bool contains(const std::string &id) const;
+
+    // Mark the record for the id as deleted. Returns false if it was not live.
+    bool remove(const std::string &id);
+
+    // Rewrite the log with only live records and rebuild the index
+    void compact();
+
+    size_t live_count() const;
+    size_t dead_count() const;
+
+private:
+    struct DataHeader;
+    struct IndexHeader;
+    struct RecordHeader;
+    struct Bucket;
+
+    void open_data();
+    void open_index();
+    void map_data(size_t capacity_slots);
+    void map_index(size_t capacity);
+    void rebuild_index(size_t capacity);
+    size_t index_insert(const uint8_t *id, uint64_t slot);  // Returns the bucket's offset
+    int64_t index_find(const uint8_t *id) const;
+    void mark_index_dirty();
+    void sync_index();
+    void close_files();
+
+    RecordHeader *slot_at(uint64_t slot) const;
+    bool slot_is_live(uint64_t slot) const;
+
+    std::string directory_;
+    uint32_t record_size_;
+
+    int data_fd_ = -1;
+    uint8_t *data_ = nullptr;
+    size_t data_size_ = 0;
+
+    int index_fd_ = -1;
+    uint8_t *index_ = nullptr;
+    size_t index_size_ = 0;
+
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // KEY_STORE_H
@@ -8,6 +8,7 @@ from flask import Flask, request, jsonify
 import json
 import base64
 import matplotlib.pyplot as plt
+import native_engine # Motor nativo en C++ (make native_lib). Si no está compilado, todo sigue en Python.
 
 ## Funciones auxiliares
 def es_primo(n):
@@ -186,6 +187,8 @@ def NTT_kyber(a):
   si existe la 256-raiz primitiva (en Zq).
   El output está en bitreverse.
   """
+  if native_engine.disponible(): # Mismo resultado calculado en C++.
+    return native_engine.NTT_kyber(a)
 
   # Primero si el grado del polinomio es menor que 256
   # para aplicar NTT rellenamos con ceros pues no cambia el polinomio.
@@ -246,6 +249,8 @@ def INTT_kyber(a):
   si existe la 256-raiz primitiva (en Zq).
   El input está en bitreverse-order y el otput en orden estándar.
   """
+  if native_engine.disponible(): # Mismo resultado calculado en C++.
+    return native_engine.INTT_kyber(a)
 
   # Primero si el grado del polinomio es menor que 256
   # para aplicar INTT rellenamos con ceros pues no cambia el polinomio.
@@ -275,6 +280,8 @@ def KyberConvolution(p,g, pnttdomain = False , gnttdomain= False):
   Esta será específica para kyber pues no existe una 512 raíz de la unidad, luego sus parámetros vienen ya impuestos
   por q=3329, n=256.
   """
+  if native_engine.disponible() and pnttdomain == False and gnttdomain == False: # Caso sin NTT previa, en C++.
+    return native_engine.KyberConvolution(p,g)
   # Parámetros:
   q=3329
   n=256
@@ -424,6 +431,8 @@ def pointwise(p,g):
   Multiplicamos dos polinomios usando
   la multiplicación punto a punto en Zq[x]/(x^2-w^2br(i)+1)
   """
+  if native_engine.disponible(): # Mismo resultado calculado en C++.
+    return native_engine.pointwise(p,g)
   # Parámetros:
   q=3329
   n=256
@@ -459,6 +468,8 @@ def Parse(b):
   Input: Conjunto de bytes arbitrario.
   Output: Coeficientes de Zq[x] que se interpretará como un elemento en el dominio NTT. (biyectivo)
   """
+  if native_engine.disponible(): # Mismo resultado calculado en C++.
+    return native_engine.Parse(b)
   i, j, n, q = 0, 0, 256, 3329
   a=n*[0] # Serán nuestros coeficientes de Zq.
 
@@ -486,6 +497,10 @@ def CBD(input_bytes, eta):
 
         Se espera un input_bytes de al menos 64*eta de longitud.
         """
+        if native_engine.disponible() and eta in (2, 3): # En C++, para eta = 2 o 3.
+            coefficients = native_engine.CBD(input_bytes, eta)
+            if coefficients is not None:
+                return coefficients
         n=256
         assert (n >> 2)*eta == len(input_bytes)
         coefficients = [0 for _ in range(n)]
@@ -505,6 +520,10 @@ def decode(input_bytes, l=None):
 
         decode: B^32l -> R_q
         """
+        if native_engine.disponible() and l is not None: # En C++ si l <= 12 y la longitud es exacta.
+            coefficients = native_engine.decode(input_bytes, l)
+            if coefficients is not None:
+                return coefficients
         n, q = 256,3329
         if l is None:
             l, r = divmod(8*len(input_bytes),n) # Aqui comprobamos que el resto r es 0, es decir que es divisible por n, es decir que len(input_bytes) es múltiplo de 32.
@@ -546,6 +565,10 @@ def encode(p, l=None):
    Encode (Inverse of Algorithm 3)
    R_q--> B^32l
    """
+   if native_engine.disponible() and l is not None: # En C++ si l <= 12 y los coeficientes caben en l bits.
+     output = native_engine.encode(p, l)
+     if output is not None:
+       return output
    if l is None:
     l = max(x.bit_length() for x in p)
    bit_string = ''.join(format(c, f'0{l}b')[::-1] for c in p) # Agrupamos en bytes de como mucho l bits.
@@ -575,6 +598,10 @@ def compress(x, d):
             Comprimos una lista de coeficientes/bytes de un polinomio.
             Veáse que realmente no se conservará  la invertibilidad con decompress pero serán cercanos.
             """
+            if native_engine.disponible(): # En C++ para polinomios de 256 coeficientes y d <= 12.
+              pol_comprimido = native_engine.compress(x, d)
+              if pol_comprimido is not None:
+                return pol_comprimido
             q=3329 # Siempre será el mismo q, para todas las versiones de Kyber: 512,768,1024.
             compr_mod = 2**d
             number = compr_mod/q
@@ -596,6 +623,10 @@ def decompress(x, d):
   Descomprimimos la lista haciendolo para cada componente/byte/coeficiente.
   Veáse que x' = decompress(compress(x)), pero x' != x, pero es cercano (diferencia menor que Bq, viene definido en el resource.)
   """
+  if native_engine.disponible(): # En C++ para polinomios de 256 coeficientes y d <= 12.
+    pol_descomprimido = native_engine.decompress(x, d)
+    if pol_descomprimido is not None:
+      return pol_descomprimido
   q=3329
   number = q / (2**d)
   pol_descomprimido = [round_up(number*c) for c in x ]
@@ -692,6 +723,11 @@ def keygen(k,n1):
   n, q = 256, 3329
 
   d = os.urandom(32) # Semilla de aleatoridad. # El sistema nos da 32 bytes aleatorios y los pasamos a formato lista con enteros.
+
+  if native_engine.disponible(): # Todo el algoritmo en C++ con la misma semilla, mismas claves.
+    claves = native_engine.keygen(k, n1, d)
+    if claves is not None:
+      return claves
   # print('d es: ',d)
   rho, sigma = G(d)
   # print('rho es: ', rho)
@@ -740,6 +776,10 @@ def encryption(pk,m,r1,k,n1,n2,du,dv):
   Inputs: public key: pk, message: m, r = coins, k = dimention.
   Output : "Chipertext : B^(du*k*n/8+dv*n/8)
   """
+  if native_engine.disponible(): # Todo el algoritmo en C++ si los parámetros son de Kyber512/768/1024.
+    c = native_engine.encryption(pk,m,r1,k,n1,n2,du,dv)
+    if c is not None:
+      return c
   n , q, N = 256, 3329, 0
 
   rho = pk[-32:]
@@ -790,6 +830,10 @@ def decryption(sk,c,du,dv):
   Inputs: secret key: sk, du, dv, Chipertext : B^(du*k*n/8+dv*n/8)
   Output : message: m
   """
+  if native_engine.disponible(): # Todo el algoritmo en C++ si los parámetros son de Kyber512/768/1024.
+    m = native_engine.decryption(sk,c,k,n1,n2,du,dv)
+    if m is not None:
+      return m
   n, q = 256, 3329
   # Partimos el ciphertext a vectores.
   c2 = c[du*k*(n//8):]
@@ -0,0 +1,214 @@
+#include "merkle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "native/fips202.h"
+#include "native/fips202x4.h"
+
+namespace merkle {
+
+namespace {
+
+const char context[] = "ml-kem-api merkle root sha3-256";
+
+constexpr uint8_t leaf_prefix = 0x00;
+constexpr uint8_t node_prefix = 0x01;
+constexpr size_t node_input_length = 1 + 2 * hash_length;
+constexpr size_t signed_length = hash_length + 8;
+
+// Items per thread below which another thread is not worth starting
+constexpr size_t min_leaves_per_thread = 1024;
+constexpr size_t min_nodes_per_thread = 4096;
+
+// Run fn(begin, end) over [0, count) split across at most workers threads
+template <typename Fn>
+void parallel_for(size_t count, size_t workers, size_t min_per_thread, Fn fn) {
+    size_t threads = std::min(workers, (count + min_per_thread - 1) / min_per_thread);
+    if (threads <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+    size_t step = (count + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    for (size_t begin = step; begin < count; begin += step) {
+        pool.emplace_back(fn, begin, std::min(count, begin + step));
+    }
+    fn(size_t(0), step);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+}
+
+void node_input(const Hash &left, const Hash &right, uint8_t in[node_input_length]) {
+    in[0] = node_prefix;
+    std::memcpy(in + 1, left.data(), hash_length);
+    std::memcpy(in + 1 + hash_length, right.data(), hash_length);
+}
+
+Hash node_hash(const Hash &left, const Hash &right) {
+    uint8_t in[node_input_length];
+    node_input(left, right, in);
+    Hash out;
+    fips202::sha3_256(out.data(), in, sizeof(in));
+    return out;
+}
+
+// Parents [begin, end) of a level, four at a time while there are four
+void hash_parents(const std::vector<Hash> &children, std::vector<Hash> &parents, size_t begin, size_t end) {
+    size_t p = begin;
+    for (; p + 4 <= end; p += 4) {
+        uint8_t in[4][node_input_length];
+        for (int l = 0; l < 4; l++) {
+            node_input(children[2 * (p + l)], children[2 * (p + l) + 1], in[l]);
+        }
+        const uint8_t *const ins[4] = {in[0], in[1], in[2], in[3]};
+        uint8_t *const outs[4] = {parents[p].data(), parents[p + 1].data(), parents[p + 2].data(), parents[p + 3].data()};
+        fips202::sha3_256x4(outs, ins, node_input_length);
+    }
+    for (; p < end; p++) {
+        parents[p] = node_hash(children[2 * p], children[2 * p + 1]);
+    }
+}
+
+void signed_message(const Hash &root, uint64_t count, uint8_t out[signed_length]) {
+    std::memcpy(out, root.data(), hash_length);
+    for (int i = 0; i < 8; i++) {
+        out[hash_length + i] = uint8_t(count >> (56 - 8 * i));
+    }
+}
+
+} // namespace
+
+Hash leaf_hash(const uint8_t *message, size_t len) {
+    fips202::Sponge sponge(fips202::sha3_256_rate, 0x06);
+    sponge.absorb(&leaf_prefix, 1);
+    sponge.absorb(message, len);
+    Hash out;
+    sponge.squeeze(out.data(), out.size());
+    return out;
+}
+
+Tree::Tree(const std::vector<std::string_view> &messages, size_t workers) {
+    if (messages.empty()) {
+        throw std::invalid_argument("A Merkle batch needs at least one message");
+    }
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<Hash> leaves(messages.size());
+    parallel_for(messages.size(), workers, min_leaves_per_thread, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            leaves[i] = leaf_hash(reinterpret_cast<const uint8_t *>(messages[i].data()), messages[i].size());
+        }
+    });
+    levels_.push_back(std::move(leaves));
+
+    while (levels_.back().size() > 1) {
+        const std::vector<Hash> &children = levels_.back();
+        std::vector<Hash> parents((children.size() + 1) / 2);
+        size_t pairs = children.size() / 2;
+        parallel_for(pairs, workers, min_nodes_per_thread, [&](size_t begin, size_t end) {
+            hash_parents(children, parents, begin, end);
+        });
+        if (children.size() % 2) {
+            parents.back() = children.back();
+        }
+        levels_.push_back(std::move(parents));
+    }
+}
+
+std::string Tree::proof(size_t index) const {
+    std::string proof;
+    for (size_t level = 0; level + 1 < levels_.size(); level++, index >>= 1) {
+        size_t sibling = index ^ 1;
+        if (sibling < levels_[level].size()) {
+            proof.append(reinterpret_cast<const char *>(levels_[level][sibling].data()), hash_length);
+        }
+    }
+    return proof;
+}
+
+bool root_from_proof(const Hash &leaf, uint64_t index, uint64_t count, std::string_view proof, Hash &root) {
+    if (index >= count) {
+        return false;
+    }
+    Hash node = leaf;
+    size_t pos = 0;
+    for (; count > 1; index >>= 1, count = (count + 1) / 2) {
+        if ((index ^ 1) >= count) {
+            continue;
+        }
+        if (proof.size() - pos < hash_length) {
+            return false;
+        }
+        Hash sibling;
+        std::memcpy(sibling.data(), proof.data() + pos, hash_length);
+        pos += hash_length;
+        node = (index & 1) ? node_hash(sibling, node) : node_hash(node, sibling);
+    }
+    root = node;
+    return pos == proof.size();
+}
+
+std::vector<uint8_t> sign_root(const OQS_SIG *sig, const Hash &root, uint64_t count, const uint8_t *secret_key) {
+    if (!sig->sig_with_ctx_support) {
+        throw std::invalid_argument(std::string(sig->method_name) + " does not support Merkle batch signing");
+    }
+    uint8_t message[signed_length];
+    signed_message(root, count, message);
+    std::vector<uint8_t> signature(sig->length_signature);
+    size_t signature_len = signature.size();
+    if (OQS_SIG_sign_with_ctx_str(sig, signature.data(), &signature_len, message, sizeof(message),
+                                  reinterpret_cast<const uint8_t *>(context), sizeof(context) - 1, secret_key) != OQS_SUCCESS) {
+        throw std::runtime_error("Signing failed.");
+    }
+    signature.resize(signature_len);
+    return signature;
+}
+
+bool verify_root(const OQS_SIG *sig, const Hash &root, uint64_t count, std::string_view signature,
+                 std::string_view public_key) {
+    if (!sig->sig_with_ctx_support || public_key.size() != sig->length_public_key) {
+        return false;
+    }
+    uint8_t message[signed_length];
+    signed_message(root, count, message);
+    return OQS_SIG_verify_with_ctx_str(sig, message, sizeof(message), reinterpret_cast<const uint8_t *>(signature.data()),
+                                       signature.size(), reinterpret_cast<const uint8_t *>(context), sizeof(context) - 1,
+                                       reinterpret_cast<const uint8_t *>(public_key.data())) == OQS_SUCCESS;
+}
+
+std::string RootCache::cache_key(const Hash &root, uint64_t count) {
+    uint8_t key[signed_length];
+    signed_message(root, count, key);
+    return std::string(reinterpret_cast<const char *>(key), sizeof(key));
+}
+
+bool RootCache::contains(const std::string &algorithm, std::string_view public_key, const Hash &root, uint64_t count,
+                         std::string_view signature) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(cache_key(root, count));
+    return it != entries_.end() && it->second.algorithm == algorithm && it->second.public_key == public_key &&
+           it->second.signature == signature;
+}
+
+void RootCache::insert(const std::string &algorithm, std::string_view public_key, const Hash &root, uint64_t count,
+                       std::string_view signature) {
+    std::string key = cache_key(root, count);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = entries_.try_emplace(key);
+    it->second = Entry{algorithm, std::string(public_key), std::string(signature)};
+    if (!inserted) {
+        return;
+    }
+    order_.push_back(std::move(key));
+    if (order_.size() > capacity_) {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+}
+
+} // namespace merkle
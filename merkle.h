@@ -0,0 +1,89 @@
+#ifndef MERKLE_H
+#define MERKLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <oqs/oqs.h>
+
+// Batch signing with a SHA3-256 Merkle tree: one signature over the root stands for
+// every message of the batch, and each message carries an inclusion proof of
+// ceil(log2(n)) hashes instead of a signature of its own.
+//
+// Leaves are SHA3-256(0x00 || message) and inner nodes SHA3-256(0x01 || left || right),
+// so a leaf can never be passed off as an inner node. A node without a sibling (the
+// last one of a level with an odd count) moves up unchanged and adds nothing to the
+// proofs that pass through it. The root is signed as root || uint64_be(leaf count)
+// under a dedicated context string, so the count a proof is checked against is the
+// one the signer committed to.
+namespace merkle {
+
+constexpr size_t hash_length = 32;
+using Hash = std::array<uint8_t, hash_length>;
+
+Hash leaf_hash(const uint8_t *message, size_t len);
+
+class Tree {
+public:
+    // Leaves are hashed on up to workers threads (0 for one per hardware thread), and
+    // each level is hashed four nodes at a time with the 4-way Keccak
+    explicit Tree(const std::vector<std::string_view> &messages, size_t workers = 0);
+
+    const Hash &root() const { return levels_.back().front(); }
+    size_t size() const { return levels_.front().size(); }
+
+    // Sibling hashes from the leaf up, concatenated
+    std::string proof(size_t index) const;
+
+private:
+    std::vector<std::vector<Hash>> levels_;  // levels_[0] are the leaves
+};
+
+// Recompute the root for a leaf at index in a tree of count leaves. Returns false
+// when the proof does not have exactly the length that position requires.
+bool root_from_proof(const Hash &leaf, uint64_t index, uint64_t count, std::string_view proof, Hash &root);
+
+// Throws std::invalid_argument when the algorithm cannot sign with a context string
+// and std::runtime_error when signing fails
+std::vector<uint8_t> sign_root(const OQS_SIG *sig, const Hash &root, uint64_t count, const uint8_t *secret_key);
+
+bool verify_root(const OQS_SIG *sig, const Hash &root, uint64_t count, std::string_view signature,
+                 std::string_view public_key);
+
+// Root signatures that have already been verified, so that checking the proofs of a
+// batch one request at a time pays for one signature verification. A hit requires the
+// same algorithm, public key and signature bytes as the verified entry; the oldest
+// entry is evicted once capacity is reached.
+class RootCache {
+public:
+    explicit RootCache(size_t capacity = 4096) : capacity_(capacity) {}
+
+    bool contains(const std::string &algorithm, std::string_view public_key, const Hash &root, uint64_t count,
+                  std::string_view signature) const;
+    void insert(const std::string &algorithm, std::string_view public_key, const Hash &root, uint64_t count,
+                std::string_view signature);
+
+private:
+    struct Entry {
+        std::string algorithm;
+        std::string public_key;
+        std::string signature;
+    };
+
+    static std::string cache_key(const Hash &root, uint64_t count);
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;  // By root || uint64_be(count)
+    std::deque<std::string> order_;                  // Keys in insertion order
+};
+
+} // namespace merkle
+
+#endif // MERKLE_H
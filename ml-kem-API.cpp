@@ -1,9 +1,25 @@
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include <cstring>
+#include <sstream>
 #include <oqs/oqs.h>
 #include "crow.h"  // Library Crow to make the API REST
 #include <base64.h>  // Library to encode Base64
+#include "key_registry.h"  // Server-side keys referenced by key_id
+#include "hybrid_kem.h"  // X25519 + ML-KEM-768 hybrid key exchange
+#include "native/kyber.h"  // Native port of the kypher.py Kyber engine
+#include "drbg.h"  // Per-thread ChaCha20 DRBG behind OQS_randombytes
+#include "algorithm_catalog.h"  // Enabled liboqs algorithms with timings measured on this host
+#include "ndjson.h"  // NDJSON bodies for the bulk routes
+#include "batch_aead.h"  // Per-item AES-GCM keys derived from one encapsulation
+#include "session.h"  // AES-GCM sessions keyed by one KEM handshake
+#include "prehash.h"  // Signatures over a SHAKE256 digest of large messages
+#include "merkle.h"  // One signature per batch over a Merkle root, with inclusion proofs
+#include "verify_cache.h"  // Successful verifications remembered for a TTL
+#include "reuseport_server.h"  // Several SO_REUSEPORT listeners on one port
+#include "unix_socket_server.h"  // The same routes on a unix domain socket
+#include "rpc.h"  // Binary framed sign/verify protocol
 
 // Function to generate keys for ML-DSA (ML-DSA-44, ML-DSA-65, ML-DSA-87)
 std::pair<std::string, std::string> generate_ml_dsa_keys(const std::string &ml_dsa_variant) {
@@ -40,6 +56,35 @@ std::pair<std::string, std::string> generate_ml_dsa_keys(const std::string &ml_d
     return {public_key_base64, private_key_base64};
 }
 
+// Function to sign a message with an already initialized signature algorithm, returning the raw signature
+std::string sign_raw_with_sig(const OQS_SIG *sig, std::string_view message, const uint8_t *private_key) {
+    std::string signature(sig->length_signature, '\0');
+    size_t signature_len = signature.size();
+    if (OQS_SIG_sign(sig, reinterpret_cast<uint8_t *>(&signature[0]), &signature_len, reinterpret_cast<const uint8_t *>(message.data()), message.size(), private_key) != OQS_SUCCESS) {
+        throw std::runtime_error("Signing failed.");
+    }
+    signature.resize(signature_len);
+    return signature;
+}
+
+// Function to sign a message with an already initialized signature algorithm
+std::string sign_message_with_sig(const OQS_SIG *sig, const std::string &message, const uint8_t *private_key) {
+    std::string signature = sign_raw_with_sig(sig, message, private_key);
+
+    // Convert the signature to Base64 for easy transmission
+    return base64_encode(reinterpret_cast<const unsigned char *>(signature.data()), signature.size());
+}
+
+// Function to verify a raw signature with an already initialized signature algorithm
+bool verify_raw_with_sig(const OQS_SIG *sig, std::string_view message, std::string_view signature, const uint8_t *public_key) {
+    return OQS_SIG_verify(sig, reinterpret_cast<const uint8_t *>(message.data()), message.size(), reinterpret_cast<const uint8_t *>(signature.data()), signature.size(), public_key) == OQS_SUCCESS;
+}
+
+// Function to verify a signature with an already initialized signature algorithm
+bool verify_message_with_sig(const OQS_SIG *sig, const std::string &message, const std::string &signature_base64, const uint8_t *public_key) {
+    return verify_raw_with_sig(sig, message, base64_decode(signature_base64), public_key);
+}
+
 // Function to sign a message using ML-DSA (from liboqs)
 std::string sign_message_with_mldsa(const std::string &message, uint8_t *private_key, size_t private_key_len, const std::string &ml_dsa_variant) {
     // Map the variant string to the corresponding OQS_SIG algorithm
@@ -60,24 +105,14 @@ std::string sign_message_with_mldsa(const std::string &message, uint8_t *private
         throw std::runtime_error("Error initializing the ML-DSA signature algorithm.");
     }
 
-    // Sign the message
-    size_t signature_len = sig->length_signature;
-    uint8_t *signature = new uint8_t[signature_len];
-
-    if (OQS_SIG_sign(sig, signature, &signature_len, (uint8_t*)message.c_str(), message.size(), private_key) != OQS_SUCCESS) {
+    try {
+        std::string signature_base64 = sign_message_with_sig(sig, message, private_key);
         OQS_SIG_free(sig);
-        delete[] signature;
-        throw std::runtime_error("Signing failed.");
+        return signature_base64;
+    } catch (...) {
+        OQS_SIG_free(sig);
+        throw;
     }
-
-    // Convert the signature to Base64 for easy transmission
-    std::string signature_base64 = base64_encode(signature, signature_len);
-
-    // Clean up
-    OQS_SIG_free(sig);
-    delete[] signature;
-
-    return signature_base64;
 }
 
 // Function to verify the signature using ML-DSA
@@ -100,17 +135,11 @@ bool verify_message_with_mldsa(const std::string &message, const std::string &si
         throw std::runtime_error("Error initializing the ML-DSA signature algorithm.");
     }
 
-    // Decode the signature from Base64
-    std::string decoded_signature = base64_decode(signature_base64);
-    uint8_t *signature = new uint8_t[decoded_signature.size()];
-    std::memcpy(signature, decoded_signature.data(), decoded_signature.size());
-
     // Verify the signature
-    bool result = OQS_SIG_verify(sig, (uint8_t*)message.c_str(), message.size(), signature, decoded_signature.size(), public_key) == OQS_SUCCESS;
+    bool result = verify_message_with_sig(sig, message, signature_base64, public_key);
 
     // Clean up
     OQS_SIG_free(sig);
-    delete[] signature;
 
     return result;
 }
@@ -123,6 +152,15 @@ void xor_cipher(const uint8_t *key, const std::string &message, uint8_t *output)
     }
 }
 
+// Function to encapsulate with an already initialized KEM
+bool encrypt_message_with_kem(const OQS_KEM *kem, const uint8_t *public_key, uint8_t *ciphertext, uint8_t *shared_secret_encap) {
+    if (OQS_KEM_encaps(kem, ciphertext, shared_secret_encap, public_key) != OQS_SUCCESS) {
+        std::cerr << "Error during key encapsulation." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool encrypt_message_with_mlkem(const std::string &kem_name, const std::string &message, const uint8_t *public_key, uint8_t *ciphertext, uint8_t *shared_secret_encap) {
     OQS_KEM *kem = OQS_KEM_new(kem_name.c_str());
     if (kem == nullptr) {
@@ -130,16 +168,527 @@ bool encrypt_message_with_mlkem(const std::string &kem_name, const std::string &
         return false;
     }
 
-    if (OQS_KEM_encaps(kem, ciphertext, shared_secret_encap, public_key) != OQS_SUCCESS) {
-        std::cerr << "Error during key encapsulation." << std::endl;
-        OQS_KEM_free(kem);
+    bool encapsulated = encrypt_message_with_kem(kem, public_key, ciphertext, shared_secret_encap);
+    OQS_KEM_free(kem);
+    return encapsulated;
+}
+
+// Function to XOR-encrypt a message in 32-byte blocks joined with "::"
+std::string xor_encrypt_blocks(const uint8_t *shared_secret, const std::string &message) {
+    size_t block_size = 32;
+    std::string xor_encrypted_base64 = "";
+    for (size_t i = 0; i < message.size(); i += block_size) {
+        std::string block = message.substr(i, block_size);
+        uint8_t *xor_encrypted_block = new uint8_t[block.size()];
+        xor_cipher(shared_secret, block, xor_encrypted_block);
+        if (i != 0) xor_encrypted_base64 += "::";
+        xor_encrypted_base64 += base64_encode(xor_encrypted_block, block.size());
+        delete[] xor_encrypted_block;
+    }
+    return xor_encrypted_base64;
+}
+
+// Function to run count encapsulations to one loaded ML-KEM key, writing the shared secrets back to back
+void native_encaps_to_key(const kyber::mlkem::EncapsulationKey &key, const kyber::Params &params, size_t count, uint8_t *shared_secrets) {
+    std::vector<uint8_t> coins(32 * count);
+    OQS_randombytes(coins.data(), coins.size());
+    std::vector<const kyber::mlkem::EncapsulationKey *> keys(count, &key);
+    std::vector<uint8_t> ciphertexts(count * params.ciphertext_bytes());
+    kyber::mlkem::encaps_batch(keys.data(), count, ciphertexts.data(), shared_secrets, coins.data());
+    OQS_MEM_cleanse(coins.data(), coins.size());
+}
+
+// Function to run a batch of ML-KEM encapsulations on the native multi-buffer engine.
+// Returns the shared secrets back to back, or nothing when kem_name is not an ML-KEM
+// parameter set and liboqs has to do the work. Throws std::invalid_argument for a
+// public key of the wrong length or one that fails the FIPS 203 modulus check.
+std::vector<uint8_t> native_mlkem_encaps_batch(const std::string &kem_name, const uint8_t *public_key, size_t public_key_len, size_t count) {
+    const kyber::Params *params = kyber::mlkem::params_by_name(kem_name);
+    if (!params || count == 0) {
+        return {};
+    }
+    // The decoded key holds the expanded matrix (about 10 KB), so keep it on the heap
+    auto key = std::make_unique<kyber::mlkem::EncapsulationKey>();
+    if (!kyber::mlkem::load_encapsulation_key(*key, *params, public_key, public_key_len)) {
+        throw std::invalid_argument("Invalid public key for " + kem_name);
+    }
+    std::vector<uint8_t> shared_secrets(kyber::mlkem::shared_secret_bytes * count);
+    native_encaps_to_key(*key, *params, count, shared_secrets.data());
+    return shared_secrets;
+}
+
+// Shared secrets for one request's ML-KEM key, made four encapsulations at a time on the
+// native engine and handed out one per item. NDJSON lines reach the workers one by one,
+// so this is how they still share the 4-way batch; a refill's spare secrets wait here
+// for the next lines of any worker.
+class NativeEncapsReservoir {
+public:
+    static constexpr size_t batch = 4;
+
+    // Load the public key for this request. Throws std::invalid_argument if it does not load.
+    NativeEncapsReservoir(const std::string &kem_name, const kyber::Params &params, const uint8_t *public_key, size_t public_key_len)
+        : params_(params), own_key_(std::make_unique<kyber::mlkem::EncapsulationKey>()), key_(own_key_.get()) {
+        if (!kyber::mlkem::load_encapsulation_key(*own_key_, params, public_key, public_key_len)) {
+            throw std::invalid_argument("Invalid public key for " + kem_name);
+        }
+    }
+
+    // Encapsulate to a copy of a key loaded elsewhere, such as a registry entry, which
+    // skips decoding it and expanding its matrix again
+    explicit NativeEncapsReservoir(const kyber::mlkem::EncapsulationKey &key)
+        : params_(*key.params), own_key_(std::make_unique<kyber::mlkem::EncapsulationKey>(key)), key_(own_key_.get()) {}
+
+    ~NativeEncapsReservoir() {
+        if (!spare_.empty()) {
+            OQS_MEM_cleanse(spare_.data(), spare_.size());
+        }
+    }
+
+    void next(uint8_t shared_secret[kyber::mlkem::shared_secret_bytes]) {
+        constexpr size_t len = kyber::mlkem::shared_secret_bytes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!spare_.empty()) {
+                std::memcpy(shared_secret, spare_.data() + spare_.size() - len, len);
+                OQS_MEM_cleanse(spare_.data() + spare_.size() - len, len);
+                spare_.resize(spare_.size() - len);
+                return;
+            }
+        }
+        uint8_t fresh[batch * len];
+        native_encaps_to_key(*key_, params_, batch, fresh);
+        std::memcpy(shared_secret, fresh, len);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            spare_.insert(spare_.end(), fresh + len, fresh + sizeof(fresh));
+        }
+        OQS_MEM_cleanse(fresh, sizeof(fresh));
+    }
+
+private:
+    const kyber::Params &params_;
+    std::unique_ptr<kyber::mlkem::EncapsulationKey> own_key_;
+    const kyber::mlkem::EncapsulationKey *key_;
+    std::mutex mutex_;
+    std::vector<uint8_t> spare_;
+};
+
+// Function to build the /bulkEncrypt results from one shared secret per message
+crow::json::wvalue bulk_encrypt_results(const crow::json::rvalue &messages, const std::vector<uint8_t> &shared_secrets) {
+    crow::json::wvalue results;
+    size_t idx = 0;
+    for (auto &msg : messages) {
+        const uint8_t *shared_secret = shared_secrets.data() + kyber::mlkem::shared_secret_bytes * idx;
+        results[idx++] = crow::json::wvalue({
+            {"ciphertext", xor_encrypt_blocks(shared_secret, msg.s())},
+            {"shared_secret", base64_encode(shared_secret, kyber::mlkem::shared_secret_bytes)}
+        });
+    }
+    return results;
+}
+
+// Function to undo xor_encrypt_blocks given the Base64 shared secret
+std::string xor_decrypt_blocks(const std::string &shared_secret_base64, const std::string &ciphertext_combined) {
+    std::string shared_secret_str = base64_decode(shared_secret_base64);
+    uint8_t *shared_secret = new uint8_t[shared_secret_str.size()];
+    std::memcpy(shared_secret, shared_secret_str.data(), shared_secret_str.size());
+
+    std::vector<std::string> encrypted_blocks;
+    size_t pos = 0, next;
+    while ((next = ciphertext_combined.find("::", pos)) != std::string::npos) {
+        encrypted_blocks.push_back(ciphertext_combined.substr(pos, next - pos));
+        pos = next + 2;
+    }
+    encrypted_blocks.push_back(ciphertext_combined.substr(pos));
+
+    std::string original_message = "";
+
+    for (const auto& encoded_block : encrypted_blocks) {
+        std::string decoded = base64_decode(encoded_block);
+        size_t block_size = decoded.size();
+        uint8_t *xor_encrypted = new uint8_t[block_size];
+        std::memcpy(xor_encrypted, decoded.data(), block_size);
+
+        uint8_t *decrypted_block = new uint8_t[block_size];
+        xor_cipher(shared_secret, std::string((char*)xor_encrypted, block_size), decrypted_block);
+        original_message += std::string(reinterpret_cast<char *>(decrypted_block), block_size);
+
+        delete[] xor_encrypted;
+        delete[] decrypted_block;
+    }
+
+    delete[] shared_secret;
+    return original_message;
+}
+
+// Function to read the parameter line of an NDJSON bulk request. options gets the output
+// order ("ordered", true by default).
+crow::json::rvalue ndjson_params(std::string_view line, ndjson::Options &options) {
+    auto params = crow::json::load(line.data(), line.size());
+    if (!params || params.t() != crow::json::type::Object) {
+        throw std::invalid_argument("The first NDJSON line must be a JSON object with the request parameters");
+    }
+    options.ordered = !params.has("ordered") || params["ordered"].b();
+    return params;
+}
+
+// Function to parse one NDJSON item line, which must be an object with the given field
+crow::json::rvalue ndjson_item(std::string_view line, const char *field) {
+    auto item = crow::json::load(line.data(), line.size());
+    if (!item || item.t() != crow::json::type::Object || !item.has(field)) {
+        throw std::invalid_argument(std::string("Each item must be an object with ") + field);
+    }
+    return item;
+}
+
+crow::response ndjson_response(std::string body) {
+    crow::response res(200, std::move(body));
+    res.set_header("Content-Type", ndjson::content_type);
+    return res;
+}
+
+// Thrown by an NDJSON opener for a key_id that is not registered
+struct UnknownKeyId : std::runtime_error {
+    UnknownKeyId() : std::runtime_error("Unknown key_id") {}
+};
+
+// Function to turn the error of an NDJSON request that could not start into its response
+crow::response ndjson_error_response(std::exception_ptr error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const UnknownKeyId &e) {
+        return crow::response(404, e.what());
+    } catch (const std::invalid_argument &e) {
+        return crow::response(400, e.what());
+    } catch (const std::exception &e) {
+        return crow::response(500, e.what());
+    }
+}
+
+// Function to answer an NDJSON bulk request from its whole body, for the requests the
+// body streams below do not take (HTTP/1.0)
+crow::response ndjson_buffered(const crow::request &req, const ndjson::Opener &open) {
+    try {
+        return ndjson_response(ndjson::transform(req.body, ndjson::Options(), open));
+    } catch (...) {
+        return ndjson_error_response(std::current_exception());
+    }
+}
+
+// An NDJSON bulk request taken from Crow as its body arrives. Items run as their lines
+// come in and their output goes back in a chunked response as it is ready; a request
+// whose parameter line is rejected gets the usual error response once its body is read.
+class NdjsonBodyStream : public crow::body_stream {
+public:
+    NdjsonBodyStream(const ndjson::Opener &open, std::shared_ptr<crow::stream_writer> out)
+        : out_(std::move(out)), stream_(ndjson::Options(), open, [this](std::string_view line) { write(line); }) {}
+
+    void on_data(const char *data, size_t size) override {
+        stream_.feed(std::string_view(data, size));
+    }
+
+    void on_end() override {
+        stream_.finish([this](std::exception_ptr error) {
+            if (error) {
+                out_->send(ndjson_error_response(error));
+                return;
+            }
+            if (!started_) {
+                out_->begin(ndjson_response(""));
+            }
+            out_->end();
+        });
+    }
+
+private:
+    // Called by the stream one line at a time
+    void write(std::string_view line) {
+        if (!started_) {
+            started_ = true;
+            out_->begin(ndjson_response(""));
+        }
+        std::string out;
+        out.reserve(line.size() + 1);
+        out.append(line);
+        out += '\n';
+        out_->write(out);
+    }
+
+    std::shared_ptr<crow::stream_writer> out_;
+    bool started_ = false;
+    ndjson::Stream stream_;  // Destroyed first: it waits for the items that write to out_
+};
+
+// Function to look up a registered key that can be used for the requested operation
+KeyRef find_registered_key(const KeyRegistry &registry, const std::string &key_id, KeyKind kind, bool needs_secret_key) {
+    KeyRef key = registry.find(key_id);
+    if (!key || key->kind != kind || (needs_secret_key && !key->has_secret_key())) {
+        return KeyRef();
+    }
+    return key;
+}
+
+// KEM context and key bytes for a bulk request, from a registered key or given inline
+struct RequestKem {
+    KeyRef key;
+    std::unique_ptr<OQS_KEM, decltype(&OQS_KEM_free)> own_kem{nullptr, OQS_KEM_free};
+    std::string own_key;
+    const OQS_KEM *kem = nullptr;
+    const uint8_t *key_bytes = nullptr;
+
+    ~RequestKem() {
+        if (!own_key.empty()) {
+            OQS_MEM_cleanse(&own_key[0], own_key.size());
+        }
+    }
+
+    // Copy a registered key into own_kem and own_key and drop the KeyRef, for a request
+    // that outlives its handler (a streamed NDJSON request)
+    void detach() {
+        if (!key) {
+            return;
+        }
+        own_kem.reset(OQS_KEM_new(key->algorithm.c_str()));
+        if (!own_kem) {
+            throw std::runtime_error("Failed to initialize KEM");
+        }
+        const std::vector<uint8_t> &bytes = key_bytes == key->public_key.data() ? key->public_key : key->secret_key;
+        own_key.assign(bytes.begin(), bytes.end());
+        kem = own_kem.get();
+        key_bytes = reinterpret_cast<const uint8_t *>(own_key.data());
+        key = KeyRef();
+    }
+};
+
+// Function to set up the KEM of a bulk request: a registered key_id, or kem_name with the
+// Base64 key in key_field ("public_key" or "secret_key"). Returns false for an unknown
+// key_id and throws std::invalid_argument for a missing or malformed inline key.
+bool resolve_request_kem(const KeyRegistry &registry, const crow::json::rvalue &params, const char *key_field, RequestKem &out) {
+    bool needs_secret_key = std::strcmp(key_field, "secret_key") == 0;
+    if (params.has("key_id")) {
+        out.key = find_registered_key(registry, params["key_id"].s(), KeyKind::Kem, needs_secret_key);
+        if (!out.key || (!needs_secret_key && out.key->public_key.empty())) {
+            return false;
+        }
+        out.kem = out.key->kem;
+        out.key_bytes = needs_secret_key ? out.key->secret_key.data() : out.key->public_key.data();
+        return true;
+    }
+
+    if (!params.has("kem_name") || !params.has(key_field)) {
+        throw std::invalid_argument(std::string("kem_name and ") + key_field + " (or key_id) are required");
+    }
+    out.own_kem.reset(OQS_KEM_new(std::string(params["kem_name"].s()).c_str()));
+    if (!out.own_kem) {
+        throw std::invalid_argument("Failed to initialize KEM");
+    }
+    out.own_key = base64_decode(std::string(params[key_field].s()));
+    size_t expected = needs_secret_key ? out.own_kem->length_secret_key : out.own_kem->length_public_key;
+    if (out.own_key.size() != expected) {
+        throw std::invalid_argument(std::string("Invalid ") + key_field + " length");
+    }
+    out.kem = out.own_kem.get();
+    out.key_bytes = reinterpret_cast<const uint8_t *>(out.own_key.data());
+    return true;
+}
+
+// What the items of an NDJSON /bulkEncrypt share: the KEM and key, detached from the
+// registry, and the ML-KEM reservoir when the native engine takes the key
+struct NdjsonEncryptState {
+    RequestKem request_kem;
+    std::unique_ptr<NativeEncapsReservoir> reservoir;
+};
+
+// Function to view key bytes as the string_view the verification cache hashes
+std::string_view bytes_view(const std::vector<uint8_t> &bytes) {
+    return std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+// Function to decode an optional Base64 key field of a request
+std::vector<uint8_t> decode_key_field(const crow::json::rvalue &params, const char *field) {
+    if (!params.has(field)) {
+        return {};
+    }
+    std::string decoded = base64_decode(std::string(params[field].s()));
+    return std::vector<uint8_t>(decoded.begin(), decoded.end());
+}
+
+// Signature context and key bytes of a request, from a registered key or given inline
+struct RequestSig {
+    KeyRef key;
+    std::unique_ptr<OQS_SIG, decltype(&OQS_SIG_free)> own_sig{nullptr, OQS_SIG_free};
+    std::string own_key;
+    const OQS_SIG *sig = nullptr;
+    const uint8_t *key_bytes = nullptr;
+
+    ~RequestSig() {
+        if (!own_key.empty()) {
+            OQS_MEM_cleanse(&own_key[0], own_key.size());
+        }
+    }
+
+    // Copy a registered key into own_sig and own_key and drop the KeyRef, as RequestKem::detach
+    void detach() {
+        if (!key) {
+            return;
+        }
+        own_sig.reset(OQS_SIG_new(key->algorithm.c_str()));
+        if (!own_sig) {
+            throw std::runtime_error("Failed to initialize signature algorithm");
+        }
+        const std::vector<uint8_t> &bytes = key_bytes == key->public_key.data() ? key->public_key : key->secret_key;
+        own_key.assign(bytes.begin(), bytes.end());
+        sig = own_sig.get();
+        key_bytes = reinterpret_cast<const uint8_t *>(own_key.data());
+        key = KeyRef();
+    }
+};
+
+// Function to use a registered signature key; false when the key_id is unknown
+bool resolve_registered_sig(const KeyRegistry &registry, const std::string &key_id, bool needs_secret_key, RequestSig &out) {
+    out.key = find_registered_key(registry, key_id, KeyKind::Signature, needs_secret_key);
+    if (!out.key || (!needs_secret_key && out.key->public_key.empty())) {
         return false;
     }
+    out.sig = out.key->sig;
+    out.key_bytes = needs_secret_key ? out.key->secret_key.data() : out.key->public_key.data();
+    return true;
+}
 
-    OQS_KEM_free(kem);
+// Function to set up the signature algorithm of a request: a registered key_id, or
+// ml_dsa_variant with the Base64 key in key_field ("private_key" or "public_key").
+// Returns false for an unknown key_id and throws std::invalid_argument otherwise.
+bool resolve_request_sig(const KeyRegistry &registry, const crow::json::rvalue &params, const char *key_field, RequestSig &out) {
+    bool needs_secret_key = std::strcmp(key_field, "private_key") == 0;
+    if (params.has("key_id")) {
+        if (!resolve_registered_sig(registry, params["key_id"].s(), needs_secret_key, out)) {
+            return false;
+        }
+        if (params.has("ml_dsa_variant") && params["ml_dsa_variant"].s() != out.key->algorithm) {
+            throw std::invalid_argument("ml_dsa_variant does not match the key_id");
+        }
+        return true;
+    }
+
+    if (!params.has("ml_dsa_variant") || !params.has(key_field)) {
+        throw std::invalid_argument(std::string("ml_dsa_variant and ") + key_field + " (or key_id) are required");
+    }
+    out.own_sig.reset(OQS_SIG_new(std::string(params["ml_dsa_variant"].s()).c_str()));
+    if (!out.own_sig) {
+        throw std::invalid_argument("Invalid ML-DSA variant provided.");
+    }
+    out.own_key = base64_decode(std::string(params[key_field].s()));
+    size_t expected = needs_secret_key ? out.own_sig->length_secret_key : out.own_sig->length_public_key;
+    if (out.own_key.size() != expected) {
+        throw std::invalid_argument(std::string("Invalid ") + key_field + " length");
+    }
+    out.sig = out.own_sig.get();
+    out.key_bytes = reinterpret_cast<const uint8_t *>(out.own_key.data());
+    return true;
+}
+
+// Function to set up the signature algorithm of a binary RPC request: the registered key
+// whose key_id is in the key field, or the raw key of the request's algorithm. Returns
+// false for an unknown key_id and throws std::invalid_argument otherwise.
+bool resolve_rpc_sig(const KeyRegistry &registry, const rpc::Request &request, bool needs_secret_key, RequestSig &out) {
+    if (request.algorithm == rpc::Algorithm::Registered) {
+        return resolve_registered_sig(registry, request.key, needs_secret_key, out);
+    }
+    const char *name = rpc::algorithm_name(request.algorithm);
+    if (name == nullptr) {
+        throw std::invalid_argument("Unknown algorithm id");
+    }
+    out.own_sig.reset(OQS_SIG_new(name));
+    if (!out.own_sig) {
+        throw std::invalid_argument(std::string(name) + " is not enabled");
+    }
+    size_t expected = needs_secret_key ? out.own_sig->length_secret_key : out.own_sig->length_public_key;
+    if (request.key.size() != expected) {
+        throw std::invalid_argument("Invalid key length");
+    }
+    out.sig = out.own_sig.get();
+    out.key_bytes = reinterpret_cast<const uint8_t *>(request.key.data());
     return true;
 }
 
+// Function to tell a raw message body (application/octet-stream) from a JSON one
+bool is_raw_body(const crow::request &req) {
+    static const char raw_type[] = "application/octet-stream";
+    return req.get_header_value("Content-Type").compare(0, sizeof(raw_type) - 1, raw_type) == 0;
+}
+
+// Function to get the SHAKE256 digest of a pre-hash request: the client's "digest", or
+// the server's hash of "message". Throws std::invalid_argument when neither is usable.
+void request_digest(const crow::json::rvalue &params, uint8_t digest[prehash::digest_length]) {
+    if (params.has("digest")) {
+        std::string decoded = base64_decode(std::string(params["digest"].s()));
+        if (decoded.size() != prehash::digest_length) {
+            throw std::invalid_argument("digest must be the 64-byte SHAKE256 of the message");
+        }
+        std::memcpy(digest, decoded.data(), prehash::digest_length);
+    } else if (params.has("message")) {
+        std::string message = params["message"].s();
+        prehash::digest(reinterpret_cast<const uint8_t *>(message.data()), message.size(), digest);
+    } else {
+        throw std::invalid_argument("message or digest is required");
+    }
+}
+
+// Function to read the "policy" object with which a key generation request lets the
+// server choose the algorithm. Throws std::invalid_argument for a malformed policy.
+SelectionPolicy parse_selection_policy(const crow::json::rvalue &params, KeyKind kind) {
+    if (params.t() != crow::json::type::Object) {
+        throw std::invalid_argument("policy must be an object");
+    }
+    SelectionPolicy policy;
+    policy.kind = kind;
+    if (params.has("min_nist_level")) {
+        if (params["min_nist_level"].t() != crow::json::type::Number) {
+            throw std::invalid_argument("min_nist_level must be a number");
+        }
+        policy.min_nist_level = static_cast<int>(params["min_nist_level"].i());
+    }
+    if (params.has("optimize")) {
+        policy.optimize = parse_selection_goal(params["optimize"].s());
+    }
+    if (params.has("max_latency_us")) {
+        if (params["max_latency_us"].t() != crow::json::type::Number || params["max_latency_us"].d() <= 0) {
+            throw std::invalid_argument("max_latency_us must be a positive number");
+        }
+        policy.max_latency_us = params["max_latency_us"].d();
+    }
+    return policy;
+}
+
+// Function to describe an algorithm of the catalog for /algorithms
+crow::json::wvalue algorithm_json(const AlgorithmInfo &info) {
+    crow::json::wvalue entry({
+        {"name", info.name},
+        {"version", info.version},
+        {"nist_level", info.nist_level},
+        {info.kind == KeyKind::Kem ? "ind_cca" : "euf_cma", info.strong_security},
+        {"public_key_bytes", info.public_key_bytes},
+        {"secret_key_bytes", info.secret_key_bytes}
+    });
+    if (info.kind == KeyKind::Kem) {
+        entry["ciphertext_bytes"] = info.ciphertext_bytes;
+        entry["shared_secret_bytes"] = info.shared_secret_bytes;
+    } else {
+        entry["signature_bytes"] = info.signature_bytes;
+    }
+    for (const OperationTiming &op : info.operations) {
+        entry["operations"][op.name] = crow::json::wvalue({
+            {"ops_per_sec", op.ops_per_sec},
+            {"p50_us", op.p50_us},
+            {"samples", op.samples}
+        });
+    }
+    if (!info.error.empty()) {
+        entry["error"] = info.error;
+    }
+    return entry;
+}
+
 std::pair<uint8_t*, uint8_t*> generate_keys(const std::string &kem_name, size_t &public_key_len, size_t &secret_key_len) {
     OQS_KEM *kem = OQS_KEM_new(kem_name.c_str());
     if (!kem) {
@@ -163,25 +712,147 @@ std::pair<uint8_t*, uint8_t*> generate_keys(const std::string &kem_name, size_t
 int main() {
     crow::SimpleApp app;
 
+    // liboqs draws its randomness from a per-thread DRBG seeded by getrandom() unless
+    // RANDOMBYTES=system keeps its default source
+    const char *randombytes = std::getenv("RANDOMBYTES");
+    if (randombytes == nullptr || std::strcmp(randombytes, "system") != 0) {
+        drbg::install();
+    }
+
+    // Registered keys survive restarts when KEY_STORE_PATH names a directory for the persistent store
+    std::unique_ptr<KeyStore> key_store;
+    if (const char *key_store_path = std::getenv("KEY_STORE_PATH")) {
+        key_store.reset(new KeyStore(key_store_path));
+    }
+    KeyRegistry key_registry(key_store.get());
+    SessionTable sessions;
+    merkle::RootCache merkle_roots;
+
+    // Every enabled KEM and signature scheme is timed in the background at startup, spending
+    // ALGORITHMS_BENCH_MS (default 20) per operation; 0 only lists the algorithms
+    const char *bench_ms = std::getenv("ALGORITHMS_BENCH_MS");
+    AlgorithmCatalog algorithm_catalog(std::chrono::milliseconds(bench_ms ? std::atol(bench_ms) : 20));
+
+    // VERIFY_CACHE lists the routes ("verify", "bulkVerify", comma separated) whose successful
+    // verifications are remembered for VERIFY_CACHE_TTL seconds (default 300), holding at most
+    // VERIFY_CACHE_ENTRIES (default 65536)
+    const char *cache_ttl = std::getenv("VERIFY_CACHE_TTL");
+    const char *cache_entries = std::getenv("VERIFY_CACHE_ENTRIES");
+    VerifyCache verify_cache(std::chrono::seconds(cache_ttl ? std::atol(cache_ttl) : 300),
+                             cache_entries ? std::strtoul(cache_entries, nullptr, 10) : 65536);
+    if (const char *cache_routes = std::getenv("VERIFY_CACHE")) {
+        std::stringstream names(cache_routes);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            VerifyCache::Route route;
+            if (parse_verify_cache_route(name, route)) {
+                verify_cache.enable(route);
+            } else if (!name.empty()) {
+                std::cerr << "Ignoring unknown VERIFY_CACHE route " << name << std::endl;
+            }
+        }
+    }
+
+    // Register a key pair (generated here or supplied by the caller) and return its key_id
+    app.route_dynamic("/keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || (!params.has("kem_name") && !params.has("ml_dsa_variant"))) {
+            return crow::response(400, "kem_name or ml_dsa_variant is required");
+        }
+
+        KeyKind kind = params.has("kem_name") ? KeyKind::Kem : KeyKind::Signature;
+        std::string algorithm = kind == KeyKind::Kem ? params["kem_name"].s() : params["ml_dsa_variant"].s();
+
+        try {
+            KeyRef key;
+            std::vector<uint8_t> public_key = decode_key_field(params, "public_key");
+            std::vector<uint8_t> secret_key = decode_key_field(params, kind == KeyKind::Kem ? "secret_key" : "private_key");
+            if (public_key.empty() && secret_key.empty()) {
+                key = key_registry.generate(kind, algorithm);
+            } else {
+                key = key_registry.add(kind, algorithm, std::move(public_key), std::move(secret_key));
+            }
+
+            crow::json::wvalue response({
+                {"key_id", key->id},
+                {"type", key_kind_name(key->kind)},
+                {"algorithm", key->algorithm},
+                {"persistent", key->persistent}
+            });
+            if (!key->public_key.empty()) {
+                response["public_key"] = base64_encode(key->public_key.data(), key->public_key.size());
+            }
+            return crow::response(201, response);
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/keys/<string>").methods(crow::HTTPMethod::GET)([&](const crow::request &, std::string key_id) -> crow::response {
+        auto key = key_registry.find(key_id);
+        if (!key) {
+            return crow::response(404, "Unknown key_id");
+        }
+
+        crow::json::wvalue response({
+            {"key_id", key->id},
+            {"type", key_kind_name(key->kind)},
+            {"algorithm", key->algorithm},
+            {"has_secret_key", key->has_secret_key()}
+        });
+        if (!key->public_key.empty()) {
+            response["public_key"] = base64_encode(key->public_key.data(), key->public_key.size());
+        }
+        return crow::response(response);
+    });
+
+    app.route_dynamic("/keys/<string>").methods(crow::HTTPMethod::DELETE)([&](const crow::request &, std::string key_id) -> crow::response {
+        if (!key_registry.erase(key_id)) {
+            return crow::response(404, "Unknown key_id");
+        }
+        return crow::response(204);
+    });
+
     // Define the route to generate ML-DSA keys
     app.route_dynamic("/generate_ml_dsa_keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
         // Extract the ml_dsa_variant from the request body
         auto params = crow::json::load(req.body);
-        if (!params.has("ml_dsa_variant")) {
-            return crow::response(400, "ml_dsa_variant is required");
+        if (!params || (!params.has("ml_dsa_variant") && !params.has("policy"))) {
+            return crow::response(400, "ml_dsa_variant or policy is required");
         }
 
-        std::string ml_dsa_variant = params["ml_dsa_variant"].s();
-        
         try {
+            // Without an explicit variant, the policy picks the ML-DSA parameter set from the timings of this host
+            std::string ml_dsa_variant;
+            if (params.has("ml_dsa_variant")) {
+                ml_dsa_variant = params["ml_dsa_variant"].s();
+            } else {
+                SelectionPolicy policy = parse_selection_policy(params["policy"], KeyKind::Signature);
+                policy.name_prefix = "ML-DSA-";
+                auto snapshot = algorithm_catalog.snapshot();
+                if (policy.needs_timings() && !snapshot->benchmarked && algorithm_catalog.measuring()) {
+                    return crow::response(503, "Algorithm timings are still being measured");
+                }
+                const AlgorithmInfo *choice = select_algorithm(*snapshot, policy);
+                if (!choice) {
+                    return crow::response(400, "No enabled algorithm satisfies the policy");
+                }
+                ml_dsa_variant = choice->name;
+            }
+
             // Generate keys using the provided variant (e.g., ML-DSA-44)
             auto [public_key, private_key] = generate_ml_dsa_keys(ml_dsa_variant);
 
             // Return the keys as a JSON response
             return crow::response(crow::json::wvalue({
+                {"ml_dsa_variant", ml_dsa_variant},
                 {"public_key", public_key},
                 {"private_key", private_key}
             }));
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
         } catch (const std::exception &e) {
             // If there was an error, return a 500 status code with the error message
             return crow::response(500, e.what());
@@ -191,8 +862,27 @@ int main() {
     app.route_dynamic("/sign").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
         auto params = crow::json::load(req.body);
 
+        if (params.has("message") && params.has("key_id")) {
+            auto key = find_registered_key(key_registry, params["key_id"].s(), KeyKind::Signature, true);
+            if (!key) {
+                return crow::response(404, "Unknown key_id");
+            }
+            if (params.has("ml_dsa_variant") && params["ml_dsa_variant"].s() != key->algorithm) {
+                return crow::response(400, "ml_dsa_variant does not match the key_id");
+            }
+
+            try {
+                std::string signature_base64 = sign_message_with_sig(key->sig, params["message"].s(), key->secret_key.data());
+                return crow::response(crow::json::wvalue({
+                    {"signature", signature_base64}
+                }));
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
         if (!params.has("message") || !params.has("private_key") || !params.has("ml_dsa_variant")) {
-            return crow::response(400, "Message, private_key, and ml_dsa_variant are required");
+            return crow::response(400, "Message, private_key (or key_id), and ml_dsa_variant are required");
         }
 
         std::string message = params["message"].s();
@@ -221,8 +911,34 @@ int main() {
     app.route_dynamic("/verify").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
         auto params = crow::json::load(req.body);
 
+        if (params.has("message") && params.has("signature") && params.has("key_id")) {
+            auto key = find_registered_key(key_registry, params["key_id"].s(), KeyKind::Signature, false);
+            if (!key || key->public_key.empty()) {
+                return crow::response(404, "Unknown key_id");
+            }
+            if (params.has("ml_dsa_variant") && params["ml_dsa_variant"].s() != key->algorithm) {
+                return crow::response(400, "ml_dsa_variant does not match the key_id");
+            }
+
+            try {
+                std::string message = params["message"].s();
+                std::string signature_base64 = params["signature"].s();
+                bool verified = verify_cache.verify(VerifyCache::Route::Verify, key->algorithm, bytes_view(key->public_key), message, signature_base64, [&] {
+                    return verify_message_with_sig(key->sig, message, signature_base64, key->public_key.data());
+                });
+                if (verified) {
+                    return crow::response(crow::json::wvalue({
+                        {"status", "verified"}
+                    }));
+                }
+                return crow::response(400, "Signature verification failed");
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
         if (!params.has("message") || !params.has("signature") || !params.has("public_key") || !params.has("ml_dsa_variant")) {
-            return crow::response(400, "Message, signature, public_key, and ml_dsa_variant are required");
+            return crow::response(400, "Message, signature, public_key (or key_id), and ml_dsa_variant are required");
         }
 
         std::string message = params["message"].s();
@@ -237,7 +953,9 @@ int main() {
             std::memcpy(public_key, decoded_public_key.data(), decoded_public_key.size());
 
             // Verify the signature
-            bool verified = verify_message_with_mldsa(message, signature_base64, public_key, decoded_public_key.size(), ml_dsa_variant);
+            bool verified = verify_cache.verify(VerifyCache::Route::Verify, ml_dsa_variant, decoded_public_key, message, signature_base64, [&] {
+                return verify_message_with_mldsa(message, signature_base64, public_key, decoded_public_key.size(), ml_dsa_variant);
+            });
 
             delete[] public_key;
 
@@ -253,40 +971,164 @@ int main() {
         }
     });
 
-    app.route_dynamic("/generate_keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
-        auto params = crow::json::load(req.body);
-        if (!params.has("kem_name")) {
-          return crow::response(400, "kem_name is required");
-        }
-        std::string kem_name = params["kem_name"].s();
-        size_t public_key_len, secret_key_len;
+    // Pre-hashed signing: only the SHAKE256 digest of the message is signed. The message
+    // can be a raw application/octet-stream body (key_id in the query string), which skips
+    // the JSON string and its copies, or the client can hash it and send just "digest".
+    app.route_dynamic("/sign/prehash").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
         try {
-            auto [public_key, secret_key] = generate_keys(kem_name, public_key_len, secret_key_len);
-            std::string public_key_base64 = base64_encode(public_key, public_key_len);
-            std::string shared_secret_base64 = base64_encode(secret_key, secret_key_len);
-            delete[] public_key;
-            delete[] secret_key;
+            RequestSig request_sig;
+            uint8_t digest[prehash::digest_length];
+            if (is_raw_body(req)) {
+                const char *key_id = req.url_params.get("key_id");
+                if (!key_id) {
+                    return crow::response(400, "key_id query parameter is required with a raw body");
+                }
+                if (!resolve_registered_sig(key_registry, key_id, true, request_sig)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                prehash::digest(reinterpret_cast<const uint8_t *>(req.body.data()), req.body.size(), digest);
+            } else {
+                auto params = crow::json::load(req.body);
+                if (!params) {
+                    return crow::response(400, "Invalid JSON");
+                }
+                if (!resolve_request_sig(key_registry, params, "private_key", request_sig)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                request_digest(params, digest);
+            }
+
+            std::vector<uint8_t> signature = prehash::sign(request_sig.sig, digest, request_sig.key_bytes);
             return crow::response(crow::json::wvalue({
-                {"public_key", public_key_base64},
-                {"secret_key", shared_secret_base64}
+                {"signature", base64_encode(signature.data(), signature.size())},
+                {"digest", base64_encode(digest, sizeof(digest))}
             }));
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
         } catch (const std::exception &e) {
             return crow::response(500, e.what());
         }
     });
 
-    app.route_dynamic("/encrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
-        auto params = crow::json::load(req.body);
-    
-        if (!params.has("kem_name") || !params.has("message") || !params.has("public_key")) {
-            return crow::response(400, "kem_name, message, and public_key are required");
-        }
-    
-        std::string kem_name = params["kem_name"].s();
-        std::string message = params["message"].s();
-        std::string public_key_base64 = params["public_key"].s();
-    
-        size_t public_key_len = 0, ciphertext_len = 0, shared_secret_len = 0;
+    // Verification of /sign/prehash signatures; with a raw body the Base64 signature goes
+    // in the X-Signature header
+    app.route_dynamic("/verify/prehash").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        try {
+            RequestSig request_sig;
+            uint8_t digest[prehash::digest_length];
+            std::string signature;
+            if (is_raw_body(req)) {
+                const char *key_id = req.url_params.get("key_id");
+                signature = req.get_header_value("X-Signature");
+                if (!key_id || signature.empty()) {
+                    return crow::response(400, "key_id query parameter and X-Signature header are required with a raw body");
+                }
+                if (!resolve_registered_sig(key_registry, key_id, false, request_sig)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                prehash::digest(reinterpret_cast<const uint8_t *>(req.body.data()), req.body.size(), digest);
+            } else {
+                auto params = crow::json::load(req.body);
+                if (!params || !params.has("signature")) {
+                    return crow::response(400, "signature is required");
+                }
+                if (!resolve_request_sig(key_registry, params, "public_key", request_sig)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                request_digest(params, digest);
+                signature = params["signature"].s();
+            }
+
+            std::string decoded_signature = base64_decode(signature);
+            if (prehash::verify(request_sig.sig, digest, reinterpret_cast<const uint8_t *>(decoded_signature.data()),
+                                decoded_signature.size(), request_sig.key_bytes)) {
+                return crow::response(crow::json::wvalue({
+                    {"status", "verified"}
+                }));
+            }
+            return crow::response(400, "Signature verification failed");
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/generate_keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || (!params.has("kem_name") && !params.has("policy"))) {
+          return crow::response(400, "kem_name or policy is required");
+        }
+        size_t public_key_len, secret_key_len;
+        try {
+            // Without an explicit kem_name, the policy picks the KEM from the timings of this host
+            std::string kem_name;
+            if (params.has("kem_name")) {
+                kem_name = params["kem_name"].s();
+            } else {
+                SelectionPolicy policy = parse_selection_policy(params["policy"], KeyKind::Kem);
+                auto snapshot = algorithm_catalog.snapshot();
+                if (policy.needs_timings() && !snapshot->benchmarked && algorithm_catalog.measuring()) {
+                    return crow::response(503, "Algorithm timings are still being measured");
+                }
+                const AlgorithmInfo *choice = select_algorithm(*snapshot, policy);
+                if (!choice) {
+                    return crow::response(400, "No enabled algorithm satisfies the policy");
+                }
+                kem_name = choice->name;
+            }
+
+            auto [public_key, secret_key] = generate_keys(kem_name, public_key_len, secret_key_len);
+            std::string public_key_base64 = base64_encode(public_key, public_key_len);
+            std::string shared_secret_base64 = base64_encode(secret_key, secret_key_len);
+            delete[] public_key;
+            delete[] secret_key;
+            return crow::response(crow::json::wvalue({
+                {"kem_name", kem_name},
+                {"public_key", public_key_base64},
+                {"secret_key", shared_secret_base64}
+            }));
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/encrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+
+        if (params.has("message") && params.has("key_id")) {
+            auto key = find_registered_key(key_registry, params["key_id"].s(), KeyKind::Kem, false);
+            if (!key || key->public_key.empty()) {
+                return crow::response(404, "Unknown key_id");
+            }
+            if (params.has("kem_name") && params["kem_name"].s() != key->algorithm) {
+                return crow::response(400, "kem_name does not match the key_id");
+            }
+
+            std::string message = params["message"].s();
+            std::vector<uint8_t> ciphertext(key->kem->length_ciphertext);
+            std::vector<uint8_t> shared_secret(key->kem->length_shared_secret);
+            if (!encrypt_message_with_kem(key->kem, key->public_key.data(), ciphertext.data(), shared_secret.data())) {
+                return crow::response(500, "Encryption failed");
+            }
+
+            return crow::response(crow::json::wvalue({
+                {"ciphertext", xor_encrypt_blocks(shared_secret.data(), message)},
+                {"shared_secret", base64_encode(shared_secret.data(), shared_secret.size())}
+            }));
+        }
+    
+        if (!params.has("kem_name") || !params.has("message") || !params.has("public_key")) {
+            return crow::response(400, "kem_name, message, and public_key (or key_id) are required");
+        }
+    
+        std::string kem_name = params["kem_name"].s();
+        std::string message = params["message"].s();
+        std::string public_key_base64 = params["public_key"].s();
+    
+        size_t public_key_len = 0, ciphertext_len = 0, shared_secret_len = 0;
         uint8_t *ciphertext = nullptr, *shared_secret = nullptr;
     
         try {
@@ -307,24 +1149,8 @@ int main() {
                 throw std::runtime_error("Encryption failed");
             }
     
-            size_t block_size = 32;
-            std::vector<std::string> encrypted_blocks;
-    
-            for (size_t i = 0; i < message.size(); i += block_size) {
-                std::string block = message.substr(i, block_size);
-                uint8_t *xor_encrypted_block = new uint8_t[block.size()];
-                xor_cipher(shared_secret, block, xor_encrypted_block);
-                std::string encoded = base64_encode(xor_encrypted_block, block.size());
-                encrypted_blocks.push_back(encoded);
-                delete[] xor_encrypted_block;
-            }
-    
             // 🔗 Concatenar bloques con delimitador "::"
-            std::string xor_encrypted_base64 = "";
-            for (size_t i = 0; i < encrypted_blocks.size(); ++i) {
-                xor_encrypted_base64 += encrypted_blocks[i];
-                if (i != encrypted_blocks.size() - 1) xor_encrypted_base64 += "::";
-            }
+            std::string xor_encrypted_base64 = xor_encrypt_blocks(shared_secret, message);
     
             std::string shared_secret_base64 = base64_encode(shared_secret, shared_secret_len);
     
@@ -395,10 +1221,112 @@ int main() {
         }
     });
 
+    // NDJSON /bulkSign: a line with key_id or private_key and ml_dsa_variant, then one {"message"} per line
+    ndjson::Opener bulk_sign_ndjson = [&](std::string_view line, ndjson::Options &options) -> ndjson::ItemHandler {
+        auto params = ndjson_params(line, options);
+        auto request_sig = std::make_shared<RequestSig>();
+        if (params.has("key_id")) {
+            if (!resolve_registered_sig(key_registry, params["key_id"].s(), true, *request_sig)) {
+                throw UnknownKeyId();
+            }
+            request_sig->detach();
+        } else {
+            if (!params.has("private_key") || !params.has("ml_dsa_variant")) {
+                throw std::invalid_argument("private_key (or key_id) and ml_dsa_variant are required");
+            }
+            std::string ml_dsa_variant = params["ml_dsa_variant"].s();
+            if (ml_dsa_variant.compare(0, 7, "ML-DSA-") == 0) {
+                request_sig->own_sig.reset(OQS_SIG_new(ml_dsa_variant.c_str()));
+            }
+            if (!request_sig->own_sig) {
+                throw std::invalid_argument("Invalid ML-DSA variant provided.");
+            }
+            request_sig->own_key = base64_decode(std::string(params["private_key"].s()));
+            if (request_sig->own_key.size() != request_sig->own_sig->length_secret_key) {
+                throw std::invalid_argument("Invalid private key length");
+            }
+            request_sig->sig = request_sig->own_sig.get();
+            request_sig->key_bytes = reinterpret_cast<const uint8_t *>(request_sig->own_key.data());
+        }
+
+        return [request_sig](size_t index, std::string_view line) {
+            auto item = ndjson_item(line, "message");
+            return crow::json::wvalue({
+                {"index", index},
+                {"signature", sign_message_with_sig(request_sig->sig, item["message"].s(), request_sig->key_bytes)}
+            }).dump();
+        };
+    };
+
     app.route_dynamic("/bulkSign").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        // NDJSON from HTTP/1.0 clients; HTTP/1.1 requests are streamed (see ndjson_routes)
+        if (ndjson::is_ndjson(req.get_header_value("Content-Type"))) {
+            return ndjson_buffered(req, bulk_sign_ndjson);
+        }
+
         auto params = crow::json::load(req.body);
+
+        // Merkle batch: one signature over the root of a SHA3-256 tree of the messages and
+        // an inclusion proof per message, instead of one signature per message
+        if (params && params.has("merkle") && params["merkle"].b()) {
+            if (!params.has("messages")) {
+                return crow::response(400, "messages field is required");
+            }
+            try {
+                RequestSig request_sig;
+                if (!resolve_request_sig(key_registry, params, "private_key", request_sig)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                std::vector<std::string_view> messages;
+                for (auto &msg : params["messages"]) {
+                    auto text = msg.s();
+                    messages.emplace_back(text.begin(), text.size());
+                }
+                merkle::Tree tree(messages);
+                std::vector<uint8_t> signature = merkle::sign_root(request_sig.sig, tree.root(), tree.size(), request_sig.key_bytes);
+
+                crow::json::wvalue proofs(crow::json::wvalue::list{});
+                for (size_t idx = 0; idx < tree.size(); idx++) {
+                    proofs[idx] = base64_encode(tree.proof(idx));
+                }
+                crow::json::wvalue response;
+                response["root"] = base64_encode(tree.root().data(), tree.root().size());
+                response["leaf_count"] = tree.size();
+                response["root_signature"] = base64_encode(signature.data(), signature.size());
+                response["proofs"] = std::move(proofs);
+                return crow::response(response);
+            } catch (const std::invalid_argument &e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
+        if (params.has("messages") && params.has("key_id")) {
+            auto key = find_registered_key(key_registry, params["key_id"].s(), KeyKind::Signature, true);
+            if (!key) {
+                return crow::response(404, "Unknown key_id");
+            }
+            if (params.has("ml_dsa_variant") && params["ml_dsa_variant"].s() != key->algorithm) {
+                return crow::response(400, "ml_dsa_variant does not match the key_id");
+            }
+
+            try {
+                crow::json::wvalue response;
+                crow::json::wvalue signatures(crow::json::wvalue::list{});
+                size_t idx = 0;
+                for (auto& msg : params["messages"]) {
+                    signatures[idx++] = sign_message_with_sig(key->sig, msg.s(), key->secret_key.data());
+                }
+                response["signatures"] = std::move(signatures);
+                return crow::response(response);
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
         if (!params.has("messages") || !params.has("private_key") || !params.has("ml_dsa_variant")) {
-            return crow::response(400, "messages, private_key, and ml_dsa_variant are required");
+            return crow::response(400, "messages, private_key (or key_id), and ml_dsa_variant are required");
         }
     
         std::string private_key_base64 = params["private_key"].s();
@@ -428,7 +1356,41 @@ int main() {
         }
     });
 
+    // NDJSON /bulkVerify: a parameter line (may be {}), then one item per line as in "messages"
+    ndjson::Opener bulk_verify_ndjson = [&](std::string_view line, ndjson::Options &options) -> ndjson::ItemHandler {
+        ndjson_params(line, options);
+        return [&](size_t index, std::string_view line) {
+            auto m = ndjson_item(line, "signature");
+            std::string message = m["message"].s();
+            std::string signature_base64 = m["signature"].s();
+            bool verified;
+            if (m.has("key_id")) {
+                auto key = find_registered_key(key_registry, m["key_id"].s(), KeyKind::Signature, false);
+                verified = key && !key->public_key.empty() &&
+                           verify_cache.verify(VerifyCache::Route::BulkVerify, key->algorithm, bytes_view(key->public_key), message, signature_base64, [&] {
+                               return verify_message_with_sig(key->sig, message, signature_base64, key->public_key.data());
+                           });
+            } else {
+                std::string public_key = base64_decode(std::string(m["public_key"].s()));
+                std::string ml_dsa_variant = m["ml_dsa_variant"].s();
+                verified = verify_cache.verify(VerifyCache::Route::BulkVerify, ml_dsa_variant, public_key, message, signature_base64, [&] {
+                    return verify_message_with_mldsa(message, signature_base64, reinterpret_cast<uint8_t *>(&public_key[0]),
+                                                     public_key.size(), ml_dsa_variant);
+                });
+            }
+            return crow::json::wvalue({
+                {"index", index},
+                {"verified", verified}
+            }).dump();
+        };
+    };
+
     app.route_dynamic("/bulkVerify").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        // NDJSON from HTTP/1.0 clients; HTTP/1.1 requests are streamed (see ndjson_routes)
+        if (ndjson::is_ndjson(req.get_header_value("Content-Type"))) {
+            return ndjson_buffered(req, bulk_verify_ndjson);
+        }
+
         auto params = crow::json::load(req.body);
         if (!params.has("messages")) {
             return crow::response(400, "messages field is required");
@@ -443,6 +1405,17 @@ int main() {
             for (auto& m : messages) {
                 std::string message = m["message"].s();
                 std::string signature_base64 = m["signature"].s();
+
+                if (m.has("key_id")) {
+                    auto key = find_registered_key(key_registry, m["key_id"].s(), KeyKind::Signature, false);
+                    bool verified = key && !key->public_key.empty() &&
+                                    verify_cache.verify(VerifyCache::Route::BulkVerify, key->algorithm, bytes_view(key->public_key), message, signature_base64, [&] {
+                                        return verify_message_with_sig(key->sig, message, signature_base64, key->public_key.data());
+                                    });
+                    results[idx++] = crow::json::wvalue({{"verified", verified}});
+                    continue;
+                }
+
                 std::string public_key_base64 = m["public_key"].s();
                 std::string ml_dsa_variant = m["ml_dsa_variant"].s();
     
@@ -450,7 +1423,9 @@ int main() {
                 uint8_t *public_key = new uint8_t[decoded_public_key.size()];
                 std::memcpy(public_key, decoded_public_key.data(), decoded_public_key.size());
     
-                bool verified = verify_message_with_mldsa(message, signature_base64, public_key, decoded_public_key.size(), ml_dsa_variant);
+                bool verified = verify_cache.verify(VerifyCache::Route::BulkVerify, ml_dsa_variant, decoded_public_key, message, signature_base64, [&] {
+                    return verify_message_with_mldsa(message, signature_base64, public_key, decoded_public_key.size(), ml_dsa_variant);
+                });
     
                 delete[] public_key;
     
@@ -468,10 +1443,192 @@ int main() {
     });
     
     
+    // Check one message of a Merkle batch from /bulkSign: its inclusion proof gives the
+    // root, and the root signature is verified once per root while it stays cached
+    app.route_dynamic("/verify/merkle").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || !params.has("message") || !params.has("index") || !params.has("leaf_count") ||
+            !params.has("proof") || !params.has("root_signature")) {
+            return crow::response(400, "message, index, leaf_count, proof and root_signature are required");
+        }
+
+        try {
+            RequestSig request_sig;
+            if (!resolve_request_sig(key_registry, params, "public_key", request_sig)) {
+                return crow::response(404, "Unknown key_id");
+            }
+            int64_t index = params["index"].i();
+            int64_t leaf_count = params["leaf_count"].i();
+            if (index < 0 || leaf_count <= 0) {
+                return crow::response(400, "index and leaf_count must be non-negative and leaf_count positive");
+            }
+
+            std::string message = params["message"].s();
+            merkle::Hash root;
+            if (!merkle::root_from_proof(merkle::leaf_hash(reinterpret_cast<const uint8_t *>(message.data()), message.size()),
+                                         uint64_t(index), uint64_t(leaf_count), base64_decode(std::string(params["proof"].s())), root)) {
+                return crow::response(400, "Inclusion proof verification failed");
+            }
+
+            std::string signature = base64_decode(std::string(params["root_signature"].s()));
+            std::string_view public_key(reinterpret_cast<const char *>(request_sig.key_bytes), request_sig.sig->length_public_key);
+            std::string algorithm = request_sig.sig->method_name;
+            bool cached = merkle_roots.contains(algorithm, public_key, root, uint64_t(leaf_count), signature);
+            if (!cached) {
+                if (!merkle::verify_root(request_sig.sig, root, uint64_t(leaf_count), signature, public_key)) {
+                    return crow::response(400, "Signature verification failed");
+                }
+                merkle_roots.insert(algorithm, public_key, root, uint64_t(leaf_count), signature);
+            }
+            return crow::response(crow::json::wvalue({
+                {"status", "verified"},
+                {"root_cached", cached}
+            }));
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    // NDJSON /bulkEncrypt: a line with key_id or kem_name and public_key, then one {"message"} per line
+    ndjson::Opener bulk_encrypt_ndjson = [&](std::string_view line, ndjson::Options &options) -> ndjson::ItemHandler {
+        auto params = ndjson_params(line, options);
+        auto state = std::make_shared<NdjsonEncryptState>();
+        if (!resolve_request_kem(key_registry, params, "public_key", state->request_kem)) {
+            throw UnknownKeyId();
+        }
+        RequestKem &request_kem = state->request_kem;
+
+        // ML-KEM keys are loaded once (registered ones at registration) and
+        // encapsulated to four at a time
+        if (request_kem.key && request_kem.key->mlkem_key) {
+            state->reservoir.reset(new NativeEncapsReservoir(*request_kem.key->mlkem_key));
+        } else if (const kyber::Params *kyber_params = kyber::mlkem::params_by_name(request_kem.kem->method_name)) {
+            state->reservoir.reset(new NativeEncapsReservoir(request_kem.kem->method_name, *kyber_params, request_kem.key_bytes,
+                                                             request_kem.kem->length_public_key));
+        }
+        request_kem.detach();
+
+        return [state](size_t index, std::string_view line) {
+            auto item = ndjson_item(line, "message");
+            const OQS_KEM *kem = state->request_kem.kem;
+            std::vector<uint8_t> shared_secret(kem->length_shared_secret);
+            if (state->reservoir) {
+                state->reservoir->next(shared_secret.data());
+            } else {
+                std::vector<uint8_t> ciphertext(kem->length_ciphertext);
+                if (!encrypt_message_with_kem(kem, state->request_kem.key_bytes, ciphertext.data(), shared_secret.data())) {
+                    throw std::runtime_error("Encapsulation failed");
+                }
+            }
+            std::string line_out = crow::json::wvalue({
+                {"index", index},
+                {"ciphertext", xor_encrypt_blocks(shared_secret.data(), item["message"].s())},
+                {"shared_secret", base64_encode(shared_secret.data(), shared_secret.size())}
+            }).dump();
+            OQS_MEM_cleanse(shared_secret.data(), shared_secret.size());
+            return line_out;
+        };
+    };
+
     app.route_dynamic("/bulkEncrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        // NDJSON from HTTP/1.0 clients; HTTP/1.1 requests are streamed (see ndjson_routes)
+        if (ndjson::is_ndjson(req.get_header_value("Content-Type"))) {
+            return ndjson_buffered(req, bulk_encrypt_ndjson);
+        }
+
         auto params = crow::json::load(req.body);
+
+        // One encapsulation for the whole batch; each message is sealed with AES-256-GCM under
+        // its own key derived from the shared secret and the message index
+        if (params && params.has("messages") && params.has("single_encapsulation") && params["single_encapsulation"].b()) {
+            try {
+                RequestKem request_kem;
+                if (!resolve_request_kem(key_registry, params, "public_key", request_kem)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                const OQS_KEM *kem = request_kem.kem;
+                std::vector<uint8_t> kem_ciphertext(kem->length_ciphertext), shared_secret(kem->length_shared_secret);
+                if (!encrypt_message_with_kem(kem, request_kem.key_bytes, kem_ciphertext.data(), shared_secret.data())) {
+                    return crow::response(500, "Encapsulation failed");
+                }
+                batch_aead::BatchKeys keys(shared_secret.data(), shared_secret.size());
+                OQS_MEM_cleanse(shared_secret.data(), shared_secret.size());
+
+                crow::json::wvalue results(crow::json::wvalue::list{});
+                size_t idx = 0;
+                for (auto &msg : params["messages"]) {
+                    std::string message = msg.s();
+                    std::vector<uint8_t> sealed = keys.seal(idx, reinterpret_cast<const uint8_t *>(message.data()), message.size());
+                    results[idx++] = crow::json::wvalue({
+                        {"ciphertext", base64_encode(sealed.data(), sealed.size())}
+                    });
+                }
+
+                crow::json::wvalue response;
+                response["kem_ciphertext"] = base64_encode(kem_ciphertext.data(), kem_ciphertext.size());
+                response["results"] = std::move(results);
+                return crow::response(response);
+            } catch (const std::invalid_argument &e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
+        if (params.has("messages") && params.has("key_id")) {
+            auto key = find_registered_key(key_registry, params["key_id"].s(), KeyKind::Kem, false);
+            if (!key || key->public_key.empty()) {
+                return crow::response(404, "Unknown key_id");
+            }
+            if (params.has("kem_name") && params["kem_name"].s() != key->algorithm) {
+                return crow::response(400, "kem_name does not match the key_id");
+            }
+
+            // ML-KEM keys go through the native engine, several encapsulations at a time,
+            // with the key decoded and its matrix expanded once at registration
+            try {
+                std::vector<uint8_t> shared_secrets;
+                if (key->mlkem_key && params["messages"].size() > 0) {
+                    shared_secrets.resize(kyber::mlkem::shared_secret_bytes * params["messages"].size());
+                    native_encaps_to_key(*key->mlkem_key, *key->mlkem_key->params, params["messages"].size(), shared_secrets.data());
+                } else {
+                    shared_secrets = native_mlkem_encaps_batch(
+                        key->algorithm, key->public_key.data(), key->public_key.size(), params["messages"].size());
+                }
+                if (!shared_secrets.empty()) {
+                    crow::json::wvalue response;
+                    response["results"] = bulk_encrypt_results(params["messages"], shared_secrets);
+                    return crow::response(response);
+                }
+            } catch (const std::invalid_argument &e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+
+            crow::json::wvalue results;
+            size_t idx = 0;
+            std::vector<uint8_t> ciphertext(key->kem->length_ciphertext);
+            std::vector<uint8_t> shared_secret(key->kem->length_shared_secret);
+            for (auto& msg : params["messages"]) {
+                if (!encrypt_message_with_kem(key->kem, key->public_key.data(), ciphertext.data(), shared_secret.data())) {
+                    continue;
+                }
+                results[idx++] = crow::json::wvalue({
+                    {"ciphertext", xor_encrypt_blocks(shared_secret.data(), msg.s())},
+                    {"shared_secret", base64_encode(shared_secret.data(), shared_secret.size())}
+                });
+            }
+
+            crow::json::wvalue response;
+            response["results"] = std::move(results);
+            return crow::response(response);
+        }
+
         if (!params.has("kem_name") || !params.has("messages") || !params.has("public_key")) {
-            return crow::response(400, "kem_name, messages, and public_key are required");
+            return crow::response(400, "kem_name, messages, and public_key (or key_id) are required");
         }
     
         std::string kem_name = params["kem_name"].s();
@@ -479,12 +1636,19 @@ int main() {
         std::string public_key_base64 = params["public_key"].s();
     
         try {
+            std::string native_public_key = base64_decode(public_key_base64);
+            std::vector<uint8_t> shared_secrets = native_mlkem_encaps_batch(
+                kem_name, reinterpret_cast<const uint8_t *>(native_public_key.data()), native_public_key.size(), messages.size());
+            if (!shared_secrets.empty()) {
+                crow::json::wvalue response;
+                response["results"] = bulk_encrypt_results(messages, shared_secrets);
+                return crow::response(response);
+            }
+
             OQS_KEM *kem = OQS_KEM_new(kem_name.c_str());
             if (!kem) throw std::runtime_error("Failed to initialize KEM");
     
-            std::string public_key_str = base64_decode(public_key_base64);
-            uint8_t *public_key = new uint8_t[public_key_str.size()];
-            std::memcpy(public_key, public_key_str.data(), public_key_str.size());
+            const uint8_t *public_key = reinterpret_cast<const uint8_t *>(native_public_key.data());
     
             crow::json::wvalue results;
             size_t idx = 0;
@@ -503,21 +1667,7 @@ int main() {
     
                 std::string shared_secret_base64 = base64_encode(shared_secret, shared_secret_len);
     
-                size_t block_size = 32;
-                std::vector<std::string> encrypted_blocks;
-                for (size_t i = 0; i < msg.s().size(); i += block_size) {
-                    std::string block = std::string(msg.s()).substr(i, block_size);
-                    uint8_t *xor_encrypted_block = new uint8_t[block.size()];
-                    xor_cipher(shared_secret, block, xor_encrypted_block);
-                    encrypted_blocks.push_back(base64_encode(xor_encrypted_block, block.size()));
-                    delete[] xor_encrypted_block;
-                }
-    
-                std::string xor_encrypted_base64 = "";
-                for (size_t i = 0; i < encrypted_blocks.size(); ++i) {
-                    xor_encrypted_base64 += encrypted_blocks[i];
-                    if (i != encrypted_blocks.size() - 1) xor_encrypted_base64 += "::";
-                }
+                std::string xor_encrypted_base64 = xor_encrypt_blocks(shared_secret, msg.s());
     
                 results[idx++] = crow::json::wvalue({
                     {"ciphertext", xor_encrypted_base64},
@@ -528,20 +1678,86 @@ int main() {
                 delete[] shared_secret;
             }
     
-            delete[] public_key;
             OQS_KEM_free(kem);
     
             crow::json::wvalue response;
             response["results"] = std::move(results);
     
             return crow::response(response);
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
         } catch (const std::exception &e) {
             return crow::response(500, e.what());
         }
     });
     
+    // NDJSON /bulkDecrypt: a parameter line, then one {"ciphertext", "shared_secret"} per line
+    ndjson::Opener bulk_decrypt_ndjson = [&](std::string_view line, ndjson::Options &options) -> ndjson::ItemHandler {
+        ndjson_params(line, options);
+        return [](size_t index, std::string_view line) {
+            auto m = ndjson_item(line, "ciphertext");
+            return crow::json::wvalue({
+                {"index", index},
+                {"original_message", xor_decrypt_blocks(m["shared_secret"].s(), m["ciphertext"].s())}
+            }).dump();
+        };
+    };
+
     app.route_dynamic("/bulkDecrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        // NDJSON from HTTP/1.0 clients; HTTP/1.1 requests are streamed (see ndjson_routes)
+        if (ndjson::is_ndjson(req.get_header_value("Content-Type"))) {
+            return ndjson_buffered(req, bulk_decrypt_ndjson);
+        }
+
         auto params = crow::json::load(req.body);
+
+        // Batch from a single-encapsulation /bulkEncrypt: decapsulate kem_ciphertext once and
+        // open each message with the key derived for its index
+        if (params && params.has("kem_ciphertext") && params.has("messages")) {
+            try {
+                RequestKem request_kem;
+                if (!resolve_request_kem(key_registry, params, "secret_key", request_kem)) {
+                    return crow::response(404, "Unknown key_id");
+                }
+                const OQS_KEM *kem = request_kem.kem;
+                std::string kem_ciphertext = base64_decode(std::string(params["kem_ciphertext"].s()));
+                if (kem_ciphertext.size() != kem->length_ciphertext) {
+                    return crow::response(400, "Invalid kem_ciphertext length");
+                }
+                std::vector<uint8_t> shared_secret(kem->length_shared_secret);
+                if (OQS_KEM_decaps(kem, shared_secret.data(), reinterpret_cast<const uint8_t *>(kem_ciphertext.data()),
+                                   request_kem.key_bytes) != OQS_SUCCESS) {
+                    return crow::response(500, "Decapsulation failed");
+                }
+                batch_aead::BatchKeys keys(shared_secret.data(), shared_secret.size());
+                OQS_MEM_cleanse(shared_secret.data(), shared_secret.size());
+
+                crow::json::wvalue results(crow::json::wvalue::list{});
+                size_t idx = 0;
+                for (auto &m : params["messages"]) {
+                    std::string sealed = base64_decode(std::string(m.s()));
+                    try {
+                        results[idx] = crow::json::wvalue({
+                            {"original_message", keys.open(idx, reinterpret_cast<const uint8_t *>(sealed.data()), sealed.size())}
+                        });
+                    } catch (const std::invalid_argument &) {
+                        results[idx] = crow::json::wvalue({
+                            {"original_message", "[error]"}
+                        });
+                    }
+                    idx++;
+                }
+
+                crow::json::wvalue response;
+                response["results"] = std::move(results);
+                return crow::response(response);
+            } catch (const std::invalid_argument &e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception &e) {
+                return crow::response(500, e.what());
+            }
+        }
+
         if (!params.has("kem_name") || !params.has("messages")) {
             return crow::response(400, "kem_name and messages are required");
         }
@@ -558,35 +1774,7 @@ int main() {
                 std::string shared_secret_base64 = m["shared_secret"].s();
     
                 try {
-                    std::string shared_secret_str = base64_decode(shared_secret_base64);
-                    uint8_t *shared_secret = new uint8_t[shared_secret_str.size()];
-                    std::memcpy(shared_secret, shared_secret_str.data(), shared_secret_str.size());
-    
-                    std::vector<std::string> encrypted_blocks;
-                    size_t pos = 0, next;
-                    while ((next = ciphertext_combined.find("::", pos)) != std::string::npos) {
-                        encrypted_blocks.push_back(ciphertext_combined.substr(pos, next - pos));
-                        pos = next + 2;
-                    }
-                    encrypted_blocks.push_back(ciphertext_combined.substr(pos));
-    
-                    std::string original_message = "";
-    
-                    for (const auto& encoded_block : encrypted_blocks) {
-                        std::string decoded = base64_decode(encoded_block);
-                        size_t block_size = decoded.size();
-                        uint8_t *xor_encrypted = new uint8_t[block_size];
-                        std::memcpy(xor_encrypted, decoded.data(), block_size);
-    
-                        uint8_t *decrypted_block = new uint8_t[block_size];
-                        xor_cipher(shared_secret, std::string((char*)xor_encrypted, block_size), decrypted_block);
-                        original_message += std::string(reinterpret_cast<char *>(decrypted_block), block_size);
-    
-                        delete[] xor_encrypted;
-                        delete[] decrypted_block;
-                    }
-    
-                    delete[] shared_secret;
+                    std::string original_message = xor_decrypt_blocks(shared_secret_base64, ciphertext_combined);
     
                     results[idx++] = crow::json::wvalue({
                         {"original_message", original_message}
@@ -611,6 +1799,497 @@ int main() {
     
 
 
+    // Sessions: /session/open runs the KEM once (encapsulating to public_key, or decapsulating
+    // kem_ciphertext with secret_key) and later messages only pay for AES-256-GCM
+    app.route_dynamic("/session/open").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params) {
+            return crow::response(400, "key_id, or kem_name with public_key or secret_key, is required");
+        }
+
+        try {
+            bool responder = params.has("kem_ciphertext");
+            RequestKem request_kem;
+            if (!resolve_request_kem(key_registry, params, responder ? "secret_key" : "public_key", request_kem)) {
+                return crow::response(404, "Unknown key_id");
+            }
+            std::chrono::seconds ttl = params.has("ttl_seconds") ? std::chrono::seconds(params["ttl_seconds"].i()) : SessionTable::default_ttl;
+            uint64_t max_messages = params.has("max_messages") ? params["max_messages"].u() : SessionTable::default_max_messages;
+
+            SessionRef session;
+            std::vector<uint8_t> kem_ciphertext;
+            if (responder) {
+                std::string received = base64_decode(std::string(params["kem_ciphertext"].s()));
+                session = sessions.open_responder(request_kem.kem, request_kem.key_bytes, reinterpret_cast<const uint8_t *>(received.data()),
+                                                  received.size(), ttl, max_messages);
+            } else {
+                session = sessions.open_initiator(request_kem.kem, request_kem.key_bytes, kem_ciphertext, ttl, max_messages);
+            }
+
+            auto expires_in = std::chrono::duration_cast<std::chrono::seconds>(session->expires_at - std::chrono::steady_clock::now());
+            crow::json::wvalue response({
+                {"session_id", session->id},
+                {"role", session_role_name(session->role)},
+                {"algorithm", session->algorithm},
+                {"expires_in", static_cast<int64_t>(expires_in.count())},
+                {"max_messages", session->max_messages}
+            });
+            if (!responder) {
+                response["kem_ciphertext"] = base64_encode(kem_ciphertext.data(), kem_ciphertext.size());
+            }
+            return crow::response(201, response);
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/session/<string>/encrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req, std::string session_id) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || !params.has("message")) {
+            return crow::response(400, "message is required");
+        }
+        SessionRef session = sessions.find(session_id);
+        if (!session) {
+            return crow::response(404, "Unknown or expired session");
+        }
+
+        try {
+            std::string message = params["message"].s();
+            std::vector<uint8_t> sealed = session->encrypt(reinterpret_cast<const uint8_t *>(message.data()), message.size());
+            return crow::response(crow::json::wvalue({
+                {"ciphertext", base64_encode(sealed.data(), sealed.size())}
+            }));
+        } catch (const std::out_of_range &e) {
+            return crow::response(409, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/session/<string>/decrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req, std::string session_id) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || !params.has("ciphertext")) {
+            return crow::response(400, "ciphertext is required");
+        }
+        SessionRef session = sessions.find(session_id);
+        if (!session) {
+            return crow::response(404, "Unknown or expired session");
+        }
+
+        try {
+            std::string sealed = base64_decode(std::string(params["ciphertext"].s()));
+            return crow::response(crow::json::wvalue({
+                {"message", session->decrypt(reinterpret_cast<const uint8_t *>(sealed.data()), sealed.size())}
+            }));
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::out_of_range &e) {
+            return crow::response(409, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/session/<string>").methods(crow::HTTPMethod::DELETE)([&](const crow::request &, std::string session_id) -> crow::response {
+        if (!sessions.close(session_id)) {
+            return crow::response(404, "Unknown session");
+        }
+        return crow::response(204);
+    });
+
+    // Hybrid X25519 + ML-KEM-768: one request gives the combined secret of both exchanges.
+    // Each route takes a single item or a batch ("count", "public_keys" or "items").
+    app.route_dynamic("/hybrid/generate_keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        size_t count = params && params.has("count") ? params["count"].u() : 1;
+        if (count == 0 || count > 1024) {
+            return crow::response(400, "count must be between 1 and 1024");
+        }
+
+        try {
+            std::vector<hybrid::KeyPair> keys = hybrid::generate_keys(count);
+            auto key_json = [](const hybrid::KeyPair &key) {
+                return crow::json::wvalue({
+                    {"public_key", base64_encode(key.public_key.data(), key.public_key.size())},
+                    {"secret_key", base64_encode(key.secret_key.data(), key.secret_key.size())}
+                });
+            };
+
+            crow::json::wvalue response = params && params.has("count") ? crow::json::wvalue() : key_json(keys[0]);
+            if (params && params.has("count")) {
+                for (size_t i = 0; i < keys.size(); i++) {
+                    response["keys"][i] = key_json(keys[i]);
+                }
+            }
+            response["algorithm"] = hybrid::algorithm_name;
+            return crow::response(response);
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/hybrid/encaps").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || (!params.has("public_key") && !params.has("public_keys"))) {
+            return crow::response(400, "public_key or public_keys is required");
+        }
+
+        std::vector<std::vector<uint8_t>> public_keys;
+        if (params.has("public_keys")) {
+            for (auto &public_key : params["public_keys"]) {
+                std::string decoded = base64_decode(std::string(public_key.s()));
+                public_keys.emplace_back(decoded.begin(), decoded.end());
+            }
+        } else {
+            std::string decoded = base64_decode(std::string(params["public_key"].s()));
+            public_keys.emplace_back(decoded.begin(), decoded.end());
+        }
+
+        try {
+            std::vector<hybrid::Encapsulation> results = hybrid::encaps(public_keys);
+            auto result_json = [](const hybrid::Encapsulation &result) {
+                return crow::json::wvalue({
+                    {"ciphertext", base64_encode(result.ciphertext.data(), result.ciphertext.size())},
+                    {"shared_secret", base64_encode(result.shared_secret.data(), result.shared_secret.size())}
+                });
+            };
+
+            if (!params.has("public_keys")) {
+                return crow::response(result_json(results[0]));
+            }
+            crow::json::wvalue response;
+            response["results"] = crow::json::wvalue::list();
+            for (size_t i = 0; i < results.size(); i++) {
+                response["results"][i] = result_json(results[i]);
+            }
+            return crow::response(response);
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    app.route_dynamic("/hybrid/decaps").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || (!params.has("items") && (!params.has("secret_key") || !params.has("ciphertext")))) {
+            return crow::response(400, "secret_key and ciphertext (or items) are required");
+        }
+
+        std::vector<hybrid::Ciphertext> items;
+        auto add_item = [&items](const crow::json::rvalue &item) {
+            std::string secret_key = base64_decode(std::string(item["secret_key"].s()));
+            std::string ciphertext = base64_decode(std::string(item["ciphertext"].s()));
+            items.push_back({{secret_key.begin(), secret_key.end()}, {ciphertext.begin(), ciphertext.end()}});
+            OQS_MEM_cleanse(&secret_key[0], secret_key.size());
+        };
+
+        try {
+            if (params.has("items")) {
+                for (auto &item : params["items"]) {
+                    add_item(item);
+                }
+            } else {
+                add_item(params);
+            }
+
+            std::vector<std::vector<uint8_t>> secrets = hybrid::decaps(items);
+            for (auto &item : items) {
+                OQS_MEM_cleanse(item.secret_key.data(), item.secret_key.size());
+            }
+
+            if (!params.has("items")) {
+                return crow::response(crow::json::wvalue({
+                    {"shared_secret", base64_encode(secrets[0].data(), secrets[0].size())}
+                }));
+            }
+            crow::json::wvalue response;
+            response["results"] = crow::json::wvalue::list();
+            for (size_t i = 0; i < secrets.size(); i++) {
+                response["results"][i] = crow::json::wvalue({
+                    {"shared_secret", base64_encode(secrets[i].data(), secrets[i].size())}
+                });
+            }
+            return crow::response(response);
+        } catch (const std::invalid_argument &e) {
+            return crow::response(400, e.what());
+        } catch (const std::exception &e) {
+            return crow::response(500, e.what());
+        }
+    });
+
+    // Native port of the kypher.py Kyber scheme, with the same request and response fields
+    // as its Flask server. Messages are split into 32-byte blocks as in pad_encryption;
+    // M records which padding case applied.
+    app.route_dynamic("/kyber/generate_keys").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        std::string variant = params && params.has("variant") ? std::string(params["variant"].s()) : "Kyber512";
+        const kyber::Params *kyber_params = kyber::params_by_name(variant);
+        if (!kyber_params) {
+            return crow::response(400, "variant must be Kyber512, Kyber768 or Kyber1024");
+        }
+
+        uint8_t seed[32];
+        OQS_randombytes(seed, sizeof(seed));
+        std::vector<uint8_t> public_key(kyber_params->public_key_bytes());
+        std::vector<uint8_t> secret_key(kyber_params->secret_key_bytes());
+        kyber::keygen(*kyber_params, public_key.data(), secret_key.data(), seed);
+        OQS_MEM_cleanse(seed, sizeof(seed));
+
+        crow::response response(crow::json::wvalue({
+            {"public_key", base64_encode(public_key.data(), public_key.size())},
+            {"secret_key", base64_encode(secret_key.data(), secret_key.size())}
+        }));
+        OQS_MEM_cleanse(secret_key.data(), secret_key.size());
+        return response;
+    });
+
+    app.route_dynamic("/kyber/encrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || !params.has("message") || !params.has("public_key")) {
+            return crow::response(400, "message and public_key are required");
+        }
+
+        std::string message = params["message"].s();
+        std::string public_key = base64_decode(std::string(params["public_key"].s()));
+        const kyber::Params *kyber_params = kyber::params_by_public_key(public_key.size());
+        if (!kyber_params) {
+            return crow::response(400, "Invalid public key length");
+        }
+
+        // Same cases as pad_encryption: 1 padded, 2 exactly one block, 3 whole blocks, 4 last block padded
+        int mode = message.size() < 32 ? 1 : message.size() == 32 ? 2 : message.size() % 32 == 0 ? 3 : 4;
+        if (mode == 1 || mode == 4) {
+            size_t pad_len = 32 - message.size() % 32;
+            message.append(pad_len, static_cast<char>(pad_len));
+        }
+
+        size_t blocks = message.size() / 32;
+        std::vector<uint8_t> ciphertext(blocks * kyber_params->ciphertext_bytes());
+        uint8_t coins[32];
+        for (size_t i = 0; i < blocks; i++) {
+            OQS_randombytes(coins, sizeof(coins));
+            kyber::encrypt(*kyber_params, ciphertext.data() + i * kyber_params->ciphertext_bytes(),
+                           reinterpret_cast<const uint8_t *>(public_key.data()),
+                           reinterpret_cast<const uint8_t *>(message.data()) + 32 * i, coins);
+        }
+        OQS_MEM_cleanse(coins, sizeof(coins));
+
+        return crow::response(crow::json::wvalue({
+            {"encrypted_message", base64_encode(ciphertext.data(), ciphertext.size())},
+            {"M", mode}
+        }));
+    });
+
+    app.route_dynamic("/kyber/decrypt").methods(crow::HTTPMethod::POST)([&](const crow::request &req) -> crow::response {
+        auto params = crow::json::load(req.body);
+        if (!params || !params.has("encryptedMessage") || !params.has("secret_key") || !params.has("M")) {
+            return crow::response(400, "encryptedMessage, M and secret_key are required");
+        }
+
+        std::string ciphertext = base64_decode(std::string(params["encryptedMessage"].s()));
+        std::string secret_key = base64_decode(std::string(params["secret_key"].s()));
+        int mode = params["M"].i();
+        const kyber::Params *kyber_params = kyber::params_by_secret_key(secret_key.size());
+        if (!kyber_params) {
+            return crow::response(400, "Invalid secret key length");
+        }
+        size_t ciphertext_len = kyber_params->ciphertext_bytes();
+        if (ciphertext.empty() || ciphertext.size() % ciphertext_len != 0 || mode < 1 || mode > 4) {
+            return crow::response(400, "Invalid encrypted message");
+        }
+
+        std::string message(ciphertext.size() / ciphertext_len * 32, '\0');
+        for (size_t i = 0; i < ciphertext.size() / ciphertext_len; i++) {
+            kyber::decrypt(*kyber_params, reinterpret_cast<uint8_t *>(&message[32 * i]),
+                           reinterpret_cast<const uint8_t *>(ciphertext.data()) + i * ciphertext_len,
+                           reinterpret_cast<const uint8_t *>(secret_key.data()));
+        }
+        OQS_MEM_cleanse(&secret_key[0], secret_key.size());
+
+        // Undo the padding of the last block
+        if (mode == 1 || mode == 4) {
+            size_t pad_len = static_cast<uint8_t>(message.back());
+            if (pad_len == 0 || pad_len > 32) {
+                return crow::response(500, "Decryption failed");
+            }
+            message.resize(message.size() - pad_len);
+        }
+
+        return crow::response(crow::json::wvalue({
+            {"decrypted_message", message}
+        }));
+    });
+
+    // List the enabled algorithms with their sizes and the last measured timings
+    app.route_dynamic("/algorithms").methods(crow::HTTPMethod::GET)([&](const crow::request &) -> crow::response {
+        auto snapshot = algorithm_catalog.snapshot();
+        crow::json::wvalue response({
+            {"measuring", algorithm_catalog.measuring()},
+            {"benchmarked", snapshot->benchmarked},
+            {"budget_ms", static_cast<int64_t>(algorithm_catalog.budget().count())}
+        });
+        if (snapshot->benchmarked) {
+            response["measured_at"] = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                snapshot->measured_at.time_since_epoch()).count());
+        }
+
+        std::vector<crow::json::wvalue> kems, signatures;
+        for (const AlgorithmInfo &info : snapshot->algorithms) {
+            (info.kind == KeyKind::Kem ? kems : signatures).push_back(algorithm_json(info));
+        }
+        response["kems"] = std::move(kems);
+        response["signatures"] = std::move(signatures);
+        return crow::response(response);
+    });
+
+    // Measure every algorithm again; the previous timings are served until it finishes
+    app.route_dynamic("/algorithms/refresh").methods(crow::HTTPMethod::POST)([&](const crow::request &) -> crow::response {
+        if (!algorithm_catalog.refresh()) {
+            return crow::response(409, "Benchmarking is disabled (ALGORITHMS_BENCH_MS=0)");
+        }
+        return crow::response(202, crow::json::wvalue({
+            {"measuring", true}
+        }));
+    });
+
+    // Verification cache settings and hit rates per route
+    app.route_dynamic("/verify_cache").methods(crow::HTTPMethod::GET)([&](const crow::request &) -> crow::response {
+        crow::json::wvalue routes;
+        for (size_t i = 0; i < VerifyCache::route_count; i++) {
+            auto route = static_cast<VerifyCache::Route>(i);
+            uint64_t hits = verify_cache.hits(route), misses = verify_cache.misses(route);
+            routes[verify_cache_route_name(route)] = crow::json::wvalue({
+                {"enabled", verify_cache.enabled(route)},
+                {"hits", hits},
+                {"misses", misses},
+                {"hit_rate", hits + misses ? double(hits) / double(hits + misses) : 0.0}
+            });
+        }
+        crow::json::wvalue response({
+            {"ttl_seconds", static_cast<int64_t>(verify_cache.ttl().count())},
+            {"max_entries", verify_cache.max_entries()},
+            {"entries", verify_cache.size()},
+            {"evictions", verify_cache.evictions()},
+            {"expirations", verify_cache.expirations()}
+        });
+        response["routes"] = std::move(routes);
+        return crow::response(response);
+    });
+
+    // NDJSON bulk requests over HTTP/1.1 are taken as their body arrives, so their items
+    // run while the rest is still uploading and the output goes back in chunks as it is
+    // ready. The client has to read the response while it sends: reading stops while
+    // too much output is waiting, and a client taking neither is dropped at the timeout.
+    const std::map<std::string, const ndjson::Opener *> ndjson_routes = {
+        {"/bulkSign", &bulk_sign_ndjson},
+        {"/bulkVerify", &bulk_verify_ndjson},
+        {"/bulkEncrypt", &bulk_encrypt_ndjson},
+        {"/bulkDecrypt", &bulk_decrypt_ndjson}
+    };
+    app.body_stream_handler([&](const crow::request &req, std::shared_ptr<crow::stream_writer> out) -> std::unique_ptr<crow::body_stream> {
+        auto route = ndjson_routes.find(req.url);
+        if (req.method != crow::HTTPMethod::POST || route == ndjson_routes.end() ||
+            !ndjson::is_ndjson(req.get_header_value("Content-Type"))) {
+            return nullptr;
+        }
+        return std::make_unique<NdjsonBodyStream>(*route->second, std::move(out));
+    });
+
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT)
+    CROW_LOG_INFO << "I/O backend: io_uring";
+#else
+    CROW_LOG_INFO << "I/O backend: epoll";
+#endif
+
+    // RPC_PORT=port also serves signing and verification over the binary protocol of rpc.h,
+    // on one thread per hardware thread
+    std::unique_ptr<rpc::Server> rpc_server;
+    if (const char *rpc_port = std::getenv("RPC_PORT")) {
+        rpc_server.reset(new rpc::Server(uint16_t(std::atoi(rpc_port)), 0, [&](const rpc::Request &request, rpc::Response &response) {
+            if (request.op != rpc::Op::Sign && request.op != rpc::Op::Verify) {
+                throw std::invalid_argument("Unknown op");
+            }
+            bool sign = request.op == rpc::Op::Sign;
+            RequestSig sig;
+            if (!resolve_rpc_sig(key_registry, request, sign, sig)) {
+                response.status = rpc::Status::UnknownKey;
+                response.payload = "Unknown key_id";
+            } else if (sign) {
+                response.payload = sign_raw_with_sig(sig.sig, request.message, sig.key_bytes);
+            } else if (!verify_raw_with_sig(sig.sig, request.message, request.signature, sig.key_bytes)) {
+                response.status = rpc::Status::VerificationFailed;
+                response.payload = "Signature verification failed";
+            }
+        }));
+        rpc_server->start();
+        CROW_LOG_INFO << "Binary RPC is listening on port " << rpc_port;
+    }
+
+    // UNIX_SOCKET=path also serves the routes on a unix domain socket at path for clients on this
+    // host, with the permissions in UNIX_SOCKET_MODE (octal, e.g. 660) if set. UNIX_SOCKET_ONLY=1
+    // serves the socket alone, without the TCP port.
+    std::unique_ptr<UnixSocketServer<crow::SimpleApp>> unix_server;
+    const char *unix_socket = std::getenv("UNIX_SOCKET");
+    if (unix_socket && *unix_socket) {
+        const char *mode = std::getenv("UNIX_SOCKET_MODE");
+        unix_server.reset(new UnixSocketServer<crow::SimpleApp>(app, unix_socket, std::thread::hardware_concurrency(),
+                                                                mode ? mode_t(std::strtoul(mode, nullptr, 8)) : 0));
+        const char *unix_only = std::getenv("UNIX_SOCKET_ONLY");
+        if (unix_only && std::strcmp(unix_only, "1") == 0) {
+            unix_server->run();
+            return 0;
+        }
+    }
+
+    // LISTENERS=N serves the port from N SO_REUSEPORT listeners, each with its own thread and
+    // io_context. Listener i is pinned to the i-th CPU of LISTENER_CPUS (comma separated and
+    // cycled; "none" leaves them unpinned), by default of the CPUs this process may run on.
+    const char *listeners = std::getenv("LISTENERS");
+    if (listeners && std::atoi(listeners) > 0) {
+        std::vector<int> allowed;
+        const char *cpu_list = std::getenv("LISTENER_CPUS");
+        if (cpu_list && std::strcmp(cpu_list, "none") == 0) {
+            allowed.push_back(-1);
+        } else if (cpu_list) {
+            std::stringstream names(cpu_list);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) {
+                    allowed.push_back(std::atoi(name.c_str()));
+                }
+            }
+        } else {
+            allowed = ReusePortServer<crow::SimpleApp>::allowed_cpus();
+        }
+        if (allowed.empty()) {
+            allowed.push_back(-1);
+        }
+
+        std::vector<int> cpus;
+        for (int i = 0; i < std::atoi(listeners); i++) {
+            cpus.push_back(allowed[i % allowed.size()]);
+        }
+        if (unix_server) {
+            app.validate();
+            unix_server->start();
+        }
+        ReusePortServer<crow::SimpleApp> server(app, 5001, cpus);
+        server.run();
+        return 0;
+    }
+
+    if (unix_server) {
+        // The socket opens once app.run() has validated the routes
+        auto tcp_server = app.port(5001).run_async();
+        app.wait_for_server_start();
+        unix_server->start();
+        tcp_server.wait();
+        return 0;
+    }
+
     app.port(5001).run();
 
     return 0;
@@ -0,0 +1,437 @@
+#include "dilithium.h"
+
+#include <algorithm>
+#include <cstring>
+#include "fips202.h"
+#include "fips202x4.h"
+
+namespace dilithium {
+
+const Params ml_dsa_44 = {"ML-DSA-44", 4, 4, 2, 39, 78, 1 << 17, gamma2_88, 80, 32};
+const Params ml_dsa_65 = {"ML-DSA-65", 6, 5, 4, 49, 196, 1 << 19, gamma2_32, 55, 48};
+const Params ml_dsa_87 = {"ML-DSA-87", 8, 7, 2, 60, 120, 1 << 19, gamma2_32, 75, 64};
+
+namespace {
+
+const Params *const all_params[] = {&ml_dsa_44, &ml_dsa_65, &ml_dsa_87};
+
+bool use_x4() {
+    return avx2_enabled() && fips202::x4_avx2_enabled();
+}
+
+// Coefficients taken from a stream of XOF bytes; returns how many were written
+using Sampler = unsigned (*)(int32_t *r, unsigned len, const uint8_t *buf, size_t buflen, int param);
+
+// One polynomial sampled from XOF(seed)
+struct Expansion {
+    Poly *poly;
+    uint8_t seed[66];
+    size_t seedlen;
+};
+
+// Fill every target from its own SHAKE stream: first_blocks blocks, then one more at
+// a time until the sampler has 256 coefficients. With AVX2 four streams share each
+// permutation; spare lanes repeat the last target into a scratch poly. All targets
+// must have the same seed length.
+void expand(const Expansion *targets, int count, bool shake128, size_t first_blocks,
+            Sampler sample, int param) {
+    constexpr size_t max_blocks = 5;
+    size_t rate = shake128 ? fips202::shake128_rate : fips202::shake256_rate;
+    int lanes = use_x4() ? 4 : 1;
+    Poly spare;
+    for (int first = 0; first < count; first += lanes) {
+        // Room for a sampler that reads up to 3 bytes past the end of the stream
+        uint8_t buf[4][max_blocks * fips202::shake128_rate + 4];
+        const uint8_t *in[4];
+        uint8_t *out[4];
+        Poly *target[4];
+        for (int l = 0; l < 4; l++) {
+            const Expansion &e = targets[std::min(first + l, count - 1)];
+            in[l] = e.seed;
+            out[l] = buf[l];
+            target[l] = first + l < count ? e.poly : &spare;
+        }
+        size_t seedlen = targets[first].seedlen;
+
+        unsigned filled[4];
+        if (lanes == 4) {
+            fips202::SpongeX4 xof = shake128 ? fips202::shake128x4() : fips202::shake256x4();
+            xof.absorb_once(in, seedlen);
+            xof.squeeze_blocks(out, first_blocks);
+            for (int l = 0; l < 4; l++) {
+                filled[l] = sample(target[l]->coeffs, n, buf[l], first_blocks * rate, param);
+            }
+            while (*std::min_element(filled, filled + 4) < unsigned(n)) {
+                xof.squeeze_blocks(out, 1);
+                for (int l = 0; l < 4; l++) {
+                    filled[l] += sample(target[l]->coeffs + filled[l], n - filled[l], buf[l], rate, param);
+                }
+            }
+        } else {
+            fips202::Sponge xof = shake128 ? fips202::shake128() : fips202::shake256();
+            xof.absorb(in[0], seedlen);
+            xof.squeeze_blocks(buf[0], first_blocks);
+            filled[0] = sample(target[0]->coeffs, n, buf[0], first_blocks * rate, param);
+            while (filled[0] < unsigned(n)) {
+                xof.squeeze_blocks(buf[0], 1);
+                filled[0] += sample(target[0]->coeffs + filled[0], n - filled[0], buf[0], rate, param);
+            }
+        }
+    }
+}
+
+// RejNTTPoly: 23-bit candidates from 3 bytes, accepted below q
+unsigned rej_uniform(int32_t *r, unsigned len, const uint8_t *buf, size_t buflen, int) {
+    unsigned count = 0;
+    size_t pos = 0;
+    while (count < len && pos + 3 <= buflen) {
+        uint32_t t = buf[pos] | uint32_t(buf[pos + 1]) << 8 | uint32_t(buf[pos + 2] & 0x7f) << 16;
+        pos += 3;
+        if (t < uint32_t(q)) {
+            r[count++] = int32_t(t);
+        }
+    }
+    return count;
+}
+
+// RejBoundedPoly: two half-byte candidates per byte, accepted below 15 (eta 2) or 9 (eta 4)
+unsigned rej_eta(int32_t *r, unsigned len, const uint8_t *buf, size_t buflen, int eta) {
+    unsigned count = 0;
+    for (size_t pos = 0; count < len && pos < buflen; pos++) {
+        uint32_t z[2] = {buf[pos] & 15u, uint32_t(buf[pos]) >> 4};
+        for (int i = 0; i < 2 && count < len; i++) {
+            if (eta == 2 && z[i] < 15) {
+                r[count++] = 2 - int32_t(z[i] - (205 * z[i] >> 10) * 5);
+            } else if (eta == 4 && z[i] < 9) {
+                r[count++] = 4 - int32_t(z[i]);
+            }
+        }
+    }
+    return count;
+}
+
+// ExpandMask's BitUnpack: gamma1 - (18- or 20-bit little-endian fields)
+unsigned unpack_mask(int32_t *r, unsigned len, const uint8_t *buf, size_t, int gamma1) {
+    int bits = gamma1 == (1 << 17) ? 18 : 20;
+    uint32_t mask = (1u << bits) - 1;
+    for (unsigned i = 0; i < len; i++) {
+        size_t bit = size_t(i) * size_t(bits);
+        const uint8_t *p = buf + bit / 8;
+        uint32_t t = p[0] | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+        r[i] = gamma1 - int32_t((t >> (bit % 8)) & mask);
+    }
+    return len;
+}
+
+// Little-endian bit packing of the low `bits` bits of each coefficient
+void pack_bits(uint8_t *out, const Poly &a, int bits) {
+    uint64_t acc = 0;
+    int held = 0;
+    for (int i = 0; i < n; i++) {
+        acc |= uint64_t(uint32_t(a.coeffs[i]) & ((1u << bits) - 1)) << held;
+        held += bits;
+        while (held >= 8) {
+            *out++ = uint8_t(acc);
+            acc >>= 8;
+            held -= 8;
+        }
+    }
+}
+
+// 6 bits per coefficient of w1 for gamma2 = (q - 1) / 88, 4 bits for (q - 1) / 32
+int w1_bits(const Params &params) {
+    return params.gamma2 == gamma2_88 ? 6 : 4;
+}
+
+// c~ = H(mu || w1Encode(w1))
+void challenge_hash(uint8_t *ctilde, const Params &params, const uint8_t mu[64], const PolyVecK &w1) {
+    int bits = w1_bits(params);
+    uint8_t packed[max_k * 32 * 6];
+    for (int i = 0; i < params.k; i++) {
+        pack_bits(packed + size_t(32 * bits * i), w1.vec[i], bits);
+    }
+    fips202::Sponge h = fips202::shake256();
+    h.absorb(mu, 64);
+    h.absorb(packed, size_t(32 * bits * params.k));
+    h.squeeze(ctilde, params.ctilde_bytes);
+}
+
+// SampleInBall: tau coefficients of +-1 placed by a Fisher-Yates shuffle
+void sample_in_ball(Poly &c, const Params &params, const uint8_t *ctilde) {
+    fips202::Sponge xof = fips202::shake256();
+    xof.absorb(ctilde, params.ctilde_bytes);
+    uint8_t buf[fips202::shake256_rate];
+    xof.squeeze(buf, sizeof(buf));
+    uint64_t signs = fips202::load64(buf);
+    size_t pos = 8;
+
+    std::memset(c.coeffs, 0, sizeof(c.coeffs));
+    for (int i = n - params.tau; i < n; i++) {
+        int j;
+        do {
+            if (pos == sizeof(buf)) {
+                xof.squeeze(buf, sizeof(buf));
+                pos = 0;
+            }
+            j = buf[pos++];
+        } while (j > i);
+        c.coeffs[i] = c.coeffs[j];
+        c.coeffs[j] = 1 - 2 * int32_t(signs & 1);
+        signs >>= 1;
+    }
+}
+
+// mu = H(tr || M') with M' = 0 || 0 || msg (pure ML-DSA, empty context)
+void message_representative(uint8_t mu[64], const Key &key, const uint8_t *msg, size_t len) {
+    const uint8_t prefix[2] = {0, 0};
+    fips202::Sponge h = fips202::shake256();
+    h.absorb(key.tr, sizeof(key.tr));
+    h.absorb(prefix, sizeof(prefix));
+    h.absorb(msg, len);
+    h.squeeze(mu, 64);
+}
+
+// r[i] = sum_j a[i][j] * v[j] in the NTT domain, reduced
+void matrix_multiply(PolyVecK &r, const Key &key, const PolyVecL &v) {
+    const Params &params = *key.params;
+    for (int i = 0; i < params.k; i++) {
+        Poly t;
+        poly_pointwise_montgomery(r.vec[i], key.a[i].vec[0], v.vec[0]);
+        for (int j = 1; j < params.l; j++) {
+            poly_pointwise_montgomery(t, key.a[i].vec[j], v.vec[j]);
+            poly_add(r.vec[i], r.vec[i], t);
+        }
+        poly_reduce(r.vec[i]);
+    }
+}
+
+// ExpandMask(rho'', kappa): the l polynomials of y
+void expand_mask(PolyVecL &y, const Params &params, const uint8_t rho2[64], unsigned kappa) {
+    Expansion targets[max_l];
+    for (int i = 0; i < params.l; i++) {
+        Expansion &e = targets[i];
+        e.poly = &y.vec[i];
+        std::memcpy(e.seed, rho2, 64);
+        e.seed[64] = uint8_t(kappa + unsigned(i));
+        e.seed[65] = uint8_t((kappa + unsigned(i)) >> 8);
+        e.seedlen = 66;
+    }
+    // 576 or 640 bytes: five SHAKE256 blocks
+    expand(targets, params.l, false, 5, unpack_mask, params.gamma1);
+}
+
+} // namespace
+
+const Params *params_by_name(const std::string &name) {
+    for (const Params *p : all_params) {
+        if (name == p->name) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+void keygen(Key &key, const Params &params, const uint8_t seed[32]) {
+    const int k = params.k, l = params.l;
+    key.params = &params;
+
+    // (rho, rho', K) = H(xi || k || l)
+    uint8_t input[34], expanded[128];
+    std::memcpy(input, seed, 32);
+    input[32] = uint8_t(k);
+    input[33] = uint8_t(l);
+    fips202::shake256(expanded, sizeof(expanded), input, sizeof(input));
+    const uint8_t *rho_prime = expanded + 32;
+    std::memcpy(key.rho, expanded, 32);
+    std::memcpy(key.key, expanded + 96, 32);
+
+    // ExpandA: A[i][j] from rho || j || i; five SHAKE128 blocks cover 256 candidates
+    // almost always
+    Expansion targets[max_k * max_l];
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < l; j++) {
+            Expansion &e = targets[i * l + j];
+            e.poly = &key.a[i].vec[j];
+            std::memcpy(e.seed, key.rho, 32);
+            e.seed[32] = uint8_t(j);
+            e.seed[33] = uint8_t(i);
+            e.seedlen = 34;
+        }
+    }
+    expand(targets, k * l, true, 5, rej_uniform, 0);
+
+    // ExpandS: s1 and s2 from rho' || r with r = 0 .. l + k - 1
+    PolyVecL s1;
+    PolyVecK s2;
+    for (int r = 0; r < l + k; r++) {
+        Expansion &e = targets[r];
+        e.poly = r < l ? &s1.vec[r] : &s2.vec[r - l];
+        std::memcpy(e.seed, rho_prime, 64);
+        e.seed[64] = uint8_t(r);
+        e.seed[65] = 0;
+        e.seedlen = 66;
+    }
+    expand(targets, l + k, false, params.eta == 2 ? 1 : 2, rej_eta, params.eta);
+
+    for (int j = 0; j < l; j++) {
+        key.s1_hat.vec[j] = s1.vec[j];
+        poly_ntt(key.s1_hat.vec[j]);
+    }
+
+    // t = A * s1 + s2, split into t1 * 2^d + t0
+    PolyVecK t;
+    matrix_multiply(t, key, key.s1_hat);
+    int bits = 10;
+    std::memcpy(key.public_key, key.rho, 32);
+    for (int i = 0; i < k; i++) {
+        poly_invntt_tomont(t.vec[i]);
+        poly_add(t.vec[i], t.vec[i], s2.vec[i]);
+        poly_caddq(t.vec[i]);
+
+        Poly t1, t0;
+        poly_power2round(t1, t0, t.vec[i]);
+        pack_bits(key.public_key + 32 + size_t(32 * bits * i), t1, bits);
+
+        key.t0_hat.vec[i] = t0;
+        poly_ntt(key.t0_hat.vec[i]);
+        key.s2_hat.vec[i] = s2.vec[i];
+        poly_ntt(key.s2_hat.vec[i]);
+        poly_shiftl(t1);
+        key.t1_hat.vec[i] = t1;
+        poly_ntt(key.t1_hat.vec[i]);
+    }
+
+    fips202::shake256(key.tr, sizeof(key.tr), key.public_key, params.public_key_bytes());
+}
+
+unsigned sign(Signature &sig, const Key &key, const uint8_t *msg, size_t len, const uint8_t rnd[32]) {
+    const Params &params = *key.params;
+    const int k = params.k, l = params.l;
+
+    uint8_t mu[64], rho2[64];
+    message_representative(mu, key, msg, len);
+    fips202::Sponge h = fips202::shake256();
+    h.absorb(key.key, sizeof(key.key));
+    h.absorb(rnd, 32);
+    h.absorb(mu, sizeof(mu));
+    h.squeeze(rho2, sizeof(rho2));
+
+    // Every attempt reuses these; firma.py's sign() recursed with fresh ones instead
+    PolyVecL y, y_hat;
+    PolyVecK w, w1, w0;
+    Poly c_hat, t;
+    unsigned attempts = 0;
+    for (unsigned kappa = 0;; kappa += unsigned(l)) {
+        attempts++;
+        expand_mask(y, params, rho2, kappa);
+
+        // w = A y, then (w1, w0) = Decompose(w)
+        for (int j = 0; j < l; j++) {
+            y_hat.vec[j] = y.vec[j];
+            poly_ntt(y_hat.vec[j]);
+        }
+        matrix_multiply(w, key, y_hat);
+        for (int i = 0; i < k; i++) {
+            poly_invntt_tomont(w.vec[i]);
+            poly_caddq(w.vec[i]);
+            poly_decompose(w1.vec[i], w0.vec[i], w.vec[i], params.gamma2);
+        }
+
+        challenge_hash(sig.ctilde, params, mu, w1);
+        sample_in_ball(c_hat, params, sig.ctilde);
+        poly_ntt(c_hat);
+
+        // z = y + c s1, rejected if ||z|| >= gamma1 - beta
+        bool reject = false;
+        for (int j = 0; j < l && !reject; j++) {
+            poly_pointwise_montgomery(t, c_hat, key.s1_hat.vec[j]);
+            poly_invntt_tomont(t);
+            poly_add(sig.z.vec[j], y.vec[j], t);
+            poly_reduce(sig.z.vec[j]);
+            reject = poly_chknorm(sig.z.vec[j], params.gamma1 - params.beta);
+        }
+        if (reject) {
+            continue;
+        }
+
+        // r0 = LowBits(w - c s2), rejected if ||r0|| >= gamma2 - beta
+        for (int i = 0; i < k && !reject; i++) {
+            poly_pointwise_montgomery(t, c_hat, key.s2_hat.vec[i]);
+            poly_invntt_tomont(t);
+            poly_sub(w0.vec[i], w0.vec[i], t);
+            poly_reduce(w0.vec[i]);
+            reject = poly_chknorm(w0.vec[i], params.gamma2 - params.beta);
+        }
+        if (reject) {
+            continue;
+        }
+
+        // h = MakeHint(-c t0, w - c s2 + c t0), rejected if ||c t0|| >= gamma2 or too many ones
+        unsigned ones = 0;
+        for (int i = 0; i < k && !reject; i++) {
+            poly_pointwise_montgomery(t, c_hat, key.t0_hat.vec[i]);
+            poly_invntt_tomont(t);
+            poly_reduce(t);
+            reject = poly_chknorm(t, params.gamma2);
+            poly_add(w0.vec[i], w0.vec[i], t);
+            ones += poly_make_hint(sig.h.vec[i], w0.vec[i], w1.vec[i], params.gamma2);
+        }
+        if (reject || ones > params.omega) {
+            continue;
+        }
+        return attempts;
+    }
+}
+
+bool verify(const Key &key, const uint8_t *msg, size_t len, const Signature &sig) {
+    const Params &params = *key.params;
+    const int k = params.k, l = params.l;
+
+    unsigned ones = 0;
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < n; j++) {
+            int32_t bit = sig.h.vec[i].coeffs[j];
+            if (bit != 0 && bit != 1) {
+                return false;
+            }
+            ones += unsigned(bit);
+        }
+    }
+    if (ones > params.omega) {
+        return false;
+    }
+    for (int j = 0; j < l; j++) {
+        if (poly_chknorm(sig.z.vec[j], params.gamma1 - params.beta)) {
+            return false;
+        }
+    }
+
+    uint8_t mu[64];
+    message_representative(mu, key, msg, len);
+    Poly c_hat, t;
+    sample_in_ball(c_hat, params, sig.ctilde);
+    poly_ntt(c_hat);
+
+    // w' = A z - c t1 2^d, then w1' = UseHint(h, w')
+    PolyVecL z_hat;
+    for (int j = 0; j < l; j++) {
+        z_hat.vec[j] = sig.z.vec[j];
+        poly_ntt(z_hat.vec[j]);
+    }
+    PolyVecK w;
+    matrix_multiply(w, key, z_hat);
+    for (int i = 0; i < k; i++) {
+        poly_pointwise_montgomery(t, c_hat, key.t1_hat.vec[i]);
+        poly_sub(w.vec[i], w.vec[i], t);
+        poly_reduce(w.vec[i]);
+        poly_invntt_tomont(w.vec[i]);
+        poly_caddq(w.vec[i]);
+        poly_use_hint(w.vec[i], w.vec[i], sig.h.vec[i], params.gamma2);
+    }
+
+    uint8_t ctilde[max_ctilde_bytes];
+    challenge_hash(ctilde, params, mu, w);
+    return std::memcmp(ctilde, sig.ctilde, params.ctilde_bytes) == 0;
+}
+
+} // namespace dilithium
@@ -0,0 +1,90 @@
+#ifndef NATIVE_DILITHIUM_H
+#define NATIVE_DILITHIUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "dilithium_poly.h"
+#include "dilithium_rounding.h"
+
+// Native ML-DSA (FIPS 204) signing core, the compiled counterpart of firma.py.
+//
+// firma.py signs over a random integer matrix with toy bounds and retries by recursing
+// into sign(). Here the same steps (y, w = Ay, HighBits, challenge, z = y + cs1, the
+// norm and LowBits rejection checks) run on ML-DSA polynomials with the FIPS 204
+// samplers and bounds, and the rejection is a loop over one set of buffers.
+//
+// Keys are kept expanded (matrix and secrets in the NTT domain) and signatures are
+// kept unpacked; the key and signature byte encodings are not implemented, so these
+// signatures are not exchanged with liboqs. Messages are signed as pure ML-DSA with
+// an empty context string.
+namespace dilithium {
+
+struct Params {
+    const char *name;
+    int k;
+    int l;
+    int eta;
+    int tau;
+    int beta;
+    int32_t gamma1;
+    int32_t gamma2;
+    unsigned omega;
+    size_t ctilde_bytes;
+
+    size_t public_key_bytes() const { return 32 + 320 * size_t(k); }
+};
+
+constexpr int max_k = 8;
+constexpr int max_l = 7;
+constexpr size_t max_public_key_bytes = 32 + 320 * max_k;
+constexpr size_t max_ctilde_bytes = 64;
+
+struct PolyVecK {
+    Poly vec[max_k];
+};
+
+struct PolyVecL {
+    Poly vec[max_l];
+};
+
+extern const Params ml_dsa_44;
+extern const Params ml_dsa_65;
+extern const Params ml_dsa_87;
+
+// "ML-DSA-44", "ML-DSA-65" or "ML-DSA-87" as named by liboqs; nullptr otherwise
+const Params *params_by_name(const std::string &name);
+
+// A key pair expanded for signing and verification. Verification only reads the
+// public fields (rho, tr, a, t1_hat).
+struct Key {
+    const Params *params = nullptr;
+    uint8_t rho[32];
+    uint8_t key[32];
+    uint8_t tr[64];
+    uint8_t public_key[max_public_key_bytes];  // pkEncode(rho, t1)
+    PolyVecL a[max_k];                         // ExpandA(rho), NTT domain
+    PolyVecL s1_hat;
+    PolyVecK s2_hat;
+    PolyVecK t0_hat;
+    PolyVecK t1_hat;                           // NTT(t1 * 2^d)
+};
+
+struct Signature {
+    uint8_t ctilde[max_ctilde_bytes];
+    PolyVecL z;
+    PolyVecK h;  // hint bits, 0 or 1
+};
+
+// ML-DSA.KeyGen_internal from the 32-byte seed xi
+void keygen(Key &key, const Params &params, const uint8_t seed[32]);
+
+// ML-DSA.Sign_internal with the 32-byte rnd (all zero for deterministic signing).
+// Returns the number of attempts the rejection loop took.
+unsigned sign(Signature &sig, const Key &key, const uint8_t *msg, size_t len, const uint8_t rnd[32]);
+
+bool verify(const Key &key, const uint8_t *msg, size_t len, const Signature &sig);
+
+} // namespace dilithium
+
+#endif // NATIVE_DILITHIUM_H
@@ -0,0 +1,221 @@
+// AVX2 kernels for the ML-DSA NTT, inverse NTT and pointwise multiplication.
+//
+// Same layout as kyber_ntt_avx2.cpp with 8 coefficients of 32 bits per register.
+// Montgomery products are formed as 64-bit products of the even and odd lanes
+// (mul_epi32), so each lane goes through exactly the scalar montgomery_reduce and
+// the output is bit-identical to the reference code.
+#include "dilithium_poly.h"
+
+#ifdef DILITHIUM_NATIVE_X86
+
+#include <immintrin.h>
+
+namespace dilithium {
+namespace avx2 {
+namespace {
+
+// Zeta vectors for the layers whose butterflies are shorter than a register
+// (len = 4, 2 and 1). Entry [layer][i] holds the zetas for coefficients 16i..16i+15
+// in the lane order produced by the shuffles below, plus the same values times qinv.
+// The inverse entries are already negated.
+struct SmallLayerZetas {
+    alignas(32) int32_t forward[3][16][8] = {};
+    alignas(32) int32_t forward_qinv[3][16][8] = {};
+    alignas(32) int32_t inverse[3][16][8] = {};
+    alignas(32) int32_t inverse_qinv[3][16][8] = {};
+
+    constexpr SmallLayerZetas() {
+        // Block of each lane after the shuffle of the len = 4, 2 and 1 layers,
+        // relative to the first block of the 16 coefficients
+        constexpr int lane_block[3][8] = {
+            {0, 0, 0, 0, 1, 1, 1, 1},
+            {0, 0, 2, 2, 1, 1, 3, 3},
+            {0, 4, 1, 5, 2, 6, 3, 7},
+        };
+        for (int layer = 0; layer < 3; layer++) {
+            int len = 4 >> layer;
+            int blocks = 128 / len;
+            for (int i = 0; i < 16; i++) {
+                int first_block = i * 16 / (2 * len);
+                for (int lane = 0; lane < 8; lane++) {
+                    int block = first_block + lane_block[layer][lane];
+                    int32_t forward_zeta = zetas[blocks + block];
+                    int32_t inverse_zeta = -zetas[2 * blocks - 1 - block];
+                    forward[layer][i][lane] = forward_zeta;
+                    forward_qinv[layer][i][lane] = int32_t(uint32_t(forward_zeta) * uint32_t(qinv));
+                    inverse[layer][i][lane] = inverse_zeta;
+                    inverse_qinv[layer][i][lane] = int32_t(uint32_t(inverse_zeta) * uint32_t(qinv));
+                }
+            }
+        }
+    }
+};
+
+constexpr SmallLayerZetas small_layer_zetas;
+
+// Montgomery product a * b * 2^-32, with b_qinv = b * qinv mod 2^32
+DILITHIUM_AVX2 inline __m256i montmul(__m256i a, __m256i b, __m256i b_qinv) {
+    const __m256i q_vec = _mm256_set1_epi32(q);
+    __m256i a_odd = _mm256_srli_epi64(a, 32);
+    __m256i b_odd = _mm256_srli_epi64(b, 32);
+    __m256i b_qinv_odd = _mm256_srli_epi64(b_qinv, 32);
+
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(a_odd, b_odd);
+    // t = low 32 bits of a * b * qinv; t * q has the same low 32 bits as a * b
+    __m256i t_even = _mm256_mul_epi32(_mm256_mul_epi32(a, b_qinv), q_vec);
+    __m256i t_odd = _mm256_mul_epi32(_mm256_mul_epi32(a_odd, b_qinv_odd), q_vec);
+    even = _mm256_sub_epi64(even, t_even);
+    odd = _mm256_sub_epi64(odd, t_odd);
+    return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// Cooley-Tukey butterfly: (x, y) -> (x + zeta*y, x - zeta*y)
+DILITHIUM_AVX2 inline void ct_butterfly(__m256i &x, __m256i &y, __m256i zeta, __m256i zeta_qinv) {
+    __m256i t = montmul(y, zeta, zeta_qinv);
+    y = _mm256_sub_epi32(x, t);
+    x = _mm256_add_epi32(x, t);
+}
+
+// Gentleman-Sande butterfly with a negated zeta: (x, y) -> (x + y, -zeta*(x - y))
+DILITHIUM_AVX2 inline void gs_butterfly(__m256i &x, __m256i &y, __m256i zeta, __m256i zeta_qinv) {
+    __m256i t = x;
+    x = _mm256_add_epi32(t, y);
+    y = montmul(_mm256_sub_epi32(t, y), zeta, zeta_qinv);
+}
+
+// Split two registers into the first and second halves of butterflies of length
+// 4, 2 or 1 and back
+DILITHIUM_AVX2 inline void split4(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_permute2x128_si256(a, b, 0x20);
+    y = _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+DILITHIUM_AVX2 inline void split2(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+}
+
+DILITHIUM_AVX2 inline void split1(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_blend_epi32(a, _mm256_slli_epi64(b, 32), 0xaa);
+    y = _mm256_blend_epi32(_mm256_srli_epi64(a, 32), b, 0xaa);
+}
+
+DILITHIUM_AVX2 inline void merge1(__m256i x, __m256i y, __m256i &a, __m256i &b) {
+    a = _mm256_blend_epi32(x, _mm256_slli_epi64(y, 32), 0xaa);
+    b = _mm256_blend_epi32(_mm256_srli_epi64(x, 32), y, 0xaa);
+}
+
+DILITHIUM_AVX2 inline __m256i load(const int32_t *p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+DILITHIUM_AVX2 inline void store(int32_t *p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+DILITHIUM_AVX2 inline __m256i broadcast_qinv(int32_t zeta) {
+    return _mm256_set1_epi32(int32_t(uint32_t(zeta) * uint32_t(qinv)));
+}
+
+} // namespace
+
+DILITHIUM_AVX2 void ntt(int32_t a[n]) {
+    const SmallLayerZetas &table = small_layer_zetas;
+
+    // Layers with butterflies of 8 coefficients or more use one zeta per register
+    unsigned k = 1;
+    for (unsigned len = 128; len >= 8; len >>= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            __m256i zeta = _mm256_set1_epi32(zetas[k]);
+            __m256i zeta_qinv = broadcast_qinv(zetas[k]);
+            k++;
+            for (unsigned j = start; j < start + len; j += 8) {
+                __m256i x = load(a + j), y = load(a + j + len);
+                ct_butterfly(x, y, zeta, zeta_qinv);
+                store(a + j, x);
+                store(a + j + len, y);
+            }
+        }
+    }
+
+    // Layers len = 4, 2, 1 on 16 coefficients at a time
+    for (unsigned i = 0; i < 16; i++) {
+        int32_t *p = a + 16 * i;
+        __m256i u = load(p), v = load(p + 8), x, y;
+
+        split4(u, v, x, y);
+        ct_butterfly(x, y, load(table.forward[0][i]), load(table.forward_qinv[0][i]));
+        split4(x, y, u, v);
+
+        split2(u, v, x, y);
+        ct_butterfly(x, y, load(table.forward[1][i]), load(table.forward_qinv[1][i]));
+        split2(x, y, u, v);
+
+        split1(u, v, x, y);
+        ct_butterfly(x, y, load(table.forward[2][i]), load(table.forward_qinv[2][i]));
+        merge1(x, y, u, v);
+
+        store(p, u);
+        store(p + 8, v);
+    }
+}
+
+DILITHIUM_AVX2 void invntt_tomont(int32_t a[n]) {
+    const SmallLayerZetas &table = small_layer_zetas;
+
+    for (unsigned i = 0; i < 16; i++) {
+        int32_t *p = a + 16 * i;
+        __m256i u = load(p), v = load(p + 8), x, y;
+
+        split1(u, v, x, y);
+        gs_butterfly(x, y, load(table.inverse[2][i]), load(table.inverse_qinv[2][i]));
+        merge1(x, y, u, v);
+
+        split2(u, v, x, y);
+        gs_butterfly(x, y, load(table.inverse[1][i]), load(table.inverse_qinv[1][i]));
+        split2(x, y, u, v);
+
+        split4(u, v, x, y);
+        gs_butterfly(x, y, load(table.inverse[0][i]), load(table.inverse_qinv[0][i]));
+        split4(x, y, u, v);
+
+        store(p, u);
+        store(p + 8, v);
+    }
+
+    for (unsigned len = 8; len <= 128; len <<= 1) {
+        unsigned blocks = 128 / len;
+        for (unsigned block = 0; block < blocks; block++) {
+            int32_t z = -zetas[2 * blocks - 1 - block];
+            __m256i zeta = _mm256_set1_epi32(z);
+            __m256i zeta_qinv = broadcast_qinv(z);
+            unsigned start = block * 2 * len;
+            for (unsigned j = start; j < start + len; j += 8) {
+                __m256i x = load(a + j), y = load(a + j + len);
+                gs_butterfly(x, y, zeta, zeta_qinv);
+                store(a + j, x);
+                store(a + j + len, y);
+            }
+        }
+    }
+
+    __m256i f = _mm256_set1_epi32(inverse_ntt_factor);
+    __m256i f_qinv = broadcast_qinv(inverse_ntt_factor);
+    for (unsigned j = 0; j < n; j += 8) {
+        store(a + j, montmul(load(a + j), f, f_qinv));
+    }
+}
+
+DILITHIUM_AVX2 void pointwise_montgomery(int32_t r[n], const int32_t a[n], const int32_t b[n]) {
+    const __m256i qinv_vec = _mm256_set1_epi32(qinv);
+    for (unsigned j = 0; j < n; j += 8) {
+        __m256i y = load(b + j);
+        store(r + j, montmul(load(a + j), y, _mm256_mullo_epi32(y, qinv_vec)));
+    }
+}
+
+} // namespace avx2
+} // namespace dilithium
+
+#endif // DILITHIUM_NATIVE_X86
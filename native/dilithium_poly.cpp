@@ -0,0 +1,130 @@
+#include "dilithium_poly.h"
+
+#include <atomic>
+
+namespace dilithium {
+
+namespace {
+
+bool detect_avx2() {
+#ifdef DILITHIUM_NATIVE_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+std::atomic<bool> use_avx2{detect_avx2()};
+
+} // namespace
+
+namespace scalar {
+
+void ntt(int32_t a[n]) {
+    unsigned k = 0;
+    for (unsigned len = 128; len > 0; len >>= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            int32_t zeta = zetas[++k];
+            for (unsigned j = start; j < start + len; j++) {
+                int32_t t = montgomery_reduce(int64_t(zeta) * a[j + len]);
+                a[j + len] = a[j] - t;
+                a[j] = a[j] + t;
+            }
+        }
+    }
+}
+
+void invntt_tomont(int32_t a[n]) {
+    unsigned k = 256;
+    for (unsigned len = 1; len < n; len <<= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            int32_t zeta = -zetas[--k];
+            for (unsigned j = start; j < start + len; j++) {
+                int32_t t = a[j];
+                a[j] = t + a[j + len];
+                a[j + len] = montgomery_reduce(int64_t(zeta) * (t - a[j + len]));
+            }
+        }
+    }
+    for (unsigned j = 0; j < n; j++) {
+        a[j] = montgomery_reduce(int64_t(inverse_ntt_factor) * a[j]);
+    }
+}
+
+void pointwise_montgomery(int32_t r[n], const int32_t a[n], const int32_t b[n]) {
+    for (unsigned i = 0; i < n; i++) {
+        r[i] = montgomery_reduce(int64_t(a[i]) * b[i]);
+    }
+}
+
+} // namespace scalar
+
+void poly_ntt(Poly &a) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::ntt(a.coeffs);
+        return;
+    }
+#endif
+    scalar::ntt(a.coeffs);
+}
+
+void poly_invntt_tomont(Poly &a) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::invntt_tomont(a.coeffs);
+        return;
+    }
+#endif
+    scalar::invntt_tomont(a.coeffs);
+}
+
+void poly_pointwise_montgomery(Poly &r, const Poly &a, const Poly &b) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::pointwise_montgomery(r.coeffs, a.coeffs, b.coeffs);
+        return;
+    }
+#endif
+    scalar::pointwise_montgomery(r.coeffs, a.coeffs, b.coeffs);
+}
+
+void poly_reduce(Poly &a) {
+    for (int i = 0; i < n; i++) {
+        a.coeffs[i] = reduce32(a.coeffs[i]);
+    }
+}
+
+void poly_caddq(Poly &a) {
+    for (int i = 0; i < n; i++) {
+        a.coeffs[i] = caddq(a.coeffs[i]);
+    }
+}
+
+void poly_add(Poly &r, const Poly &a, const Poly &b) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = a.coeffs[i] + b.coeffs[i];
+    }
+}
+
+void poly_sub(Poly &r, const Poly &a, const Poly &b) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = a.coeffs[i] - b.coeffs[i];
+    }
+}
+
+void poly_shiftl(Poly &a) {
+    for (int i = 0; i < n; i++) {
+        a.coeffs[i] = int32_t(uint32_t(a.coeffs[i]) << d);
+    }
+}
+
+bool avx2_enabled() {
+    return use_avx2.load(std::memory_order_relaxed);
+}
+
+void disable_avx2() {
+    use_avx2.store(false, std::memory_order_relaxed);
+}
+
+} // namespace dilithium
@@ -0,0 +1,102 @@
+#ifndef NATIVE_DILITHIUM_POLY_H
+#define NATIVE_DILITHIUM_POLY_H
+
+#include <cstdint>
+#include "ntt_tables.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DILITHIUM_NATIVE_X86 1
+#define DILITHIUM_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Polynomial arithmetic in Z_8380417[X]/(X^256 + 1) for the native ML-DSA code.
+//
+// Coefficients are int32 and follow the reference Dilithium conventions: products go
+// through Montgomery reduction (R = 2^32) and the NTT does no reductions of its own.
+// The NTT, inverse NTT and pointwise product have AVX2 kernels picked at run time,
+// with the same output as the scalar code.
+namespace dilithium {
+
+constexpr int n = 256;
+constexpr int32_t q = 8380417;
+constexpr int32_t qinv = 58728449;                                       // q^-1 mod 2^32
+constexpr int32_t mont = int32_t(ntt_tables::Dilithium::mont);            // 2^32 mod q
+constexpr int d = 13;                                                     // dropped bits of t
+
+// mont^2 / 256 mod q: undoes the Montgomery factor of the inverse NTT's last
+// multiplication and leaves the result in Montgomery form
+constexpr int32_t inverse_ntt_factor = int32_t(
+    ntt_tables::pow_mod(2, 64, q) * ntt_tables::pow_mod(256, q - 2, q) % q);
+
+static_assert(uint32_t(q) * uint32_t(qinv) == 1u, "qinv is the inverse of q mod 2^32");
+static_assert(inverse_ntt_factor == 41978, "reference Dilithium inverse NTT factor");
+
+struct alignas(32) Poly {
+    int32_t coeffs[n];
+};
+
+// zetas[i] = 2^32 * 1753^bitrev8(i) mod q, centered
+constexpr const int32_t *zetas = ntt_tables::Dilithium::zetas.data();
+
+// a * 2^-32 mod q for |a| < q * 2^31; result in (-q, q)
+inline int32_t montgomery_reduce(int64_t a) {
+    int32_t t = int32_t(uint32_t(uint64_t(a)) * uint32_t(qinv));
+    return int32_t((a - int64_t(t) * q) >> 32);
+}
+
+// Representative in [-6283009, 6283007] for a <= 2^31 - 2^22 - 1
+inline int32_t reduce32(int32_t a) {
+    int32_t t = (a + (1 << 22)) >> 23;
+    return a - t * q;
+}
+
+// Add q if a is negative
+inline int32_t caddq(int32_t a) {
+    return a + ((a >> 31) & q);
+}
+
+// Standard representative in [0, q)
+inline int32_t freeze(int32_t a) {
+    return caddq(reduce32(a));
+}
+
+// Forward NTT, output in bit-reversed order; |output| < 9q for |input| < q
+void poly_ntt(Poly &a);
+
+// Inverse NTT, multiplied by 2^32 (so a Montgomery product comes back in normal form)
+void poly_invntt_tomont(Poly &a);
+
+// Pointwise product in the NTT domain, scaled by 2^-32
+void poly_pointwise_montgomery(Poly &r, const Poly &a, const Poly &b);
+
+void poly_reduce(Poly &a);
+void poly_caddq(Poly &a);
+void poly_add(Poly &r, const Poly &a, const Poly &b);
+void poly_sub(Poly &r, const Poly &a, const Poly &b);
+
+// Multiply by 2^d without reduction
+void poly_shiftl(Poly &a);
+
+// True when the AVX2 kernels are in use
+bool avx2_enabled();
+
+// Force the scalar kernels, for benchmarks and cross-checks
+void disable_avx2();
+
+namespace scalar {
+void ntt(int32_t a[n]);
+void invntt_tomont(int32_t a[n]);
+void pointwise_montgomery(int32_t r[n], const int32_t a[n], const int32_t b[n]);
+}
+
+#ifdef DILITHIUM_NATIVE_X86
+namespace avx2 {
+void ntt(int32_t a[n]);
+void invntt_tomont(int32_t a[n]);
+void pointwise_montgomery(int32_t r[n], const int32_t a[n], const int32_t b[n]);
+}
+#endif
+
+} // namespace dilithium
+
+#endif // NATIVE_DILITHIUM_POLY_H
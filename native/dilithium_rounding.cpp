@@ -0,0 +1,105 @@
+#include "dilithium_rounding.h"
+
+namespace dilithium {
+
+namespace scalar {
+
+void power2round(int32_t a1[n], int32_t a0[n], const int32_t a[n]) {
+    for (int i = 0; i < n; i++) {
+        a1[i] = dilithium::power2round(a0[i], a[i]);
+    }
+}
+
+void decompose(int32_t a1[n], int32_t a0[n], const int32_t a[n], int32_t gamma2) {
+    for (int i = 0; i < n; i++) {
+        a1[i] = dilithium::decompose(a0[i], a[i], gamma2);
+    }
+}
+
+unsigned make_hint(int32_t h[n], const int32_t a0[n], const int32_t a1[n], int32_t gamma2) {
+    unsigned ones = 0;
+    for (int i = 0; i < n; i++) {
+        h[i] = dilithium::make_hint(a0[i], a1[i], gamma2);
+        ones += unsigned(h[i]);
+    }
+    return ones;
+}
+
+void use_hint(int32_t b[n], const int32_t a[n], const int32_t h[n], int32_t gamma2) {
+    for (int i = 0; i < n; i++) {
+        b[i] = dilithium::use_hint(a[i], h[i], gamma2);
+    }
+}
+
+bool chknorm(const int32_t a[n], int32_t bound) {
+    bool over = false;
+    for (int i = 0; i < n; i++) {
+        // |a_i| without a branch on the (secret) sign
+        int32_t t = a[i] >> 31;
+        t = a[i] - (t & 2 * a[i]);
+        over |= t >= bound;
+    }
+    return over;
+}
+
+} // namespace scalar
+
+void poly_power2round(Poly &a1, Poly &a0, const Poly &a) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::power2round(a1.coeffs, a0.coeffs, a.coeffs);
+        return;
+    }
+#endif
+    scalar::power2round(a1.coeffs, a0.coeffs, a.coeffs);
+}
+
+void poly_decompose(Poly &a1, Poly &a0, const Poly &a, int32_t gamma2) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::decompose(a1.coeffs, a0.coeffs, a.coeffs, gamma2);
+        return;
+    }
+#endif
+    scalar::decompose(a1.coeffs, a0.coeffs, a.coeffs, gamma2);
+}
+
+void poly_highbits(Poly &a1, const Poly &a, int32_t gamma2) {
+    Poly a0;
+    poly_decompose(a1, a0, a, gamma2);
+}
+
+void poly_lowbits(Poly &a0, const Poly &a, int32_t gamma2) {
+    Poly a1;
+    poly_decompose(a1, a0, a, gamma2);
+}
+
+unsigned poly_make_hint(Poly &h, const Poly &a0, const Poly &a1, int32_t gamma2) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (avx2_enabled()) {
+        return avx2::make_hint(h.coeffs, a0.coeffs, a1.coeffs, gamma2);
+    }
+#endif
+    return scalar::make_hint(h.coeffs, a0.coeffs, a1.coeffs, gamma2);
+}
+
+void poly_use_hint(Poly &b, const Poly &a, const Poly &h, int32_t gamma2) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::use_hint(b.coeffs, a.coeffs, h.coeffs, gamma2);
+        return;
+    }
+#endif
+    scalar::use_hint(b.coeffs, a.coeffs, h.coeffs, gamma2);
+}
+
+bool poly_chknorm(const Poly &a, int32_t bound) {
+#ifdef DILITHIUM_NATIVE_X86
+    if (avx2_enabled()) {
+        return avx2::chknorm(a.coeffs, bound);
+    }
+#endif
+    return scalar::chknorm(a.coeffs, bound);
+}
+
+} // namespace dilithium
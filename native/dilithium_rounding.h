@@ -0,0 +1,99 @@
+#ifndef NATIVE_DILITHIUM_ROUNDING_H
+#define NATIVE_DILITHIUM_ROUNDING_H
+
+#include "dilithium_poly.h"
+
+// Power2Round, Decompose, HighBits/LowBits, MakeHint, UseHint and the infinity-norm
+// check of ML-DSA (FIPS 204 section 7.4), the native counterparts of decompose,
+// highbits, lowbits and inf in complementary.py.
+//
+// gamma2 is (q - 1) / 88 or (q - 1) / 32, the two values ML-DSA uses. Inputs must be
+// standard representatives in [0, q) unless noted otherwise. Every poly_ function has
+// an AVX2 kernel with the same output as the scalar code.
+namespace dilithium {
+
+constexpr int32_t gamma2_88 = (q - 1) / 88;
+constexpr int32_t gamma2_32 = (q - 1) / 32;
+
+// a = a1 * 2^d + a0 with a0 in (-2^(d-1), 2^(d-1)]
+inline int32_t power2round(int32_t &a0, int32_t a) {
+    int32_t a1 = (a + (1 << (d - 1)) - 1) >> d;
+    a0 = a - (a1 << d);
+    return a1;
+}
+
+// a = a1 * 2 * gamma2 + a0 with a0 in (-gamma2, gamma2], except that the top value of
+// a1 wraps to 0 with a0 - 1 (the r - r0 = q - 1 case of complementary.decompose).
+// The division by 2 * gamma2 is a multiply-shift that is exact for a < q.
+inline int32_t decompose(int32_t &a0, int32_t a, int32_t gamma2) {
+    int32_t a1 = (a + 127) >> 7;
+    if (gamma2 == gamma2_32) {
+        a1 = (a1 * 1025 + (1 << 21)) >> 22;
+        a1 &= 15;
+    } else {
+        a1 = (a1 * 11275 + (1 << 23)) >> 24;
+        a1 ^= ((43 - a1) >> 31) & a1;
+    }
+    a0 = a - a1 * 2 * gamma2;
+    a0 -= (((q - 1) / 2 - a0) >> 31) & q;
+    return a1;
+}
+
+// 1 if adding the low part a0 to a value with high part a1 changes the high part
+inline int32_t make_hint(int32_t a0, int32_t a1, int32_t gamma2) {
+    return a0 > gamma2 || a0 < -gamma2 || (a0 == -gamma2 && a1 != 0);
+}
+
+// High part of a corrected by the hint bit
+inline int32_t use_hint(int32_t a, int32_t hint, int32_t gamma2) {
+    int32_t a0;
+    int32_t a1 = decompose(a0, a, gamma2);
+    if (hint == 0) {
+        return a1;
+    }
+    if (gamma2 == gamma2_32) {
+        return a0 > 0 ? (a1 + 1) & 15 : (a1 - 1) & 15;
+    }
+    if (a0 > 0) {
+        return a1 == 43 ? 0 : a1 + 1;
+    }
+    return a1 == 0 ? 43 : a1 - 1;
+}
+
+void poly_power2round(Poly &a1, Poly &a0, const Poly &a);
+void poly_decompose(Poly &a1, Poly &a0, const Poly &a, int32_t gamma2);
+
+// HighBits and LowBits on their own
+void poly_highbits(Poly &a1, const Poly &a, int32_t gamma2);
+void poly_lowbits(Poly &a0, const Poly &a, int32_t gamma2);
+
+// h = MakeHint(a0, a1) coefficient-wise; returns the number of ones
+unsigned poly_make_hint(Poly &h, const Poly &a0, const Poly &a1, int32_t gamma2);
+
+void poly_use_hint(Poly &b, const Poly &a, const Poly &h, int32_t gamma2);
+
+// True if some coefficient has |a_i| >= bound. Coefficients must be reduce32 outputs
+// and bound at most (q - 1) / 8; the time taken does not depend on which one fails.
+bool poly_chknorm(const Poly &a, int32_t bound);
+
+namespace scalar {
+void power2round(int32_t a1[n], int32_t a0[n], const int32_t a[n]);
+void decompose(int32_t a1[n], int32_t a0[n], const int32_t a[n], int32_t gamma2);
+unsigned make_hint(int32_t h[n], const int32_t a0[n], const int32_t a1[n], int32_t gamma2);
+void use_hint(int32_t b[n], const int32_t a[n], const int32_t h[n], int32_t gamma2);
+bool chknorm(const int32_t a[n], int32_t bound);
+}
+
+#ifdef DILITHIUM_NATIVE_X86
+namespace avx2 {
+void power2round(int32_t a1[n], int32_t a0[n], const int32_t a[n]);
+void decompose(int32_t a1[n], int32_t a0[n], const int32_t a[n], int32_t gamma2);
+unsigned make_hint(int32_t h[n], const int32_t a0[n], const int32_t a1[n], int32_t gamma2);
+void use_hint(int32_t b[n], const int32_t a[n], const int32_t h[n], int32_t gamma2);
+bool chknorm(const int32_t a[n], int32_t bound);
+}
+#endif
+
+} // namespace dilithium
+
+#endif // NATIVE_DILITHIUM_ROUNDING_H
@@ -0,0 +1,112 @@
+// AVX2 kernels for the ML-DSA rounding functions and the infinity-norm check.
+//
+// The scalar formulas in dilithium_rounding.h are already branch-free apart from the
+// gamma2 choice and the hint cases, so each kernel is the same arithmetic on 8 lanes
+// with compare masks in place of the conditionals.
+#include "dilithium_rounding.h"
+
+#ifdef DILITHIUM_NATIVE_X86
+
+#include <immintrin.h>
+
+namespace dilithium {
+namespace avx2 {
+namespace {
+
+DILITHIUM_AVX2 inline __m256i load(const int32_t *p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+DILITHIUM_AVX2 inline void store(int32_t *p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+DILITHIUM_AVX2 inline __m256i decompose(__m256i &a0, __m256i a, int32_t gamma2) {
+    __m256i a1 = _mm256_srai_epi32(_mm256_add_epi32(a, _mm256_set1_epi32(127)), 7);
+    if (gamma2 == gamma2_32) {
+        a1 = _mm256_mullo_epi32(a1, _mm256_set1_epi32(1025));
+        a1 = _mm256_srai_epi32(_mm256_add_epi32(a1, _mm256_set1_epi32(1 << 21)), 22);
+        a1 = _mm256_and_si256(a1, _mm256_set1_epi32(15));
+    } else {
+        a1 = _mm256_mullo_epi32(a1, _mm256_set1_epi32(11275));
+        a1 = _mm256_srai_epi32(_mm256_add_epi32(a1, _mm256_set1_epi32(1 << 23)), 24);
+        __m256i wrap = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_set1_epi32(43), a1), 31);
+        a1 = _mm256_xor_si256(a1, _mm256_and_si256(wrap, a1));
+    }
+    a0 = _mm256_sub_epi32(a, _mm256_mullo_epi32(a1, _mm256_set1_epi32(2 * gamma2)));
+    __m256i high = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_set1_epi32((q - 1) / 2), a0), 31);
+    a0 = _mm256_sub_epi32(a0, _mm256_and_si256(high, _mm256_set1_epi32(q)));
+    return a1;
+}
+
+} // namespace
+
+DILITHIUM_AVX2 void power2round(int32_t a1[n], int32_t a0[n], const int32_t a[n]) {
+    const __m256i round = _mm256_set1_epi32((1 << (d - 1)) - 1);
+    for (int i = 0; i < n; i += 8) {
+        __m256i v = load(a + i);
+        __m256i high = _mm256_srai_epi32(_mm256_add_epi32(v, round), d);
+        store(a1 + i, high);
+        store(a0 + i, _mm256_sub_epi32(v, _mm256_slli_epi32(high, d)));
+    }
+}
+
+DILITHIUM_AVX2 void decompose(int32_t a1[n], int32_t a0[n], const int32_t a[n], int32_t gamma2) {
+    for (int i = 0; i < n; i += 8) {
+        __m256i low;
+        store(a1 + i, decompose(low, load(a + i), gamma2));
+        store(a0 + i, low);
+    }
+}
+
+DILITHIUM_AVX2 unsigned make_hint(int32_t h[n], const int32_t a0[n], const int32_t a1[n], int32_t gamma2) {
+    const __m256i bound = _mm256_set1_epi32(gamma2);
+    const __m256i minus_bound = _mm256_set1_epi32(-gamma2);
+    const __m256i zero = _mm256_setzero_si256();
+    unsigned ones = 0;
+    for (int i = 0; i < n; i += 8) {
+        __m256i low = load(a0 + i);
+        __m256i hint = _mm256_or_si256(_mm256_cmpgt_epi32(low, bound), _mm256_cmpgt_epi32(minus_bound, low));
+        __m256i edge = _mm256_andnot_si256(_mm256_cmpeq_epi32(load(a1 + i), zero),
+                                           _mm256_cmpeq_epi32(low, minus_bound));
+        hint = _mm256_or_si256(hint, edge);
+        store(h + i, _mm256_srli_epi32(hint, 31));
+        ones += unsigned(__builtin_popcount(unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(hint)))));
+    }
+    return ones;
+}
+
+DILITHIUM_AVX2 void use_hint(int32_t b[n], const int32_t a[n], const int32_t h[n], int32_t gamma2) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    for (int i = 0; i < n; i += 8) {
+        __m256i low;
+        __m256i high = decompose(low, load(a + i), gamma2);
+        // +1 where a0 > 0, -1 elsewhere, applied only where the hint is set
+        __m256i step = _mm256_blendv_epi8(minus_one, one, _mm256_cmpgt_epi32(low, zero));
+        step = _mm256_and_si256(step, _mm256_cmpgt_epi32(load(h + i), zero));
+        high = _mm256_add_epi32(high, step);
+        if (gamma2 == gamma2_32) {
+            high = _mm256_and_si256(high, _mm256_set1_epi32(15));
+        } else {
+            high = _mm256_andnot_si256(_mm256_cmpeq_epi32(high, _mm256_set1_epi32(44)), high);
+            high = _mm256_blendv_epi8(high, _mm256_set1_epi32(43), _mm256_cmpeq_epi32(high, minus_one));
+        }
+        store(b + i, high);
+    }
+}
+
+DILITHIUM_AVX2 bool chknorm(const int32_t a[n], int32_t bound) {
+    const __m256i limit = _mm256_set1_epi32(bound - 1);
+    __m256i over = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 8) {
+        over = _mm256_or_si256(over, _mm256_cmpgt_epi32(_mm256_abs_epi32(load(a + i)), limit));
+    }
+    return !_mm256_testz_si256(over, over);
+}
+
+} // namespace avx2
+} // namespace dilithium
+
+#endif // DILITHIUM_NATIVE_X86
@@ -0,0 +1,190 @@
+#include "fips202.h"
+
+#include <cstring>
+
+namespace fips202 {
+
+const uint64_t keccak_round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+namespace {
+
+inline uint64_t rotl(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+} // namespace
+
+// Lanes are kept in locals named after their (x, y) position so the compiler can
+// hold the state in registers across the unrolled steps
+void keccak_f1600(uint64_t a[25]) {
+    uint64_t a00 = a[0], a10 = a[1], a20 = a[2], a30 = a[3], a40 = a[4];
+    uint64_t a01 = a[5], a11 = a[6], a21 = a[7], a31 = a[8], a41 = a[9];
+    uint64_t a02 = a[10], a12 = a[11], a22 = a[12], a32 = a[13], a42 = a[14];
+    uint64_t a03 = a[15], a13 = a[16], a23 = a[17], a33 = a[18], a43 = a[19];
+    uint64_t a04 = a[20], a14 = a[21], a24 = a[22], a34 = a[23], a44 = a[24];
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        uint64_t c0 = a00 ^ a01 ^ a02 ^ a03 ^ a04;
+        uint64_t c1 = a10 ^ a11 ^ a12 ^ a13 ^ a14;
+        uint64_t c2 = a20 ^ a21 ^ a22 ^ a23 ^ a24;
+        uint64_t c3 = a30 ^ a31 ^ a32 ^ a33 ^ a34;
+        uint64_t c4 = a40 ^ a41 ^ a42 ^ a43 ^ a44;
+        uint64_t d0 = c4 ^ rotl(c1, 1);
+        uint64_t d1 = c0 ^ rotl(c2, 1);
+        uint64_t d2 = c1 ^ rotl(c3, 1);
+        uint64_t d3 = c2 ^ rotl(c4, 1);
+        uint64_t d4 = c3 ^ rotl(c0, 1);
+
+        // Rho and pi: lane (x, y) moves to (y, 2x + 3y)
+        uint64_t b00 = a00 ^ d0;
+        uint64_t b13 = rotl(a01 ^ d0, 36);
+        uint64_t b21 = rotl(a02 ^ d0, 3);
+        uint64_t b34 = rotl(a03 ^ d0, 41);
+        uint64_t b42 = rotl(a04 ^ d0, 18);
+        uint64_t b02 = rotl(a10 ^ d1, 1);
+        uint64_t b10 = rotl(a11 ^ d1, 44);
+        uint64_t b23 = rotl(a12 ^ d1, 10);
+        uint64_t b31 = rotl(a13 ^ d1, 45);
+        uint64_t b44 = rotl(a14 ^ d1, 2);
+        uint64_t b04 = rotl(a20 ^ d2, 62);
+        uint64_t b12 = rotl(a21 ^ d2, 6);
+        uint64_t b20 = rotl(a22 ^ d2, 43);
+        uint64_t b33 = rotl(a23 ^ d2, 15);
+        uint64_t b41 = rotl(a24 ^ d2, 61);
+        uint64_t b01 = rotl(a30 ^ d3, 28);
+        uint64_t b14 = rotl(a31 ^ d3, 55);
+        uint64_t b22 = rotl(a32 ^ d3, 25);
+        uint64_t b30 = rotl(a33 ^ d3, 21);
+        uint64_t b43 = rotl(a34 ^ d3, 56);
+        uint64_t b03 = rotl(a40 ^ d4, 27);
+        uint64_t b11 = rotl(a41 ^ d4, 20);
+        uint64_t b24 = rotl(a42 ^ d4, 39);
+        uint64_t b32 = rotl(a43 ^ d4, 8);
+        uint64_t b40 = rotl(a44 ^ d4, 14);
+
+        // Chi
+        a00 = b00 ^ (~b10 & b20);
+        a10 = b10 ^ (~b20 & b30);
+        a20 = b20 ^ (~b30 & b40);
+        a30 = b30 ^ (~b40 & b00);
+        a40 = b40 ^ (~b00 & b10);
+        a01 = b01 ^ (~b11 & b21);
+        a11 = b11 ^ (~b21 & b31);
+        a21 = b21 ^ (~b31 & b41);
+        a31 = b31 ^ (~b41 & b01);
+        a41 = b41 ^ (~b01 & b11);
+        a02 = b02 ^ (~b12 & b22);
+        a12 = b12 ^ (~b22 & b32);
+        a22 = b22 ^ (~b32 & b42);
+        a32 = b32 ^ (~b42 & b02);
+        a42 = b42 ^ (~b02 & b12);
+        a03 = b03 ^ (~b13 & b23);
+        a13 = b13 ^ (~b23 & b33);
+        a23 = b23 ^ (~b33 & b43);
+        a33 = b33 ^ (~b43 & b03);
+        a43 = b43 ^ (~b03 & b13);
+        a04 = b04 ^ (~b14 & b24);
+        a14 = b14 ^ (~b24 & b34);
+        a24 = b24 ^ (~b34 & b44);
+        a34 = b34 ^ (~b44 & b04);
+        a44 = b44 ^ (~b04 & b14);
+
+        // Iota
+        a00 ^= keccak_round_constants[round];
+    }
+    a[0] = a00; a[1] = a10; a[2] = a20; a[3] = a30; a[4] = a40;
+    a[5] = a01; a[6] = a11; a[7] = a21; a[8] = a31; a[9] = a41;
+    a[10] = a02; a[11] = a12; a[12] = a22; a[13] = a32; a[14] = a42;
+    a[15] = a03; a[16] = a13; a[17] = a23; a[18] = a33; a[19] = a43;
+    a[20] = a04; a[21] = a14; a[22] = a24; a[23] = a34; a[24] = a44;
+}
+
+Sponge::Sponge(size_t rate, uint8_t domain) : rate_(rate), domain_(domain) {
+    std::memset(state_, 0, sizeof(state_));
+}
+
+void Sponge::absorb(const uint8_t *in, size_t len) {
+    // Whole blocks a word at a time while the sponge is at a block boundary
+    while (pos_ == 0 && len >= rate_) {
+        for (size_t w = 0; w < rate_ / 8; w++) {
+            state_[w] ^= load64(in + 8 * w);
+        }
+        keccak_f1600(state_);
+        in += rate_;
+        len -= rate_;
+    }
+    for (size_t i = 0; i < len; i++) {
+        state_[pos_ / 8] ^= uint64_t(in[i]) << (8 * (pos_ % 8));
+        if (++pos_ == rate_) {
+            keccak_f1600(state_);
+            pos_ = 0;
+        }
+    }
+}
+
+void Sponge::finalize() {
+    state_[pos_ / 8] ^= uint64_t(domain_) << (8 * (pos_ % 8));
+    state_[(rate_ - 1) / 8] ^= uint64_t(0x80) << (8 * ((rate_ - 1) % 8));
+    squeezing_ = true;
+    pos_ = rate_;
+}
+
+void Sponge::squeeze(uint8_t *out, size_t len) {
+    if (!squeezing_) {
+        finalize();
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (pos_ == rate_) {
+            keccak_f1600(state_);
+            pos_ = 0;
+        }
+        out[i] = uint8_t(state_[pos_ / 8] >> (8 * (pos_ % 8)));
+        pos_++;
+    }
+}
+
+void Sponge::squeeze_blocks(uint8_t *out, size_t blocks) {
+    if (!squeezing_) {
+        finalize();
+    }
+    for (size_t b = 0; b < blocks; b++) {
+        keccak_f1600(state_);
+        for (size_t w = 0; w < rate_ / 8; w++) {
+            store64(out + 8 * w, state_[w]);
+        }
+        out += rate_;
+    }
+}
+
+void shake128(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen) {
+    Sponge sponge = shake128();
+    sponge.absorb(in, inlen);
+    sponge.squeeze(out, outlen);
+}
+
+void shake256(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen) {
+    Sponge sponge = shake256();
+    sponge.absorb(in, inlen);
+    sponge.squeeze(out, outlen);
+}
+
+void sha3_256(uint8_t out[32], const uint8_t *in, size_t inlen) {
+    Sponge sponge(sha3_256_rate, 0x06);
+    sponge.absorb(in, inlen);
+    sponge.squeeze(out, 32);
+}
+
+void sha3_512(uint8_t out[64], const uint8_t *in, size_t inlen) {
+    Sponge sponge(sha3_512_rate, 0x06);
+    sponge.absorb(in, inlen);
+    sponge.squeeze(out, 64);
+}
+
+} // namespace fips202
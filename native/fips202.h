@@ -0,0 +1,71 @@
+#ifndef NATIVE_FIPS202_H
+#define NATIVE_FIPS202_H
+
+#include <cstddef>
+#include <cstdint>
+
+// SHA-3 and SHAKE (FIPS 202) for the native lattice engines
+namespace fips202 {
+
+constexpr size_t shake128_rate = 168;
+constexpr size_t shake256_rate = 136;
+constexpr size_t sha3_256_rate = 136;
+constexpr size_t sha3_512_rate = 72;
+
+void keccak_f1600(uint64_t state[25]);
+
+// Iota constants, shared with the 4-way permutation in fips202x4.cpp
+extern const uint64_t keccak_round_constants[24];
+
+// Little-endian 64-bit load and store, written out so the compiler merges the bytes
+// into a single access
+inline uint64_t load64(const uint8_t *p) {
+    return uint64_t(p[0]) | uint64_t(p[1]) << 8 | uint64_t(p[2]) << 16 | uint64_t(p[3]) << 24 |
+           uint64_t(p[4]) << 32 | uint64_t(p[5]) << 40 | uint64_t(p[6]) << 48 | uint64_t(p[7]) << 56;
+}
+
+inline void store64(uint8_t *p, uint64_t x) {
+    p[0] = uint8_t(x);
+    p[1] = uint8_t(x >> 8);
+    p[2] = uint8_t(x >> 16);
+    p[3] = uint8_t(x >> 24);
+    p[4] = uint8_t(x >> 32);
+    p[5] = uint8_t(x >> 40);
+    p[6] = uint8_t(x >> 48);
+    p[7] = uint8_t(x >> 56);
+}
+
+// Incremental sponge: absorb any number of times, then squeeze any number of times
+class Sponge {
+public:
+    Sponge(size_t rate, uint8_t domain);
+
+    void absorb(const uint8_t *in, size_t len);
+    void squeeze(uint8_t *out, size_t len);
+
+    // Squeeze whole blocks straight from the state; only valid before any partial squeeze
+    void squeeze_blocks(uint8_t *out, size_t blocks);
+
+    size_t rate() const { return rate_; }
+
+private:
+    void finalize();
+
+    uint64_t state_[25];
+    size_t rate_;
+    size_t pos_ = 0;
+    uint8_t domain_;
+    bool squeezing_ = false;
+};
+
+inline Sponge shake128() { return Sponge(shake128_rate, 0x1f); }
+inline Sponge shake256() { return Sponge(shake256_rate, 0x1f); }
+
+void shake128(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen);
+void shake256(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen);
+void sha3_256(uint8_t out[32], const uint8_t *in, size_t inlen);
+void sha3_512(uint8_t out[64], const uint8_t *in, size_t inlen);
+
+} // namespace fips202
+
+#endif // NATIVE_FIPS202_H
@@ -0,0 +1,242 @@
+#include "fips202x4.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FIPS202_X86 1
+#include <immintrin.h>
+#endif
+
+namespace fips202 {
+namespace {
+
+#ifdef FIPS202_X86
+
+#define FIPS202_AVX2 __attribute__((target("avx2")))
+
+FIPS202_AVX2 inline __m256i rotl(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+FIPS202_AVX2 inline __m256i xor5(__m256i a, __m256i b, __m256i c, __m256i d, __m256i e) {
+    return _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)), e);
+}
+
+FIPS202_AVX2 inline __m256i load(const uint64_t *p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+FIPS202_AVX2 inline void store(uint64_t *p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+// keccak_f1600 with every uint64_t lane widened to four
+FIPS202_AVX2 void keccak_f1600_avx2(uint64_t s[25][4]) {
+    __m256i a00 = load(s[0]), a10 = load(s[1]), a20 = load(s[2]), a30 = load(s[3]), a40 = load(s[4]);
+    __m256i a01 = load(s[5]), a11 = load(s[6]), a21 = load(s[7]), a31 = load(s[8]), a41 = load(s[9]);
+    __m256i a02 = load(s[10]), a12 = load(s[11]), a22 = load(s[12]), a32 = load(s[13]), a42 = load(s[14]);
+    __m256i a03 = load(s[15]), a13 = load(s[16]), a23 = load(s[17]), a33 = load(s[18]), a43 = load(s[19]);
+    __m256i a04 = load(s[20]), a14 = load(s[21]), a24 = load(s[22]), a34 = load(s[23]), a44 = load(s[24]);
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        __m256i c0 = xor5(a00, a01, a02, a03, a04);
+        __m256i c1 = xor5(a10, a11, a12, a13, a14);
+        __m256i c2 = xor5(a20, a21, a22, a23, a24);
+        __m256i c3 = xor5(a30, a31, a32, a33, a34);
+        __m256i c4 = xor5(a40, a41, a42, a43, a44);
+        __m256i d0 = _mm256_xor_si256(c4, rotl(c1, 1));
+        __m256i d1 = _mm256_xor_si256(c0, rotl(c2, 1));
+        __m256i d2 = _mm256_xor_si256(c1, rotl(c3, 1));
+        __m256i d3 = _mm256_xor_si256(c2, rotl(c4, 1));
+        __m256i d4 = _mm256_xor_si256(c3, rotl(c0, 1));
+
+        // Rho and pi: lane (x, y) moves to (y, 2x + 3y)
+        __m256i b00 = _mm256_xor_si256(a00, d0);
+        __m256i b13 = rotl(_mm256_xor_si256(a01, d0), 36);
+        __m256i b21 = rotl(_mm256_xor_si256(a02, d0), 3);
+        __m256i b34 = rotl(_mm256_xor_si256(a03, d0), 41);
+        __m256i b42 = rotl(_mm256_xor_si256(a04, d0), 18);
+        __m256i b02 = rotl(_mm256_xor_si256(a10, d1), 1);
+        __m256i b10 = rotl(_mm256_xor_si256(a11, d1), 44);
+        __m256i b23 = rotl(_mm256_xor_si256(a12, d1), 10);
+        __m256i b31 = rotl(_mm256_xor_si256(a13, d1), 45);
+        __m256i b44 = rotl(_mm256_xor_si256(a14, d1), 2);
+        __m256i b04 = rotl(_mm256_xor_si256(a20, d2), 62);
+        __m256i b12 = rotl(_mm256_xor_si256(a21, d2), 6);
+        __m256i b20 = rotl(_mm256_xor_si256(a22, d2), 43);
+        __m256i b33 = rotl(_mm256_xor_si256(a23, d2), 15);
+        __m256i b41 = rotl(_mm256_xor_si256(a24, d2), 61);
+        __m256i b01 = rotl(_mm256_xor_si256(a30, d3), 28);
+        __m256i b14 = rotl(_mm256_xor_si256(a31, d3), 55);
+        __m256i b22 = rotl(_mm256_xor_si256(a32, d3), 25);
+        __m256i b30 = rotl(_mm256_xor_si256(a33, d3), 21);
+        __m256i b43 = rotl(_mm256_xor_si256(a34, d3), 56);
+        __m256i b03 = rotl(_mm256_xor_si256(a40, d4), 27);
+        __m256i b11 = rotl(_mm256_xor_si256(a41, d4), 20);
+        __m256i b24 = rotl(_mm256_xor_si256(a42, d4), 39);
+        __m256i b32 = rotl(_mm256_xor_si256(a43, d4), 8);
+        __m256i b40 = rotl(_mm256_xor_si256(a44, d4), 14);
+
+        // Chi
+        a00 = _mm256_xor_si256(b00, _mm256_andnot_si256(b10, b20));
+        a10 = _mm256_xor_si256(b10, _mm256_andnot_si256(b20, b30));
+        a20 = _mm256_xor_si256(b20, _mm256_andnot_si256(b30, b40));
+        a30 = _mm256_xor_si256(b30, _mm256_andnot_si256(b40, b00));
+        a40 = _mm256_xor_si256(b40, _mm256_andnot_si256(b00, b10));
+        a01 = _mm256_xor_si256(b01, _mm256_andnot_si256(b11, b21));
+        a11 = _mm256_xor_si256(b11, _mm256_andnot_si256(b21, b31));
+        a21 = _mm256_xor_si256(b21, _mm256_andnot_si256(b31, b41));
+        a31 = _mm256_xor_si256(b31, _mm256_andnot_si256(b41, b01));
+        a41 = _mm256_xor_si256(b41, _mm256_andnot_si256(b01, b11));
+        a02 = _mm256_xor_si256(b02, _mm256_andnot_si256(b12, b22));
+        a12 = _mm256_xor_si256(b12, _mm256_andnot_si256(b22, b32));
+        a22 = _mm256_xor_si256(b22, _mm256_andnot_si256(b32, b42));
+        a32 = _mm256_xor_si256(b32, _mm256_andnot_si256(b42, b02));
+        a42 = _mm256_xor_si256(b42, _mm256_andnot_si256(b02, b12));
+        a03 = _mm256_xor_si256(b03, _mm256_andnot_si256(b13, b23));
+        a13 = _mm256_xor_si256(b13, _mm256_andnot_si256(b23, b33));
+        a23 = _mm256_xor_si256(b23, _mm256_andnot_si256(b33, b43));
+        a33 = _mm256_xor_si256(b33, _mm256_andnot_si256(b43, b03));
+        a43 = _mm256_xor_si256(b43, _mm256_andnot_si256(b03, b13));
+        a04 = _mm256_xor_si256(b04, _mm256_andnot_si256(b14, b24));
+        a14 = _mm256_xor_si256(b14, _mm256_andnot_si256(b24, b34));
+        a24 = _mm256_xor_si256(b24, _mm256_andnot_si256(b34, b44));
+        a34 = _mm256_xor_si256(b34, _mm256_andnot_si256(b44, b04));
+        a44 = _mm256_xor_si256(b44, _mm256_andnot_si256(b04, b14));
+
+        // Iota
+        a00 = _mm256_xor_si256(a00, _mm256_set1_epi64x(int64_t(keccak_round_constants[round])));
+    }
+    store(s[0], a00); store(s[1], a10); store(s[2], a20); store(s[3], a30); store(s[4], a40);
+    store(s[5], a01); store(s[6], a11); store(s[7], a21); store(s[8], a31); store(s[9], a41);
+    store(s[10], a02); store(s[11], a12); store(s[12], a22); store(s[13], a32); store(s[14], a42);
+    store(s[15], a03); store(s[16], a13); store(s[17], a23); store(s[18], a33); store(s[19], a43);
+    store(s[20], a04); store(s[21], a14); store(s[22], a24); store(s[23], a34); store(s[24], a44);
+}
+
+#endif // FIPS202_X86
+
+bool detect_avx2() {
+#ifdef FIPS202_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const bool use_avx2 = detect_avx2();
+
+} // namespace
+
+void keccak_f1600_x4(uint64_t state[25][4]) {
+#ifdef FIPS202_X86
+    if (use_avx2) {
+        keccak_f1600_avx2(state);
+        return;
+    }
+#endif
+    for (int l = 0; l < 4; l++) {
+        uint64_t lane[25];
+        for (int w = 0; w < 25; w++) {
+            lane[w] = state[w][l];
+        }
+        keccak_f1600(lane);
+        for (int w = 0; w < 25; w++) {
+            state[w][l] = lane[w];
+        }
+    }
+}
+
+bool x4_avx2_enabled() {
+    return use_avx2;
+}
+
+SpongeX4::SpongeX4(size_t rate, uint8_t domain) : rate_(rate), domain_(domain) {
+    std::memset(state_, 0, sizeof(state_));
+}
+
+void SpongeX4::absorb_once(const uint8_t *const in[4], size_t len) {
+    size_t words = rate_ / 8;
+    size_t offset = 0;
+    for (; len - offset >= rate_; offset += rate_) {
+        for (size_t w = 0; w < words; w++) {
+            for (int l = 0; l < 4; l++) {
+                state_[w][l] ^= load64(in[l] + offset + 8 * w);
+            }
+        }
+        keccak_f1600_x4(state_);
+    }
+    len -= offset;
+    for (size_t w = 0; w < len / 8; w++) {
+        for (int l = 0; l < 4; l++) {
+            state_[w][l] ^= load64(in[l] + offset + 8 * w);
+        }
+    }
+    for (size_t i = len / 8 * 8; i < len; i++) {
+        for (int l = 0; l < 4; l++) {
+            state_[i / 8][l] ^= uint64_t(in[l][offset + i]) << (8 * (i % 8));
+        }
+    }
+    for (int l = 0; l < 4; l++) {
+        state_[len / 8][l] ^= uint64_t(domain_) << (8 * (len % 8));
+        state_[(rate_ - 1) / 8][l] ^= uint64_t(0x80) << (8 * ((rate_ - 1) % 8));
+    }
+}
+
+void SpongeX4::squeeze_blocks(uint8_t *const out[4], size_t blocks) {
+    size_t words = rate_ / 8;
+    for (size_t b = 0; b < blocks; b++) {
+        keccak_f1600_x4(state_);
+        for (int l = 0; l < 4; l++) {
+            uint8_t *o = out[l] + b * rate_;
+            for (size_t w = 0; w < words; w++) {
+                store64(o + 8 * w, state_[w][l]);
+            }
+        }
+    }
+}
+
+namespace {
+
+void squeeze_x4(SpongeX4 &sponge, uint8_t *const out[4], size_t outlen) {
+    size_t rate = sponge.rate();
+    size_t full = outlen / rate;
+    sponge.squeeze_blocks(out, full);
+    size_t rest = outlen - full * rate;
+    if (rest > 0) {
+        uint8_t block[4][shake128_rate];
+        uint8_t *const tail[4] = {block[0], block[1], block[2], block[3]};
+        sponge.squeeze_blocks(tail, 1);
+        for (int l = 0; l < 4; l++) {
+            std::memcpy(out[l] + full * rate, block[l], rest);
+        }
+    }
+}
+
+} // namespace
+
+void shake128x4(uint8_t *const out[4], size_t outlen, const uint8_t *const in[4], size_t inlen) {
+    SpongeX4 sponge = shake128x4();
+    sponge.absorb_once(in, inlen);
+    squeeze_x4(sponge, out, outlen);
+}
+
+void shake256x4(uint8_t *const out[4], size_t outlen, const uint8_t *const in[4], size_t inlen) {
+    SpongeX4 sponge = shake256x4();
+    sponge.absorb_once(in, inlen);
+    squeeze_x4(sponge, out, outlen);
+}
+
+void sha3_256x4(uint8_t *const out[4], const uint8_t *const in[4], size_t inlen) {
+    SpongeX4 sponge(sha3_256_rate, 0x06);
+    sponge.absorb_once(in, inlen);
+    squeeze_x4(sponge, out, 32);
+}
+
+void sha3_512x4(uint8_t *const out[4], const uint8_t *const in[4], size_t inlen) {
+    SpongeX4 sponge(sha3_512_rate, 0x06);
+    sponge.absorb_once(in, inlen);
+    squeeze_x4(sponge, out, 64);
+}
+
+} // namespace fips202
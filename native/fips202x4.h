@@ -0,0 +1,49 @@
+#ifndef NATIVE_FIPS202X4_H
+#define NATIVE_FIPS202X4_H
+
+#include <cstddef>
+#include <cstdint>
+#include "fips202.h"
+
+// Four independent SHAKE instances run through one Keccak-f[1600] permutation.
+//
+// Lane l of state word w holds word w of instance l, which is the layout the AVX2
+// permutation works on: one 256-bit register per state word. On CPUs without AVX2
+// the same state is permuted one instance at a time with keccak_f1600.
+namespace fips202 {
+
+void keccak_f1600_x4(uint64_t state[25][4]);
+
+// True when keccak_f1600_x4 uses the AVX2 kernel
+bool x4_avx2_enabled();
+
+class SpongeX4 {
+public:
+    SpongeX4(size_t rate, uint8_t domain);
+
+    // Absorb the four inputs, which must have the same length, and pad
+    void absorb_once(const uint8_t *const in[4], size_t len);
+
+    // Squeeze whole blocks of rate() bytes into each output
+    void squeeze_blocks(uint8_t *const out[4], size_t blocks);
+
+    size_t rate() const { return rate_; }
+
+private:
+    alignas(32) uint64_t state_[25][4];
+    size_t rate_;
+    uint8_t domain_;
+};
+
+inline SpongeX4 shake128x4() { return SpongeX4(shake128_rate, 0x1f); }
+inline SpongeX4 shake256x4() { return SpongeX4(shake256_rate, 0x1f); }
+
+// outlen bytes of SHAKE output for each of four equal-length inputs
+void shake128x4(uint8_t *const out[4], size_t outlen, const uint8_t *const in[4], size_t inlen);
+void shake256x4(uint8_t *const out[4], size_t outlen, const uint8_t *const in[4], size_t inlen);
+void sha3_256x4(uint8_t *const out[4], const uint8_t *const in[4], size_t inlen);
+void sha3_512x4(uint8_t *const out[4], const uint8_t *const in[4], size_t inlen);
+
+} // namespace fips202
+
+#endif // NATIVE_FIPS202X4_H
@@ -0,0 +1,425 @@
+#include "kyber.h"
+
+#include <algorithm>
+#include <cstring>
+#include "fips202.h"
+#include "fips202x4.h"
+#include "kyber_pack.h"
+#include "kyber_sampling.h"
+
+namespace kyber {
+
+const Params kyber512 = {"Kyber512", 2, 3, 2, 10, 4};
+const Params kyber768 = {"Kyber768", 3, 2, 2, 10, 4};
+const Params kyber1024 = {"Kyber1024", 4, 2, 2, 11, 5};
+
+namespace {
+
+const Params *const all_params[] = {&kyber512, &kyber768, &kyber1024};
+
+// The 4-way Keccak only pays off with the AVX2 permutation; disable_avx2() also
+// turns it off so the scalar path stays a complete reference
+bool use_x4() {
+    return avx2_enabled() && fips202::x4_avx2_enabled();
+}
+
+// A[i][j] = Parse(XOF(rho, j, i)), or XOF(rho, i, j) for the transpose. kypher.py
+// parses a fixed 768 bytes; FIPS 203 SampleNTT squeezes three blocks and then one
+// more at a time until all 256 coefficients are filled. With AVX2 four entries are
+// expanded per permutation; spare lanes repeat the last entry into a scratch poly.
+void generate_matrix(PolyVec a[max_k], const uint8_t rho[32], int k, bool transposed, bool fips) {
+    constexpr size_t kypher_bytes = 3 * n;
+    constexpr size_t fips_blocks = 3;
+    constexpr size_t rate = fips202::shake128_rate;
+    int entries = k * k;
+    int lanes = use_x4() ? 4 : 1;
+    Poly spare;
+    for (int first = 0; first < entries; first += lanes) {
+        uint8_t input[4][34];
+        uint8_t buf[4][kypher_bytes];
+        const uint8_t *in[4];
+        uint8_t *out[4];
+        Poly *target[4];
+        for (int l = 0; l < 4; l++) {
+            int e = std::min(first + l, entries - 1);
+            int i = e / k, j = e % k;
+            std::memcpy(input[l], rho, 32);
+            input[l][32] = uint8_t(transposed ? i : j);
+            input[l][33] = uint8_t(transposed ? j : i);
+            in[l] = input[l];
+            out[l] = buf[l];
+            target[l] = first + l < entries ? &a[i].vec[j] : &spare;
+        }
+
+        if (!fips) {
+            if (lanes == 4) {
+                fips202::shake128x4(out, kypher_bytes, in, sizeof(input[0]));
+            } else {
+                fips202::shake128(buf[0], kypher_bytes, input[0], sizeof(input[0]));
+            }
+            for (int l = 0; l < lanes; l++) {
+                parse(*target[l], buf[l], kypher_bytes);
+            }
+            continue;
+        }
+
+        unsigned count[4];
+        if (lanes == 4) {
+            fips202::SpongeX4 xof = fips202::shake128x4();
+            xof.absorb_once(in, sizeof(input[0]));
+            xof.squeeze_blocks(out, fips_blocks);
+            for (int l = 0; l < 4; l++) {
+                count[l] = rej_uniform(target[l]->coeffs, n, buf[l], fips_blocks * rate);
+            }
+            while (*std::min_element(count, count + 4) < unsigned(n)) {
+                xof.squeeze_blocks(out, 1);
+                for (int l = 0; l < 4; l++) {
+                    count[l] += rej_uniform(target[l]->coeffs + count[l], n - count[l], buf[l], rate);
+                }
+            }
+        } else {
+            fips202::Sponge xof = fips202::shake128();
+            xof.absorb(input[0], sizeof(input[0]));
+            xof.squeeze_blocks(buf[0], fips_blocks);
+            count[0] = rej_uniform(target[0]->coeffs, n, buf[0], fips_blocks * rate);
+            while (count[0] < unsigned(n)) {
+                xof.squeeze_blocks(buf[0], 1);
+                count[0] += rej_uniform(target[0]->coeffs + count[0], n - count[0], buf[0], rate);
+            }
+        }
+    }
+}
+
+struct NoiseTarget {
+    Poly *poly;
+    int eta;
+    const uint8_t *seed;
+    uint8_t nonce;
+};
+
+// Each target gets CBD(PRF(seed, nonce)) from 64 * eta bytes of SHAKE256 output,
+// four targets per permutation with AVX2
+void sample_noise(const NoiseTarget *targets, int count) {
+    constexpr size_t buflen = 64 * 3;
+    int lanes = use_x4() ? 4 : 1;
+    for (int first = 0; first < count; first += lanes) {
+        uint8_t input[4][33];
+        uint8_t buf[4][buflen];
+        const uint8_t *in[4];
+        uint8_t *out[4];
+        size_t outlen = 0;
+        for (int l = 0; l < 4; l++) {
+            const NoiseTarget &t = targets[std::min(first + l, count - 1)];
+            std::memcpy(input[l], t.seed, 32);
+            input[l][32] = t.nonce;
+            in[l] = input[l];
+            out[l] = buf[l];
+            outlen = std::max(outlen, size_t(64 * t.eta));
+        }
+        if (lanes == 4) {
+            fips202::shake256x4(out, outlen, in, sizeof(input[0]));
+        } else {
+            fips202::shake256(buf[0], outlen, input[0], sizeof(input[0]));
+        }
+        for (int l = 0; l < lanes && first + l < count; l++) {
+            cbd(*targets[first + l].poly, buf[l], targets[first + l].eta);
+        }
+    }
+}
+
+// Noise of one encryption: r (eta1), e1 and e2 (eta2) with nonces 0 .. 2k
+int encryption_noise(NoiseTarget *targets, const Params &params, const uint8_t coins[32],
+                     PolyVec &r, PolyVec &e1, Poly &e2) {
+    int k = params.k;
+    for (int i = 0; i < k; i++) {
+        targets[i] = {&r.vec[i], params.eta1, coins, uint8_t(i)};
+        targets[k + i] = {&e1.vec[i], params.eta2, coins, uint8_t(k + i)};
+    }
+    targets[2 * k] = {&e2, params.eta2, coins, uint8_t(2 * k)};
+    return 2 * k + 1;
+}
+
+// sum_j a[j] * b[j] in the NTT domain, scaled by 2^-16 and reduced
+void basemul_accumulate(Poly &r, const PolyVec &a, const PolyVec &b, int k) {
+    Poly t;
+    poly_basemul_montgomery(r, a.vec[0], b.vec[0]);
+    for (int j = 1; j < k; j++) {
+        poly_basemul_montgomery(t, a.vec[j], b.vec[j]);
+        poly_add(r, r, t);
+    }
+    poly_reduce(r);
+}
+
+// Encryption once the matrix, t and the noise are known; r is consumed
+void encrypt_with_noise(const Params &params, uint8_t *ct, const PolyVec at[max_k], const PolyVec &t,
+                        const uint8_t msg[32], PolyVec &r, const PolyVec &e1, const Poly &e2) {
+    int k = params.k;
+    PolyVec u;
+    Poly m, v;
+    poly_decompress(m, msg, 1);
+    for (int i = 0; i < k; i++) {
+        poly_ntt(r.vec[i]);
+        poly_reduce(r.vec[i]);
+    }
+
+    // u = A^T * r + e1, v = t^T * r + e2 + m
+    for (int i = 0; i < k; i++) {
+        basemul_accumulate(u.vec[i], at[i], r, k);
+        poly_invntt(u.vec[i], mont_inv128);
+        poly_add(u.vec[i], u.vec[i], e1.vec[i]);
+        poly_reduce(u.vec[i]);
+        poly_canonical(u.vec[i]);
+        poly_compress(ct + 32 * params.du * i, u.vec[i], params.du);
+    }
+    basemul_accumulate(v, t, r, k);
+    poly_invntt(v, mont_inv128);
+    poly_add(v, v, e2);
+    poly_add(v, v, m);
+    poly_reduce(v);
+    poly_canonical(v);
+    poly_compress(ct + 32 * params.du * k, v, params.dv);
+}
+
+} // namespace
+
+const Params *params_by_name(const std::string &name) {
+    for (const Params *params : all_params) {
+        if (name == params->name) {
+            return params;
+        }
+    }
+    return nullptr;
+}
+
+const Params *params_by_public_key(size_t length) {
+    for (const Params *params : all_params) {
+        if (length == params->public_key_bytes()) {
+            return params;
+        }
+    }
+    return nullptr;
+}
+
+const Params *params_by_secret_key(size_t length) {
+    for (const Params *params : all_params) {
+        if (length == params->secret_key_bytes()) {
+            return params;
+        }
+    }
+    return nullptr;
+}
+
+void ntt(Poly &a) {
+    poly_reduce(a);
+    poly_ntt(a);
+    poly_reduce(a);
+    poly_canonical(a);
+}
+
+void intt(Poly &a) {
+    poly_reduce(a);
+    poly_invntt(a, inv128);
+    poly_canonical(a);
+}
+
+void pointwise(Poly &r, const Poly &a, const Poly &b) {
+    Poly x = a, y = b;
+    poly_reduce(x);
+    poly_reduce(y);
+    poly_basemul_montgomery(r, x, y);
+    poly_tomont(r);
+    poly_canonical(r);
+}
+
+void multiply(Poly &r, const Poly &a, const Poly &b) {
+    Poly x = a, y = b;
+    ntt(x);
+    ntt(y);
+    poly_basemul_montgomery(r, x, y);
+    poly_reduce(r);
+    // The Montgomery factor of the product is cancelled by the one the inverse adds
+    poly_invntt(r, mont_inv128);
+    poly_canonical(r);
+}
+
+void parse(Poly &r, const uint8_t *bytes, size_t len) {
+    // kypher.py loops while i + 3 < len(b), so the last full group is never used
+    size_t usable = len == 0 ? 0 : (len - 1) / 3 * 3;
+    unsigned count = rej_uniform(r.coeffs, n, bytes, usable);
+    std::memset(r.coeffs + count, 0, (n - count) * sizeof(int16_t));
+}
+
+void keygen(const Params &params, uint8_t *pk, uint8_t *sk, const uint8_t seed[32]) {
+    int k = params.k;
+    uint8_t rho_sigma[64];
+    fips202::sha3_512(rho_sigma, seed, 32);
+    const uint8_t *rho = rho_sigma;
+    const uint8_t *sigma = rho_sigma + 32;
+
+    PolyVec a[max_k], s, e, t;
+    generate_matrix(a, rho, k, false, false);
+
+    NoiseTarget noise[2 * max_k] = {};
+    for (int i = 0; i < k; i++) {
+        noise[i] = {&s.vec[i], params.eta1, sigma, uint8_t(i)};
+        noise[k + i] = {&e.vec[i], params.eta1, sigma, uint8_t(k + i)};
+    }
+    sample_noise(noise, 2 * k);
+    for (int i = 0; i < k; i++) {
+        poly_ntt(s.vec[i]);
+        poly_reduce(s.vec[i]);
+        poly_ntt(e.vec[i]);
+    }
+
+    // t = A * s + e in the NTT domain
+    for (int i = 0; i < k; i++) {
+        basemul_accumulate(t.vec[i], a[i], s, k);
+        poly_tomont(t.vec[i]);
+        poly_add(t.vec[i], t.vec[i], e.vec[i]);
+        poly_reduce(t.vec[i]);
+        poly_canonical(t.vec[i]);
+        poly_canonical(s.vec[i]);
+    }
+
+    for (int i = 0; i < k; i++) {
+        poly_encode(pk + 384 * i, t.vec[i], 12);
+        poly_encode(sk + 384 * i, s.vec[i], 12);
+    }
+    std::memcpy(pk + 384 * k, rho, 32);
+    std::memset(rho_sigma, 0, sizeof(rho_sigma));
+}
+
+void encrypt(const Params &params, uint8_t *ct, const uint8_t *pk, const uint8_t msg[32], const uint8_t coins[32]) {
+    PolyVec at[max_k], t, r, e1;
+    Poly e2;
+    for (int i = 0; i < params.k; i++) {
+        poly_decode(t.vec[i], pk + 384 * i, 12);
+    }
+    generate_matrix(at, pk + 384 * params.k, params.k, true, false);
+
+    NoiseTarget noise[2 * max_k + 1];
+    sample_noise(noise, encryption_noise(noise, params, coins, r, e1, e2));
+    encrypt_with_noise(params, ct, at, t, msg, r, e1, e2);
+}
+
+void decrypt(const Params &params, uint8_t msg[32], const uint8_t *ct, const uint8_t *sk) {
+    int k = params.k;
+    PolyVec u, s;
+    Poly v, mp;
+
+    for (int i = 0; i < k; i++) {
+        poly_decompress(u.vec[i], ct + 32 * params.du * i, params.du);
+        poly_ntt(u.vec[i]);
+        poly_reduce(u.vec[i]);
+        poly_decode(s.vec[i], sk + 384 * i, 12);
+    }
+    poly_decompress(v, ct + 32 * params.du * k, params.dv);
+
+    // m = v - s^T * u
+    basemul_accumulate(mp, s, u, k);
+    poly_invntt(mp, mont_inv128);
+    poly_sub(mp, v, mp);
+    poly_reduce(mp);
+    poly_canonical(mp);
+    poly_compress(msg, mp, 1);
+}
+
+namespace mlkem {
+
+namespace {
+
+const Params ml_kem_512 = {"ML-KEM-512", 2, 3, 2, 10, 4};
+const Params ml_kem_768 = {"ML-KEM-768", 3, 2, 2, 10, 4};
+const Params ml_kem_1024 = {"ML-KEM-1024", 4, 2, 2, 11, 5};
+
+const Params *const all_params[] = {&ml_kem_512, &ml_kem_768, &ml_kem_1024};
+
+// (K, r) = G(m || H(ek)) for up to four encapsulations, out[i] taking 64 bytes
+void derive(uint8_t (*out)[64], const EncapsulationKey *const keys[], const uint8_t *m, size_t count) {
+    uint8_t input[4][64];
+    for (size_t l = 0; l < count; l++) {
+        std::memcpy(input[l], m + 32 * l, 32);
+        std::memcpy(input[l] + 32, keys[l]->hash, 32);
+    }
+    if (count > 1 && use_x4()) {
+        const uint8_t *in[4];
+        uint8_t *outs[4];
+        uint8_t spare[64];
+        for (size_t l = 0; l < 4; l++) {
+            in[l] = input[std::min(l, count - 1)];
+            outs[l] = l < count ? out[l] : spare;
+        }
+        fips202::sha3_512x4(outs, in, 64);
+    } else {
+        for (size_t l = 0; l < count; l++) {
+            fips202::sha3_512(out[l], input[l], 64);
+        }
+    }
+    std::memset(input, 0, sizeof(input));
+}
+
+} // namespace
+
+const Params *params_by_name(const std::string &name) {
+    for (const Params *params : all_params) {
+        if (name == params->name) {
+            return params;
+        }
+    }
+    return nullptr;
+}
+
+bool load_encapsulation_key(EncapsulationKey &key, const Params &params, const uint8_t *ek, size_t len) {
+    if (len != params.public_key_bytes()) {
+        return false;
+    }
+    // ByteDecode_12 of each 384-byte block must give values below q, i.e. re-encode to the same bytes
+    for (int i = 0; i < params.k; i++) {
+        poly_decode(key.t.vec[i], ek + 384 * i, 12);
+        for (int j = 0; j < n; j++) {
+            if (key.t.vec[i].coeffs[j] >= q) {
+                return false;
+            }
+        }
+    }
+    generate_matrix(key.at, ek + 384 * params.k, params.k, true, true);
+    fips202::sha3_256(key.hash, ek, len);
+    key.params = &params;
+    return true;
+}
+
+void encaps(const EncapsulationKey &key, uint8_t *ct, uint8_t ss[32], const uint8_t m[32]) {
+    const EncapsulationKey *keys[1] = {&key};
+    encaps_batch(keys, 1, ct, ss, m);
+}
+
+void encaps_batch(const EncapsulationKey *const keys[], size_t count, uint8_t *ct, uint8_t *ss, const uint8_t *m) {
+    uint8_t *c = ct;
+    for (size_t first = 0; first < count; first += 4) {
+        size_t lanes = std::min<size_t>(4, count - first);
+        uint8_t kr[4][64];
+        derive(kr, keys + first, m + 32 * first, lanes);
+
+        // The noise of all lanes in one list, so the PRF calls fill the 4-way Keccak
+        PolyVec r[4], e1[4];
+        Poly e2[4];
+        NoiseTarget noise[4 * (2 * max_k + 1)];
+        int targets = 0;
+        for (size_t l = 0; l < lanes; l++) {
+            targets += encryption_noise(noise + targets, *keys[first + l]->params, kr[l] + 32, r[l], e1[l], e2[l]);
+        }
+        sample_noise(noise, targets);
+
+        for (size_t l = 0; l < lanes; l++) {
+            const EncapsulationKey &key = *keys[first + l];
+            encrypt_with_noise(*key.params, c, key.at, key.t, m + 32 * (first + l), r[l], e1[l], e2[l]);
+            c += key.params->ciphertext_bytes();
+            std::memcpy(ss + 32 * (first + l), kr[l], 32);
+        }
+        std::memset(kr, 0, sizeof(kr));
+    }
+}
+
+} // namespace mlkem
+
+} // namespace kyber
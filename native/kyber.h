@@ -0,0 +1,105 @@
+#ifndef NATIVE_KYBER_H
+#define NATIVE_KYBER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "kyber_poly.h"
+
+// Native port of the Kyber reference code in kypher.py.
+//
+// The polynomial functions take coefficients as any int16 values and return them
+// in [0, q), like the Python versions. keygen/encrypt/decrypt are the round 3
+// IND-CPA scheme of kypher.py (Algorithms 4-6) and produce the same bytes for the
+// same seeds, so the two implementations can be checked against each other.
+namespace kyber {
+
+struct Params {
+    const char *name;
+    int k;
+    int eta1;
+    int eta2;
+    int du;
+    int dv;
+
+    size_t public_key_bytes() const { return 384 * k + 32; }
+    size_t secret_key_bytes() const { return 384 * k; }
+    size_t ciphertext_bytes() const { return 32 * (du * k + dv); }
+};
+
+constexpr int max_k = 4;
+
+struct PolyVec {
+    Poly vec[max_k];
+};
+
+extern const Params kyber512;   // k = 2, the parameters used by kypher.py
+extern const Params kyber768;
+extern const Params kyber1024;
+
+// Parameter set by name ("Kyber512", ...) or by key/ciphertext length; nullptr if none matches
+const Params *params_by_name(const std::string &name);
+const Params *params_by_public_key(size_t length);
+const Params *params_by_secret_key(size_t length);
+
+// NTT_kyber: forward transform, output in bit-reversed order
+void ntt(Poly &a);
+
+// INTT_kyber: inverse transform back to standard order
+void intt(Poly &a);
+
+// pointwise: product of two polynomials in the NTT domain
+void pointwise(Poly &r, const Poly &a, const Poly &b);
+
+// KyberConvolution: product of two polynomials in standard order
+void multiply(Poly &r, const Poly &a, const Poly &b);
+
+// Parse: uniform polynomial from XOF output, with kypher.py's bound on the input
+// (only 3-byte groups followed by at least one more byte are used; missing
+// coefficients stay 0)
+void parse(Poly &r, const uint8_t *bytes, size_t len);
+
+// Key generation from the 32-byte seed d; pk takes public_key_bytes(), sk secret_key_bytes()
+void keygen(const Params &params, uint8_t *pk, uint8_t *sk, const uint8_t seed[32]);
+
+// Encrypt a 32-byte message with the 32-byte random coins into ciphertext_bytes()
+void encrypt(const Params &params, uint8_t *ct, const uint8_t *pk, const uint8_t msg[32], const uint8_t coins[32]);
+
+void decrypt(const Params &params, uint8_t msg[32], const uint8_t *ct, const uint8_t *sk);
+
+// FIPS 203 ML-KEM encapsulation on the same kernels. It differs from the scheme above
+// in SampleNTT, which squeezes the XOF until all 256 coefficients are filled, and in
+// Encaps deriving the coins and the shared secret from G(m || H(ek)).
+namespace mlkem {
+
+constexpr size_t shared_secret_bytes = 32;
+
+// "ML-KEM-512", "ML-KEM-768" or "ML-KEM-1024" as named by liboqs; nullptr otherwise
+const Params *params_by_name(const std::string &name);
+
+// An encapsulation key decoded once for any number of encapsulations
+struct EncapsulationKey {
+    const Params *params = nullptr;
+    PolyVec t;
+    PolyVec at[max_k];  // transposed matrix, in the NTT domain
+    uint8_t hash[32];   // H(ek)
+};
+
+// Decode ek and expand its matrix. False if the length is not public_key_bytes() or
+// the modulus check of FIPS 203 section 7.2 fails (a coefficient of t >= q).
+bool load_encapsulation_key(EncapsulationKey &key, const Params &params, const uint8_t *ek, size_t len);
+
+// Encapsulate with the 32-byte random m: ct takes ciphertext_bytes(), ss 32 bytes
+void encaps(const EncapsulationKey &key, uint8_t *ct, uint8_t ss[32], const uint8_t m[32]);
+
+// count encapsulations, keys[i] with m + 32 * i. Ciphertexts are written one after
+// another to ct and shared secrets to ss + 32 * i. Four are processed together so G
+// and the noise PRFs of different encapsulations share each 4-way Keccak
+// permutation; keys may repeat or differ.
+void encaps_batch(const EncapsulationKey *const keys[], size_t count, uint8_t *ct, uint8_t *ss, const uint8_t *m);
+
+} // namespace mlkem
+
+} // namespace kyber
+
+#endif // NATIVE_KYBER_H
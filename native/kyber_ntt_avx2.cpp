@@ -0,0 +1,244 @@
+// AVX2 kernels for the Kyber NTT, inverse NTT and base multiplication.
+//
+// Each function is compiled for AVX2 through a target attribute, so the rest of the
+// build keeps its baseline flags and kyber_poly.cpp only calls in here after checking
+// the CPU. The arithmetic is the scalar reference code on 16 lanes: the Montgomery
+// and Barrett steps give bit-identical results to their scalar counterparts.
+#include "kyber_poly.h"
+
+#ifdef KYBER_NATIVE_X86
+
+#include <immintrin.h>
+
+namespace kyber {
+namespace avx2 {
+namespace {
+
+// Zeta vectors for the layers whose butterflies are shorter than a register
+// (len = 8, 4 and 2). Entry [layer][i] holds the zetas for coefficients 32i..32i+31
+// in the lane order produced by the shuffles below, plus the same values times qinv.
+// Built by the compiler from the constexpr zeta table.
+struct SmallLayerZetas {
+    alignas(32) int16_t forward[3][8][16] = {};
+    alignas(32) int16_t forward_qinv[3][8][16] = {};
+    alignas(32) int16_t inverse[3][8][16] = {};
+    alignas(32) int16_t inverse_qinv[3][8][16] = {};
+    // zeta in the odd lanes of each coefficient pair, for basemul
+    alignas(32) int16_t basemul[n] = {};
+    alignas(32) int16_t basemul_qinv[n] = {};
+
+    constexpr SmallLayerZetas() {
+        // Block of each lane after the shuffle of the len = 8, 4 and 2 layers,
+        // relative to the first block of the 32 coefficients
+        constexpr int lane_block[3][16] = {
+            {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1},
+            {0, 0, 0, 0, 2, 2, 2, 2, 1, 1, 1, 1, 3, 3, 3, 3},
+            {0, 0, 4, 4, 1, 1, 5, 5, 2, 2, 6, 6, 3, 3, 7, 7},
+        };
+        for (int layer = 0; layer < 3; layer++) {
+            int len = 8 >> layer;
+            int blocks = 128 / len;
+            for (int i = 0; i < 8; i++) {
+                int first_block = i * 32 / (2 * len);
+                for (int lane = 0; lane < 16; lane++) {
+                    int block = first_block + lane_block[layer][lane];
+                    int16_t forward_zeta = zetas[blocks + block];
+                    int16_t inverse_zeta = zetas[2 * blocks - 1 - block];
+                    forward[layer][i][lane] = forward_zeta;
+                    forward_qinv[layer][i][lane] = int16_t(forward_zeta * qinv);
+                    inverse[layer][i][lane] = inverse_zeta;
+                    inverse_qinv[layer][i][lane] = int16_t(inverse_zeta * qinv);
+                }
+            }
+        }
+        for (int pair = 0; pair < n / 2; pair++) {
+            int16_t zeta = pair % 2 == 0 ? zetas[64 + pair / 2] : -zetas[64 + pair / 2];
+            basemul[2 * pair] = 0;
+            basemul[2 * pair + 1] = zeta;
+            basemul_qinv[2 * pair] = 0;
+            basemul_qinv[2 * pair + 1] = int16_t(zeta * qinv);
+        }
+    }
+};
+
+constexpr SmallLayerZetas small_layer_zetas;
+
+// Montgomery product a * b * 2^-16, with b_qinv = b * qinv mod 2^16
+KYBER_AVX2 inline __m256i fqmul(__m256i a, __m256i b, __m256i b_qinv) {
+    const __m256i q_vec = _mm256_set1_epi16(q);
+    __m256i lo = _mm256_mullo_epi16(a, b_qinv);
+    __m256i hi = _mm256_mulhi_epi16(a, b);
+    lo = _mm256_mulhi_epi16(lo, q_vec);
+    return _mm256_sub_epi16(hi, lo);
+}
+
+// Same rounding as the scalar barrett_reduce: mulhrs by 2^5 adds 2^25 before the shift by 26
+KYBER_AVX2 inline __m256i barrett_reduce(__m256i a) {
+    const __m256i v = _mm256_set1_epi16(((1 << 26) + q / 2) / q);
+    __m256i t = _mm256_mulhi_epi16(a, v);
+    t = _mm256_mulhrs_epi16(t, _mm256_set1_epi16(1 << 5));
+    t = _mm256_mullo_epi16(t, _mm256_set1_epi16(q));
+    return _mm256_sub_epi16(a, t);
+}
+
+// Cooley-Tukey butterfly: (x, y) -> (x + zeta*y, x - zeta*y)
+KYBER_AVX2 inline void ct_butterfly(__m256i &x, __m256i &y, __m256i zeta, __m256i zeta_qinv) {
+    __m256i t = fqmul(y, zeta, zeta_qinv);
+    y = _mm256_sub_epi16(x, t);
+    x = _mm256_add_epi16(x, t);
+}
+
+// Gentleman-Sande butterfly: (x, y) -> (reduce(x + y), zeta*(y - x))
+KYBER_AVX2 inline void gs_butterfly(__m256i &x, __m256i &y, __m256i zeta, __m256i zeta_qinv) {
+    __m256i t = x;
+    x = barrett_reduce(_mm256_add_epi16(t, y));
+    y = fqmul(_mm256_sub_epi16(y, t), zeta, zeta_qinv);
+}
+
+// Split two registers into the first and second halves of butterflies of length
+// 8, 4 or 2 and back. Each pair of functions is its own inverse pattern.
+KYBER_AVX2 inline void split8(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_permute2x128_si256(a, b, 0x20);
+    y = _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+KYBER_AVX2 inline void split4(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_unpacklo_epi64(a, b);
+    y = _mm256_unpackhi_epi64(a, b);
+}
+
+KYBER_AVX2 inline void split2(__m256i a, __m256i b, __m256i &x, __m256i &y) {
+    x = _mm256_blend_epi32(a, _mm256_slli_epi64(b, 32), 0xaa);
+    y = _mm256_blend_epi32(_mm256_srli_epi64(a, 32), b, 0xaa);
+}
+
+KYBER_AVX2 inline void merge2(__m256i x, __m256i y, __m256i &a, __m256i &b) {
+    a = _mm256_blend_epi32(x, _mm256_slli_epi64(y, 32), 0xaa);
+    b = _mm256_blend_epi32(_mm256_srli_epi64(x, 32), y, 0xaa);
+}
+
+KYBER_AVX2 inline __m256i load(const int16_t *p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+KYBER_AVX2 inline void store(int16_t *p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+// Swap the two coefficients of every pair
+KYBER_AVX2 inline __m256i swap_pairs(__m256i v) {
+    return _mm256_or_si256(_mm256_slli_epi32(v, 16), _mm256_srli_epi32(v, 16));
+}
+
+} // namespace
+
+KYBER_AVX2 void ntt(int16_t r[n]) {
+    const SmallLayerZetas &table = small_layer_zetas;
+
+    // Layers with butterflies of 16 coefficients or more use one zeta per register
+    unsigned k = 1;
+    for (unsigned len = 128; len >= 16; len >>= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            __m256i zeta = _mm256_set1_epi16(zetas[k]);
+            __m256i zeta_qinv = _mm256_set1_epi16(int16_t(zetas[k] * qinv));
+            k++;
+            for (unsigned j = start; j < start + len; j += 16) {
+                __m256i x = load(r + j), y = load(r + j + len);
+                ct_butterfly(x, y, zeta, zeta_qinv);
+                store(r + j, x);
+                store(r + j + len, y);
+            }
+        }
+    }
+
+    // Layers len = 8, 4, 2 on 32 coefficients at a time
+    for (unsigned i = 0; i < 8; i++) {
+        int16_t *p = r + 32 * i;
+        __m256i a = load(p), b = load(p + 16), x, y;
+
+        split8(a, b, x, y);
+        ct_butterfly(x, y, load(table.forward[0][i]), load(table.forward_qinv[0][i]));
+        split8(x, y, a, b);
+
+        split4(a, b, x, y);
+        ct_butterfly(x, y, load(table.forward[1][i]), load(table.forward_qinv[1][i]));
+        split4(x, y, a, b);
+
+        split2(a, b, x, y);
+        ct_butterfly(x, y, load(table.forward[2][i]), load(table.forward_qinv[2][i]));
+        merge2(x, y, a, b);
+
+        store(p, a);
+        store(p + 16, b);
+    }
+}
+
+KYBER_AVX2 void invntt(int16_t r[n], int16_t factor) {
+    const SmallLayerZetas &table = small_layer_zetas;
+
+    for (unsigned i = 0; i < 8; i++) {
+        int16_t *p = r + 32 * i;
+        __m256i a = load(p), b = load(p + 16), x, y;
+
+        split2(a, b, x, y);
+        gs_butterfly(x, y, load(table.inverse[2][i]), load(table.inverse_qinv[2][i]));
+        merge2(x, y, a, b);
+
+        split4(a, b, x, y);
+        gs_butterfly(x, y, load(table.inverse[1][i]), load(table.inverse_qinv[1][i]));
+        split4(x, y, a, b);
+
+        split8(a, b, x, y);
+        gs_butterfly(x, y, load(table.inverse[0][i]), load(table.inverse_qinv[0][i]));
+        split8(x, y, a, b);
+
+        store(p, a);
+        store(p + 16, b);
+    }
+
+    for (unsigned len = 16; len <= 128; len <<= 1) {
+        unsigned blocks = 128 / len;
+        for (unsigned block = 0; block < blocks; block++) {
+            int16_t z = zetas[2 * blocks - 1 - block];
+            __m256i zeta = _mm256_set1_epi16(z);
+            __m256i zeta_qinv = _mm256_set1_epi16(int16_t(z * qinv));
+            unsigned start = block * 2 * len;
+            for (unsigned j = start; j < start + len; j += 16) {
+                __m256i x = load(r + j), y = load(r + j + len);
+                gs_butterfly(x, y, zeta, zeta_qinv);
+                store(r + j, x);
+                store(r + j + len, y);
+            }
+        }
+    }
+
+    __m256i f = _mm256_set1_epi16(factor);
+    __m256i f_qinv = _mm256_set1_epi16(int16_t(factor * qinv));
+    for (unsigned j = 0; j < n; j += 16) {
+        store(r + j, fqmul(load(r + j), f, f_qinv));
+    }
+}
+
+KYBER_AVX2 void basemul_montgomery(int16_t r[n], const int16_t a[n], const int16_t b[n]) {
+    const SmallLayerZetas &table = small_layer_zetas;
+    for (unsigned j = 0; j < n; j += 16) {
+        __m256i x = load(a + j), y = load(b + j);
+
+        // Even lanes: a0*b0, odd lanes: a1*b1
+        __m256i same = fqmul(x, y, _mm256_mullo_epi16(y, _mm256_set1_epi16(qinv)));
+        // Even lanes: a0*b1, odd lanes: a1*b0
+        __m256i y_swapped = swap_pairs(y);
+        __m256i cross = fqmul(x, y_swapped, _mm256_mullo_epi16(y_swapped, _mm256_set1_epi16(qinv)));
+        // Odd lanes: a1*b1*zeta
+        __m256i twisted = fqmul(same, load(table.basemul + j), load(table.basemul_qinv + j));
+
+        __m256i even = _mm256_add_epi16(same, swap_pairs(twisted));
+        __m256i odd = _mm256_add_epi16(cross, swap_pairs(cross));
+        store(r + j, _mm256_blend_epi16(even, odd, 0xaa));
+    }
+}
+
+} // namespace avx2
+} // namespace kyber
+
+#endif // KYBER_NATIVE_X86
@@ -0,0 +1,93 @@
+#include "kyber_pack.h"
+
+namespace kyber {
+
+namespace scalar {
+
+void poly_encode(uint8_t *out, const Poly &a, int bits) {
+    uint32_t buffer = 0;
+    int buffered = 0;
+    for (int i = 0; i < n; i++) {
+        buffer |= uint32_t(uint16_t(a.coeffs[i]) & ((1u << bits) - 1)) << buffered;
+        buffered += bits;
+        while (buffered >= 8) {
+            *out++ = uint8_t(buffer);
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+}
+
+void poly_decode(Poly &r, const uint8_t *in, int bits) {
+    uint32_t buffer = 0;
+    int buffered = 0;
+    for (int i = 0; i < n; i++) {
+        while (buffered < bits) {
+            buffer |= uint32_t(*in++) << buffered;
+            buffered += 8;
+        }
+        r.coeffs[i] = int16_t(buffer & ((1u << bits) - 1));
+        buffer >>= bits;
+        buffered -= bits;
+    }
+}
+
+void poly_compress(uint8_t *out, const Poly &a, int d) {
+    Poly t;
+    for (int i = 0; i < n; i++) {
+        uint64_t v = (uint32_t(a.coeffs[i]) << d) + q / 2;
+        t.coeffs[i] = int16_t(((v * div_q_multiplier) >> div_q_shift) & ((1u << d) - 1));
+    }
+    scalar::poly_encode(out, t, d);
+}
+
+void poly_decompress(Poly &r, const uint8_t *in, int d) {
+    scalar::poly_decode(r, in, d);
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = int16_t((uint32_t(r.coeffs[i]) * q + (1u << (d - 1))) >> d);
+    }
+}
+
+} // namespace scalar
+
+void poly_encode(uint8_t *out, const Poly &a, int bits) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::poly_encode(out, a, bits);
+        return;
+    }
+#endif
+    scalar::poly_encode(out, a, bits);
+}
+
+void poly_decode(Poly &r, const uint8_t *in, int bits) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::poly_decode(r, in, bits);
+        return;
+    }
+#endif
+    scalar::poly_decode(r, in, bits);
+}
+
+void poly_compress(uint8_t *out, const Poly &a, int d) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::poly_compress(out, a, d);
+        return;
+    }
+#endif
+    scalar::poly_compress(out, a, d);
+}
+
+void poly_decompress(Poly &r, const uint8_t *in, int d) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::poly_decompress(r, in, d);
+        return;
+    }
+#endif
+    scalar::poly_decompress(r, in, d);
+}
+
+} // namespace kyber
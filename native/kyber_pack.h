@@ -0,0 +1,47 @@
+#ifndef NATIVE_KYBER_PACK_H
+#define NATIVE_KYBER_PACK_H
+
+#include <cstdint>
+#include "kyber_poly.h"
+
+// Serialization of polynomials: Compress_d / Decompress_d and the little-endian
+// bit packing of Encode_l / Decode_l. A packed polynomial takes 32 * bits bytes.
+namespace kyber {
+
+// Pack coefficients in [0, 2^bits) (encode)
+void poly_encode(uint8_t *out, const Poly &a, int bits);
+
+// Unpack 32 * bits bytes (decode); coefficients end up in [0, 2^bits)
+void poly_decode(Poly &r, const uint8_t *in, int bits);
+
+// round(2^d / q * x) mod 2^d for coefficients in [0, q), packed with d bits
+void poly_compress(uint8_t *out, const Poly &a, int d);
+
+// round(q / 2^d * y) for d-bit packed values
+void poly_decompress(Poly &r, const uint8_t *in, int d);
+
+// floor(v / q) for v <= (q - 1) * 2^12 + q / 2, by multiplication: exact over that
+// whole range, which covers the rounding numerator of every Compress_d with d <= 12
+constexpr uint64_t div_q_multiplier = 2580335;
+constexpr int div_q_shift = 33;
+
+// The four functions above are dispatched like the NTT, for 1 <= bits <= 12
+namespace scalar {
+void poly_encode(uint8_t *out, const Poly &a, int bits);
+void poly_decode(Poly &r, const uint8_t *in, int bits);
+void poly_compress(uint8_t *out, const Poly &a, int d);
+void poly_decompress(Poly &r, const uint8_t *in, int d);
+}
+
+#ifdef KYBER_NATIVE_X86
+namespace avx2 {
+void poly_encode(uint8_t *out, const Poly &a, int bits);
+void poly_decode(Poly &r, const uint8_t *in, int bits);
+void poly_compress(uint8_t *out, const Poly &a, int d);
+void poly_decompress(Poly &r, const uint8_t *in, int d);
+}
+#endif
+
+} // namespace kyber
+
+#endif // NATIVE_KYBER_PACK_H
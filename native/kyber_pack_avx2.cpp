@@ -0,0 +1,149 @@
+// AVX2 kernels for Compress_d / Decompress_d and the bit packing of Encode / Decode.
+//
+// Packing works on 16 coefficients per register and merges neighbouring fields in
+// three steps (16 -> 32 -> 64 -> 128 bits), after which each 128-bit lane holds the
+// packed bytes of its 8 coefficients at the start. Unpacking runs the same steps
+// backwards. Compression divides by q with the multiplier from kyber_pack.h, so the
+// output is the same as the scalar code for every input.
+#include "kyber_pack.h"
+
+#ifdef KYBER_NATIVE_X86
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace kyber {
+namespace avx2 {
+namespace {
+
+constexpr size_t packed_bytes(int bits) {
+    return size_t(32 * bits);
+}
+
+KYBER_AVX2 inline __m256i load(const int16_t *p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+KYBER_AVX2 inline void store(int16_t *p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+// The low `bits` bits of 16 coefficients, packed into the first `bits` bytes of each lane
+KYBER_AVX2 inline __m256i pack_lanes(__m256i v, int bits) {
+    v = _mm256_and_si256(v, _mm256_set1_epi16(int16_t((1 << bits) - 1)));
+    // c0 | c1 << bits in each 32-bit lane
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(((1 << bits) << 16) | 1));
+    // w0 | w1 << 2 * bits in each 64-bit lane
+    const __m256i low32 = _mm256_set1_epi64x(0xffffffff);
+    v = _mm256_or_si256(_mm256_and_si256(v, low32),
+                        _mm256_srli_epi64(_mm256_andnot_si256(low32, v), 32 - 2 * bits));
+    // d0 | d1 << 4 * bits in each 128-bit lane, which may cross into the upper 64 bits
+    __m256i high = _mm256_bsrli_epi128(v, 8);
+    __m256i low = _mm256_and_si256(v, _mm256_setr_epi64x(-1, 0, -1, 0));
+    return _mm256_or_si256(low, _mm256_or_si256(_mm256_slli_epi64(high, 4 * bits),
+                                                _mm256_bslli_epi128(_mm256_srli_epi64(high, 64 - 4 * bits), 8)));
+}
+
+// Inverse of pack_lanes; only the first `bits` bytes of each lane are read
+KYBER_AVX2 inline __m256i unpack_lanes(__m256i v, int bits) {
+    const __m256i mask64 = _mm256_set1_epi64x(int64_t((1ULL << (4 * bits)) - 1));
+    __m256i high = _mm256_or_si256(_mm256_srli_epi64(v, 4 * bits),
+                                   _mm256_slli_epi64(_mm256_bsrli_epi128(v, 8), 64 - 4 * bits));
+    v = _mm256_or_si256(_mm256_and_si256(v, _mm256_setr_epi64x(int64_t((1ULL << (4 * bits)) - 1), 0,
+                                                               int64_t((1ULL << (4 * bits)) - 1), 0)),
+                        _mm256_bslli_epi128(_mm256_and_si256(high, mask64), 8));
+
+    const __m256i mask32 = _mm256_set1_epi64x((1LL << (2 * bits)) - 1);
+    v = _mm256_or_si256(_mm256_and_si256(v, mask32),
+                        _mm256_slli_epi64(_mm256_and_si256(_mm256_srli_epi64(v, 2 * bits), mask32), 32));
+
+    const __m256i mask16 = _mm256_set1_epi32((1 << bits) - 1);
+    return _mm256_or_si256(_mm256_and_si256(v, mask16),
+                           _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(v, bits), mask16), 16));
+}
+
+// Lane i of the output takes bytes [bits * i, bits * (i + 1)). Full 16-byte stores are
+// fine as the next lane overwrites the spill; the last ones would run past the end.
+KYBER_AVX2 inline void store_lanes(uint8_t *out, int lane, __m256i v, int bits) {
+    size_t end = packed_bytes(bits);
+    for (int half = 0; half < 2; half++) {
+        __m128i bytes = half == 0 ? _mm256_castsi256_si128(v) : _mm256_extracti128_si256(v, 1);
+        size_t offset = size_t(bits) * size_t(lane + half);
+        if (offset + 16 <= end) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + offset), bytes);
+        } else {
+            uint8_t tail[16];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(tail), bytes);
+            std::memcpy(out + offset, tail, size_t(bits));
+        }
+    }
+}
+
+KYBER_AVX2 inline __m256i load_lanes(const uint8_t *in, int lane, int bits) {
+    size_t end = packed_bytes(bits);
+    __m128i halves[2];
+    for (int half = 0; half < 2; half++) {
+        size_t offset = size_t(bits) * size_t(lane + half);
+        if (offset + 16 <= end) {
+            halves[half] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + offset));
+        } else {
+            uint8_t tail[16] = {};
+            std::memcpy(tail, in + offset, size_t(bits));
+            halves[half] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tail));
+        }
+    }
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(halves[0]), halves[1], 1);
+}
+
+// floor(v / q) in each 32-bit lane through two 32x32 -> 64-bit products
+KYBER_AVX2 inline __m256i div_q(__m256i v) {
+    const __m256i m = _mm256_set1_epi64x(int64_t(div_q_multiplier));
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(v, m), div_q_shift);
+    __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(v, 32), m), div_q_shift);
+    return _mm256_or_si256(even, _mm256_slli_epi64(odd, 32));
+}
+
+// round(2^d / q * x) mod 2^d for 16 coefficients in [0, q)
+KYBER_AVX2 inline __m256i compress(__m256i x, int d) {
+    const __m256i half_q = _mm256_set1_epi32(q / 2);
+    __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(x));
+    __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1));
+    lo = div_q(_mm256_add_epi32(_mm256_slli_epi32(lo, d), half_q));
+    hi = div_q(_mm256_add_epi32(_mm256_slli_epi32(hi, d), half_q));
+    __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+    return _mm256_and_si256(r, _mm256_set1_epi16(int16_t((1 << d) - 1)));
+}
+
+} // namespace
+
+KYBER_AVX2 void poly_encode(uint8_t *out, const Poly &a, int bits) {
+    for (int i = 0; i < n / 16; i++) {
+        store_lanes(out, 2 * i, pack_lanes(load(a.coeffs + 16 * i), bits), bits);
+    }
+}
+
+KYBER_AVX2 void poly_decode(Poly &r, const uint8_t *in, int bits) {
+    for (int i = 0; i < n / 16; i++) {
+        store(r.coeffs + 16 * i, unpack_lanes(load_lanes(in, 2 * i, bits), bits));
+    }
+}
+
+KYBER_AVX2 void poly_compress(uint8_t *out, const Poly &a, int d) {
+    for (int i = 0; i < n / 16; i++) {
+        store_lanes(out, 2 * i, pack_lanes(compress(load(a.coeffs + 16 * i), d), d), d);
+    }
+}
+
+// (y * q + 2^(d-1)) >> d is exactly mulhrs(y << (15 - d), q), as y << (15 - d) < 2^15
+KYBER_AVX2 void poly_decompress(Poly &r, const uint8_t *in, int d) {
+    const __m256i q_vec = _mm256_set1_epi16(q);
+    for (int i = 0; i < n / 16; i++) {
+        __m256i y = unpack_lanes(load_lanes(in, 2 * i, d), d);
+        store(r.coeffs + 16 * i, _mm256_mulhrs_epi16(_mm256_slli_epi16(y, 15 - d), q_vec));
+    }
+}
+
+} // namespace avx2
+} // namespace kyber
+
+#endif // KYBER_NATIVE_X86
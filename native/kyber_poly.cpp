@@ -0,0 +1,138 @@
+#include "kyber_poly.h"
+
+#include <atomic>
+
+namespace kyber {
+
+namespace {
+
+bool detect_avx2() {
+#ifdef KYBER_NATIVE_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+std::atomic<bool> use_avx2{detect_avx2()};
+
+} // namespace
+
+namespace scalar {
+
+void ntt(int16_t r[n]) {
+    unsigned k = 1;
+    for (unsigned len = 128; len >= 2; len >>= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            int16_t zeta = zetas[k++];
+            for (unsigned j = start; j < start + len; j++) {
+                int16_t t = fqmul(zeta, r[j + len]);
+                r[j + len] = r[j] - t;
+                r[j] = r[j] + t;
+            }
+        }
+    }
+}
+
+void invntt(int16_t r[n], int16_t factor) {
+    unsigned k = 127;
+    for (unsigned len = 2; len <= 128; len <<= 1) {
+        for (unsigned start = 0; start < n; start += 2 * len) {
+            int16_t zeta = zetas[k--];
+            for (unsigned j = start; j < start + len; j++) {
+                int16_t t = r[j];
+                r[j] = barrett_reduce(t + r[j + len]);
+                r[j + len] = fqmul(zeta, r[j + len] - t);
+            }
+        }
+    }
+    for (unsigned j = 0; j < n; j++) {
+        r[j] = fqmul(r[j], factor);
+    }
+}
+
+// Multiplication in Z_q[X]/(X^2 - zeta) for one pair of coefficients
+static inline void basemul_pair(int16_t r[2], const int16_t a[2], const int16_t b[2], int16_t zeta) {
+    r[0] = fqmul(fqmul(a[1], b[1]), zeta) + fqmul(a[0], b[0]);
+    r[1] = fqmul(a[0], b[1]) + fqmul(a[1], b[0]);
+}
+
+void basemul_montgomery(int16_t r[n], const int16_t a[n], const int16_t b[n]) {
+    for (unsigned i = 0; i < n / 4; i++) {
+        basemul_pair(&r[4 * i], &a[4 * i], &b[4 * i], zetas[64 + i]);
+        basemul_pair(&r[4 * i + 2], &a[4 * i + 2], &b[4 * i + 2], -zetas[64 + i]);
+    }
+}
+
+} // namespace scalar
+
+void poly_ntt(Poly &r) {
+#ifdef KYBER_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::ntt(r.coeffs);
+        return;
+    }
+#endif
+    scalar::ntt(r.coeffs);
+}
+
+void poly_invntt(Poly &r, int16_t factor) {
+#ifdef KYBER_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::invntt(r.coeffs, factor);
+        return;
+    }
+#endif
+    scalar::invntt(r.coeffs, factor);
+}
+
+void poly_basemul_montgomery(Poly &r, const Poly &a, const Poly &b) {
+#ifdef KYBER_NATIVE_X86
+    if (use_avx2.load(std::memory_order_relaxed)) {
+        avx2::basemul_montgomery(r.coeffs, a.coeffs, b.coeffs);
+        return;
+    }
+#endif
+    scalar::basemul_montgomery(r.coeffs, a.coeffs, b.coeffs);
+}
+
+void poly_tomont(Poly &r) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = fqmul(r.coeffs[i], mont_squared);
+    }
+}
+
+void poly_reduce(Poly &r) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = barrett_reduce(r.coeffs[i]);
+    }
+}
+
+void poly_add(Poly &r, const Poly &a, const Poly &b) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = a.coeffs[i] + b.coeffs[i];
+    }
+}
+
+void poly_sub(Poly &r, const Poly &a, const Poly &b) {
+    for (int i = 0; i < n; i++) {
+        r.coeffs[i] = a.coeffs[i] - b.coeffs[i];
+    }
+}
+
+void poly_canonical(Poly &r) {
+    for (int i = 0; i < n; i++) {
+        int16_t c = r.coeffs[i];
+        r.coeffs[i] = c + ((c >> 15) & q);
+    }
+}
+
+bool avx2_enabled() {
+    return use_avx2.load(std::memory_order_relaxed);
+}
+
+void disable_avx2() {
+    use_avx2.store(false, std::memory_order_relaxed);
+}
+
+} // namespace kyber
@@ -0,0 +1,101 @@
+#ifndef NATIVE_KYBER_POLY_H
+#define NATIVE_KYBER_POLY_H
+
+#include <cstdint>
+#include "ntt_tables.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KYBER_NATIVE_X86 1
+// Compiles one function for AVX2 without raising the baseline of the whole build
+#define KYBER_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Polynomial arithmetic in Z_3329[X]/(X^256 + 1) shared by the native Kyber code.
+//
+// Coefficients are int16 and follow the reference Kyber conventions: products go
+// through Montgomery reduction (R = 2^16) and the NTT leaves its output unreduced.
+// The NTT, inverse NTT and base multiplication have AVX2 kernels that are picked at
+// run time when the CPU supports them; they produce the same values as the scalar
+// code, so the two can be compared coefficient by coefficient.
+namespace kyber {
+
+constexpr int n = 256;
+constexpr int16_t q = 3329;
+constexpr int16_t qinv = -3327;                                            // q^-1 mod 2^16
+constexpr int16_t mont = int16_t(ntt_tables::Kyber::mont);                  // 2^16 mod q
+constexpr int16_t mont_squared = int16_t(ntt_tables::pow_mod(2, 32, q));   // 2^32 mod q
+
+// 2^16 / 128 mod q undoes the Montgomery factor of fqmul in the plain inverse NTT;
+// 2^32 / 128 mod q also leaves the result in Montgomery form
+constexpr int64_t inverse_128 = ntt_tables::pow_mod(128, q - 2, q);
+constexpr int16_t inv128 = int16_t(mont * inverse_128 % q);
+constexpr int16_t mont_inv128 = int16_t(mont_squared * inverse_128 % q);
+
+static_assert(int16_t(q * qinv) == 1, "qinv is the inverse of q mod 2^16");
+
+struct alignas(32) Poly {
+    int16_t coeffs[n];
+};
+
+// zetas[i] = 2^16 * 17^bitrev7(i) mod q, centered
+constexpr const int16_t *zetas = ntt_tables::Kyber::zetas.data();
+
+// a * 2^-16 mod q, for |a| < q * 2^15; result in (-q, q)
+inline int16_t montgomery_reduce(int32_t a) {
+    int16_t t = int16_t(a) * qinv;
+    return int16_t((a - int32_t(t) * q) >> 16);
+}
+
+// a mod q, centered in [-(q-1)/2, (q-1)/2]
+inline int16_t barrett_reduce(int16_t a) {
+    const int16_t v = ((1 << 26) + q / 2) / q;
+    int16_t t = int16_t((int32_t(v) * a + (1 << 25)) >> 26);
+    return a - t * q;
+}
+
+inline int16_t fqmul(int16_t a, int16_t b) {
+    return montgomery_reduce(int32_t(a) * b);
+}
+
+// Forward NTT. Input coefficients must be bounded by q in absolute value; the output
+// is in bit-reversed order and bounded by 8q.
+void poly_ntt(Poly &r);
+
+// Inverse NTT followed by multiplication with factor * 2^-16 (inv128 for the plain
+// inverse, mont_inv128 to land in Montgomery form). Output bounded by q.
+void poly_invntt(Poly &r, int16_t factor);
+
+// Product in the NTT domain, scaled by 2^-16
+void poly_basemul_montgomery(Poly &r, const Poly &a, const Poly &b);
+
+void poly_tomont(Poly &r);
+void poly_reduce(Poly &r);
+void poly_add(Poly &r, const Poly &a, const Poly &b);
+void poly_sub(Poly &r, const Poly &a, const Poly &b);
+
+// Map every coefficient of a Barrett-reduced polynomial to [0, q)
+void poly_canonical(Poly &r);
+
+// True when the AVX2 kernels are in use
+bool avx2_enabled();
+
+// Force the scalar kernels, for benchmarks and cross-checks
+void disable_avx2();
+
+namespace scalar {
+void ntt(int16_t r[n]);
+void invntt(int16_t r[n], int16_t factor);
+void basemul_montgomery(int16_t r[n], const int16_t a[n], const int16_t b[n]);
+}
+
+#ifdef KYBER_NATIVE_X86
+namespace avx2 {
+void ntt(int16_t r[n]);
+void invntt(int16_t r[n], int16_t factor);
+void basemul_montgomery(int16_t r[n], const int16_t a[n], const int16_t b[n]);
+}
+#endif
+
+} // namespace kyber
+
+#endif // NATIVE_KYBER_POLY_H
@@ -0,0 +1,72 @@
+#include "kyber_sampling.h"
+
+namespace kyber {
+
+namespace scalar {
+
+unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen) {
+    unsigned count = 0;
+    size_t pos = 0;
+    while (count < len && pos + 3 <= buflen) {
+        uint16_t d1 = uint16_t(buf[pos] | (uint16_t(buf[pos + 1]) << 8)) & 0xfff;
+        uint16_t d2 = uint16_t((buf[pos + 1] >> 4) | (uint16_t(buf[pos + 2]) << 4));
+        pos += 3;
+        if (d1 < q) {
+            r[count++] = int16_t(d1);
+        }
+        if (d2 < q && count < len) {
+            r[count++] = int16_t(d2);
+        }
+    }
+    return count;
+}
+
+void cbd(Poly &r, const uint8_t *buf, int eta) {
+    if (eta == 2) {
+        // 8 coefficients per 32-bit word: add up bit pairs, then subtract halves
+        for (int i = 0; i < n / 8; i++) {
+            uint32_t t = uint32_t(buf[4 * i]) | uint32_t(buf[4 * i + 1]) << 8 |
+                         uint32_t(buf[4 * i + 2]) << 16 | uint32_t(buf[4 * i + 3]) << 24;
+            uint32_t d = (t & 0x55555555) + ((t >> 1) & 0x55555555);
+            for (int j = 0; j < 8; j++) {
+                int16_t a = (d >> (4 * j)) & 0x3;
+                int16_t b = (d >> (4 * j + 2)) & 0x3;
+                r.coeffs[8 * i + j] = a - b;
+            }
+        }
+    } else {
+        // 4 coefficients per 24 bits
+        for (int i = 0; i < n / 4; i++) {
+            uint32_t t = uint32_t(buf[3 * i]) | uint32_t(buf[3 * i + 1]) << 8 | uint32_t(buf[3 * i + 2]) << 16;
+            uint32_t d = (t & 0x00249249) + ((t >> 1) & 0x00249249) + ((t >> 2) & 0x00249249);
+            for (int j = 0; j < 4; j++) {
+                int16_t a = (d >> (6 * j)) & 0x7;
+                int16_t b = (d >> (6 * j + 3)) & 0x7;
+                r.coeffs[4 * i + j] = a - b;
+            }
+        }
+    }
+}
+
+} // namespace scalar
+
+unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        return avx2::rej_uniform(r, len, buf, buflen);
+    }
+#endif
+    return scalar::rej_uniform(r, len, buf, buflen);
+}
+
+void cbd(Poly &r, const uint8_t *buf, int eta) {
+#ifdef KYBER_NATIVE_X86
+    if (avx2_enabled()) {
+        avx2::cbd(r, buf, eta);
+        return;
+    }
+#endif
+    scalar::cbd(r, buf, eta);
+}
+
+} // namespace kyber
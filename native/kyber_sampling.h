@@ -0,0 +1,33 @@
+#ifndef NATIVE_KYBER_SAMPLING_H
+#define NATIVE_KYBER_SAMPLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include "kyber_poly.h"
+
+namespace kyber {
+
+// Rejection sampling of uniform coefficients mod q (Parse): every 3 bytes give two
+// 12-bit candidates, kept when below q. Fills at most len coefficients from
+// buflen bytes and returns how many were written.
+unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen);
+
+// Centered binomial distribution with eta = 2 or 3 from 64 * eta bytes (CBD)
+void cbd(Poly &r, const uint8_t *buf, int eta);
+
+// Both are dispatched like the NTT; the AVX2 versions give the same output
+namespace scalar {
+unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen);
+void cbd(Poly &r, const uint8_t *buf, int eta);
+}
+
+#ifdef KYBER_NATIVE_X86
+namespace avx2 {
+unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen);
+void cbd(Poly &r, const uint8_t *buf, int eta);
+}
+#endif
+
+} // namespace kyber
+
+#endif // NATIVE_KYBER_SAMPLING_H
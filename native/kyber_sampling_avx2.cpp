@@ -0,0 +1,146 @@
+// AVX2 kernels for uniform rejection sampling and the centered binomial distribution.
+//
+// Both consume the input bytes in the same order as the scalar code in
+// kyber_sampling.cpp and write the same coefficients, so either can be used for
+// keygen and encryption without changing a single output byte.
+#include "kyber_sampling.h"
+
+#ifdef KYBER_NATIVE_X86
+
+#include <array>
+#include <immintrin.h>
+
+namespace kyber {
+namespace avx2 {
+namespace {
+
+// For every 8-bit mask of accepted candidates, the byte shuffle that moves the
+// accepted 16-bit lanes to the front in their original order
+constexpr std::array<std::array<uint8_t, 16>, 256> rej_shuffle = [] {
+    std::array<std::array<uint8_t, 16>, 256> table{};
+    for (unsigned mask = 0; mask < 256; mask++) {
+        unsigned out = 0;
+        for (unsigned lane = 0; lane < 8; lane++) {
+            if (mask & (1u << lane)) {
+                table[mask][out++] = uint8_t(2 * lane);
+                table[mask][out++] = uint8_t(2 * lane + 1);
+            }
+        }
+        while (out < 16) {
+            table[mask][out++] = 0x80;
+        }
+    }
+    return table;
+}();
+
+// 24 bytes with bytes 0..15 in the low lane and 8..23 in the high lane, so each lane
+// has its 12 bytes at the start (low) or at offset 4 (high)
+KYBER_AVX2 inline __m256i load24(const uint8_t *p) {
+    __m256i v = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    v = _mm256_inserti128_si256(v, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 16)), 1);
+    return _mm256_permute4x64_epi64(v, 0x94);
+}
+
+KYBER_AVX2 inline void store16(int16_t *p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+} // namespace
+
+KYBER_AVX2 unsigned rej_uniform(int16_t *r, unsigned len, const uint8_t *buf, size_t buflen) {
+    const __m256i bound = _mm256_set1_epi16(q);
+    const __m256i mask12 = _mm256_set1_epi16(0xfff);
+    // Bytes (3i, 3i+1) and (3i+1, 3i+2) of each group into consecutive 16-bit lanes
+    const __m256i spread = _mm256_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+                                            4, 5, 5, 6, 7, 8, 8, 9, 10, 11, 11, 12, 13, 14, 14, 15);
+
+    // 16 candidates per 24 bytes; both 8-lane halves are stored in full, so stop
+    // while there is room for 16 more coefficients and let the scalar code finish
+    unsigned count = 0;
+    size_t pos = 0;
+    while (count + 16 <= len && pos + 24 <= buflen) {
+        __m256i v = _mm256_shuffle_epi8(load24(buf + pos), spread);
+        v = _mm256_blend_epi16(v, _mm256_srli_epi16(v, 4), 0xaa);
+        v = _mm256_and_si256(v, mask12);
+        pos += 24;
+
+        __m256i good = _mm256_cmpgt_epi16(bound, v);
+        uint32_t bits = uint32_t(_mm256_movemask_epi8(_mm256_packs_epi16(good, good)));
+        unsigned low = bits & 0xff;
+        unsigned high = (bits >> 16) & 0xff;
+
+        __m128i shuffled = _mm_shuffle_epi8(_mm256_castsi256_si128(v),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(rej_shuffle[low].data())));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r + count), shuffled);
+        count += __builtin_popcount(low);
+
+        shuffled = _mm_shuffle_epi8(_mm256_extracti128_si256(v, 1),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(rej_shuffle[high].data())));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r + count), shuffled);
+        count += __builtin_popcount(high);
+    }
+    return count + scalar::rej_uniform(r + count, len - count, buf + pos, buflen - pos);
+}
+
+KYBER_AVX2 void cbd(Poly &r, const uint8_t *buf, int eta) {
+    if (eta == 2) {
+        // Each nibble becomes a - b + 3 from its two bit pairs, then each byte splits
+        // into the coefficients of its low and high nibble
+        const __m256i m55 = _mm256_set1_epi8(0x55);
+        const __m256i m33 = _mm256_set1_epi8(0x33);
+        const __m256i m0f = _mm256_set1_epi8(0x0f);
+        const __m256i three = _mm256_set1_epi8(3);
+        for (int i = 0; i < 4; i++) {
+            __m256i f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buf + 32 * i));
+            __m256i f1 = _mm256_and_si256(_mm256_srli_epi16(f0, 1), m55);
+            f0 = _mm256_add_epi8(_mm256_and_si256(f0, m55), f1);
+
+            f1 = _mm256_and_si256(_mm256_srli_epi16(f0, 2), m33);
+            f0 = _mm256_add_epi8(_mm256_and_si256(f0, m33), m33);
+            f0 = _mm256_sub_epi8(f0, f1);
+
+            f1 = _mm256_sub_epi8(_mm256_and_si256(_mm256_srli_epi16(f0, 4), m0f), three);
+            f0 = _mm256_sub_epi8(_mm256_and_si256(f0, m0f), three);
+
+            for (int half = 0; half < 2; half++) {
+                __m128i even = half == 0 ? _mm256_castsi256_si128(f0) : _mm256_extracti128_si256(f0, 1);
+                __m128i odd = half == 0 ? _mm256_castsi256_si128(f1) : _mm256_extracti128_si256(f1, 1);
+                int16_t *out = r.coeffs + 64 * i + 32 * half;
+                store16(out, _mm256_cvtepi8_epi16(_mm_unpacklo_epi8(even, odd)));
+                store16(out + 16, _mm256_cvtepi8_epi16(_mm_unpackhi_epi8(even, odd)));
+            }
+        }
+    } else {
+        // Every 3 bytes into one 32-bit lane, summed in 3-bit fields as in the scalar code
+        const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+        const __m256i m249 = _mm256_set1_epi32(0x00249249);
+        const __m256i m7 = _mm256_set1_epi32(7);
+        const __m256i low16 = _mm256_set1_epi32(0xffff);
+        for (int i = 0; i < 8; i++) {
+            __m256i t = _mm256_shuffle_epi8(load24(buf + 24 * i), spread);
+            __m256i d = _mm256_add_epi32(_mm256_and_si256(t, m249),
+                                         _mm256_and_si256(_mm256_srli_epi32(t, 1), m249));
+            d = _mm256_add_epi32(d, _mm256_and_si256(_mm256_srli_epi32(t, 2), m249));
+
+            // Coefficient j of each lane: field 2j minus field 2j + 1
+            __m256i c[4];
+            for (int j = 0; j < 4; j++) {
+                __m256i a = _mm256_and_si256(_mm256_srli_epi32(d, 6 * j), m7);
+                __m256i b = _mm256_and_si256(_mm256_srli_epi32(d, 6 * j + 3), m7);
+                c[j] = _mm256_sub_epi32(a, b);
+            }
+            __m256i c01 = _mm256_or_si256(_mm256_and_si256(c[0], low16), _mm256_slli_epi32(c[1], 16));
+            __m256i c23 = _mm256_or_si256(_mm256_and_si256(c[2], low16), _mm256_slli_epi32(c[3], 16));
+            __m256i lo = _mm256_unpacklo_epi32(c01, c23);
+            __m256i hi = _mm256_unpackhi_epi32(c01, c23);
+            store16(r.coeffs + 32 * i, _mm256_permute2x128_si256(lo, hi, 0x20));
+            store16(r.coeffs + 32 * i + 16, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+}
+
+} // namespace avx2
+} // namespace kyber
+
+#endif // KYBER_NATIVE_X86
@@ -0,0 +1,231 @@
+#include "lattice_capi.h"
+
+#include <cstring>
+#include "dilithium_rounding.h"
+#include "kyber.h"
+#include "kyber_pack.h"
+#include "kyber_sampling.h"
+
+namespace {
+
+kyber::Poly load_kyber(const int16_t a[256]) {
+    kyber::Poly p;
+    std::memcpy(p.coeffs, a, sizeof(p.coeffs));
+    return p;
+}
+
+dilithium::Poly load_mldsa(const int32_t a[256]) {
+    dilithium::Poly p;
+    std::memcpy(p.coeffs, a, sizeof(p.coeffs));
+    return p;
+}
+
+// Representative in [0, q) of any int16
+int16_t reduce_kyber(int16_t x) {
+    int r = x % kyber::q;
+    return int16_t(r < 0 ? r + kyber::q : r);
+}
+
+bool valid_gamma2(int32_t gamma2) {
+    return gamma2 == dilithium::gamma2_88 || gamma2 == dilithium::gamma2_32;
+}
+
+} // namespace
+
+extern "C" {
+
+int lattice_kyber_sizes(const char *name, size_t *public_key, size_t *secret_key, size_t *ciphertext) {
+    const kyber::Params *params = name != nullptr ? kyber::params_by_name(name) : nullptr;
+    if (params == nullptr) {
+        return -1;
+    }
+    if (public_key != nullptr) {
+        *public_key = params->public_key_bytes();
+    }
+    if (secret_key != nullptr) {
+        *secret_key = params->secret_key_bytes();
+    }
+    if (ciphertext != nullptr) {
+        *ciphertext = params->ciphertext_bytes();
+    }
+    return 0;
+}
+
+void lattice_kyber_ntt(int16_t a[256]) {
+    kyber::Poly p = load_kyber(a);
+    kyber::ntt(p);
+    std::memcpy(a, p.coeffs, sizeof(p.coeffs));
+}
+
+void lattice_kyber_intt(int16_t a[256]) {
+    kyber::Poly p = load_kyber(a);
+    kyber::intt(p);
+    std::memcpy(a, p.coeffs, sizeof(p.coeffs));
+}
+
+void lattice_kyber_pointwise(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+    kyber::Poly x = load_kyber(a), y = load_kyber(b), out;
+    kyber::pointwise(out, x, y);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+}
+
+void lattice_kyber_multiply(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+    kyber::Poly x = load_kyber(a), y = load_kyber(b), out;
+    kyber::multiply(out, x, y);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+}
+
+void lattice_kyber_parse(int16_t r[256], const uint8_t *bytes, size_t len) {
+    kyber::Poly out;
+    kyber::parse(out, bytes, len);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+}
+
+int lattice_kyber_cbd(int16_t r[256], const uint8_t *bytes, size_t len, int eta) {
+    if ((eta != 2 && eta != 3) || len != size_t(64 * eta)) {
+        return -1;
+    }
+    kyber::Poly out;
+    kyber::cbd(out, bytes, eta);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+    return 0;
+}
+
+int lattice_kyber_compress(int16_t r[256], const int16_t a[256], int d) {
+    if (d < 1 || d > 12) {
+        return -1;
+    }
+    kyber::Poly p;
+    for (int i = 0; i < kyber::n; i++) {
+        p.coeffs[i] = reduce_kyber(a[i]);
+    }
+    uint8_t packed[32 * 12];
+    kyber::poly_compress(packed, p, d);
+    kyber::poly_decode(p, packed, d);
+    std::memcpy(r, p.coeffs, sizeof(p.coeffs));
+    return 0;
+}
+
+int lattice_kyber_decompress(int16_t r[256], const int16_t a[256], int d) {
+    if (d < 1 || d > 12) {
+        return -1;
+    }
+    kyber::Poly p = load_kyber(a);
+    uint8_t packed[32 * 12];
+    kyber::poly_encode(packed, p, d);
+    kyber::poly_decompress(p, packed, d);
+    std::memcpy(r, p.coeffs, sizeof(p.coeffs));
+    return 0;
+}
+
+int lattice_kyber_encode(uint8_t *out, const int16_t a[256], int bits) {
+    if (bits < 1 || bits > 12) {
+        return -1;
+    }
+    kyber::poly_encode(out, load_kyber(a), bits);
+    return 0;
+}
+
+int lattice_kyber_decode(int16_t r[256], const uint8_t *in, int bits) {
+    if (bits < 1 || bits > 12) {
+        return -1;
+    }
+    kyber::Poly p;
+    kyber::poly_decode(p, in, bits);
+    std::memcpy(r, p.coeffs, sizeof(p.coeffs));
+    return 0;
+}
+
+int lattice_kyber_keygen(const char *name, uint8_t *pk, uint8_t *sk, const uint8_t seed[32]) {
+    const kyber::Params *params = name != nullptr ? kyber::params_by_name(name) : nullptr;
+    if (params == nullptr) {
+        return -1;
+    }
+    kyber::keygen(*params, pk, sk, seed);
+    return 0;
+}
+
+int lattice_kyber_encrypt(const char *name, uint8_t *ct, const uint8_t *pk, const uint8_t msg[32],
+                          const uint8_t coins[32]) {
+    const kyber::Params *params = name != nullptr ? kyber::params_by_name(name) : nullptr;
+    if (params == nullptr) {
+        return -1;
+    }
+    kyber::encrypt(*params, ct, pk, msg, coins);
+    return 0;
+}
+
+int lattice_kyber_decrypt(const char *name, uint8_t msg[32], const uint8_t *ct, const uint8_t *sk) {
+    const kyber::Params *params = name != nullptr ? kyber::params_by_name(name) : nullptr;
+    if (params == nullptr) {
+        return -1;
+    }
+    kyber::decrypt(*params, msg, ct, sk);
+    return 0;
+}
+
+void lattice_mldsa_ntt(int32_t a[256]) {
+    dilithium::Poly p = load_mldsa(a);
+    dilithium::poly_ntt(p);
+    std::memcpy(a, p.coeffs, sizeof(p.coeffs));
+}
+
+void lattice_mldsa_invntt_tomont(int32_t a[256]) {
+    dilithium::Poly p = load_mldsa(a);
+    dilithium::poly_invntt_tomont(p);
+    std::memcpy(a, p.coeffs, sizeof(p.coeffs));
+}
+
+void lattice_mldsa_pointwise_montgomery(int32_t r[256], const int32_t a[256], const int32_t b[256]) {
+    dilithium::Poly x = load_mldsa(a), y = load_mldsa(b), out;
+    dilithium::poly_pointwise_montgomery(out, x, y);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+}
+
+void lattice_mldsa_power2round(int32_t a1[256], int32_t a0[256], const int32_t a[256]) {
+    dilithium::Poly high, low;
+    dilithium::poly_power2round(high, low, load_mldsa(a));
+    std::memcpy(a1, high.coeffs, sizeof(high.coeffs));
+    std::memcpy(a0, low.coeffs, sizeof(low.coeffs));
+}
+
+int lattice_mldsa_decompose(int32_t a1[256], int32_t a0[256], const int32_t a[256], int32_t gamma2) {
+    if (!valid_gamma2(gamma2)) {
+        return -1;
+    }
+    dilithium::Poly high, low;
+    dilithium::poly_decompose(high, low, load_mldsa(a), gamma2);
+    std::memcpy(a1, high.coeffs, sizeof(high.coeffs));
+    std::memcpy(a0, low.coeffs, sizeof(low.coeffs));
+    return 0;
+}
+
+int lattice_mldsa_make_hint(int32_t h[256], const int32_t a0[256], const int32_t a1[256], int32_t gamma2) {
+    if (!valid_gamma2(gamma2)) {
+        return -1;
+    }
+    dilithium::Poly out;
+    unsigned ones = dilithium::poly_make_hint(out, load_mldsa(a0), load_mldsa(a1), gamma2);
+    std::memcpy(h, out.coeffs, sizeof(out.coeffs));
+    return int(ones);
+}
+
+int lattice_mldsa_use_hint(int32_t r[256], const int32_t a[256], const int32_t h[256], int32_t gamma2) {
+    if (!valid_gamma2(gamma2)) {
+        return -1;
+    }
+    dilithium::Poly out;
+    dilithium::poly_use_hint(out, load_mldsa(a), load_mldsa(h), gamma2);
+    std::memcpy(r, out.coeffs, sizeof(out.coeffs));
+    return 0;
+}
+
+int lattice_mldsa_chknorm(const int32_t a[256], int32_t bound) {
+    return dilithium::poly_chknorm(load_mldsa(a), bound) ? 1 : 0;
+}
+
+int lattice_avx2_enabled(void) {
+    return kyber::avx2_enabled() && dilithium::avx2_enabled() ? 1 : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,74 @@
+#ifndef NATIVE_LATTICE_CAPI_H
+#define NATIVE_LATTICE_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Stable C ABI over the native engine, built as liblattice_native.so (make native_lib)
+// and loaded from Python with ctypes by native_engine.py.
+//
+// Polynomials are arrays of 256 coefficients owned by the caller. The Kyber functions
+// follow the kypher.py functions named in their comments and give the same output for
+// inputs reduced mod 3329; the ML-DSA ones are the kernels of dilithium_rounding.h.
+// Functions returning int give 0 on success and -1 on an invalid argument.
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Byte sizes of a Kyber parameter set ("Kyber512", "Kyber768", "Kyber1024");
+// -1 for an unknown name. Any output pointer may be null.
+int lattice_kyber_sizes(const char *name, size_t *public_key, size_t *secret_key, size_t *ciphertext);
+
+// NTT_kyber / INTT_kyber, in place; output in [0, q)
+void lattice_kyber_ntt(int16_t a[256]);
+void lattice_kyber_intt(int16_t a[256]);
+
+// pointwise (basemul of NTT-domain polynomials) and KyberConvolution
+void lattice_kyber_pointwise(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+void lattice_kyber_multiply(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+
+// Parse over len bytes of XOF output
+void lattice_kyber_parse(int16_t r[256], const uint8_t *bytes, size_t len);
+
+// CBD from exactly 64 * eta bytes, eta 2 or 3
+int lattice_kyber_cbd(int16_t r[256], const uint8_t *bytes, size_t len, int eta);
+
+// compress / decompress coefficient-wise, 1 <= d <= 12; decompress reads the low d bits
+int lattice_kyber_compress(int16_t r[256], const int16_t a[256], int d);
+int lattice_kyber_decompress(int16_t r[256], const int16_t a[256], int d);
+
+// encode into 32 * bits bytes / decode from them, 1 <= bits <= 12
+int lattice_kyber_encode(uint8_t *out, const int16_t a[256], int bits);
+int lattice_kyber_decode(int16_t r[256], const uint8_t *in, int bits);
+
+// keygen / encryption / decryption of kypher.py (round 3 IND-CPA), deterministic in
+// the 32-byte seed and coins
+int lattice_kyber_keygen(const char *name, uint8_t *pk, uint8_t *sk, const uint8_t seed[32]);
+int lattice_kyber_encrypt(const char *name, uint8_t *ct, const uint8_t *pk, const uint8_t msg[32],
+                          const uint8_t coins[32]);
+int lattice_kyber_decrypt(const char *name, uint8_t msg[32], const uint8_t *ct, const uint8_t *sk);
+
+// ML-DSA NTT mod 8380417 (Montgomery domain, like the reference code), in place
+void lattice_mldsa_ntt(int32_t a[256]);
+void lattice_mldsa_invntt_tomont(int32_t a[256]);
+void lattice_mldsa_pointwise_montgomery(int32_t r[256], const int32_t a[256], const int32_t b[256]);
+
+// Power2Round and Decompose of coefficients in [0, q); gamma2 is (q-1)/88 or (q-1)/32
+void lattice_mldsa_power2round(int32_t a1[256], int32_t a0[256], const int32_t a[256]);
+int lattice_mldsa_decompose(int32_t a1[256], int32_t a0[256], const int32_t a[256], int32_t gamma2);
+
+// MakeHint (returns the number of ones, or -1) and UseHint
+int lattice_mldsa_make_hint(int32_t h[256], const int32_t a0[256], const int32_t a1[256], int32_t gamma2);
+int lattice_mldsa_use_hint(int32_t r[256], const int32_t a[256], const int32_t h[256], int32_t gamma2);
+
+// 1 if some |a_i| >= bound, else 0
+int lattice_mldsa_chknorm(const int32_t a[256], int32_t bound);
+
+// 1 when the AVX2 kernels are in use
+int lattice_avx2_enabled(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_LATTICE_CAPI_H
@@ -0,0 +1,124 @@
+#ifndef NATIVE_NTT_TABLES_H
+#define NATIVE_NTT_TABLES_H
+
+#include <array>
+#include <cstdint>
+
+// NTT twiddle tables computed by the compiler from the modulus and the transform size.
+//
+// This replaces what kypher.py's NTT does on every call (primera_raiz_primitiva,
+// phi**bitrev(m+i, n), bitrev building a list) with constants baked into the binary,
+// so there is no startup cost and the kernels index plain arrays.
+namespace ntt_tables {
+
+constexpr int64_t pow_mod(int64_t base, uint64_t exp, int64_t mod) {
+    int64_t result = 1;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) {
+            result = result * base % mod;
+        }
+        base = base * base % mod;
+        exp >>= 1;
+    }
+    return result;
+}
+
+constexpr unsigned bit_reverse(unsigned x, unsigned bits) {
+    unsigned r = 0;
+    for (unsigned i = 0; i < bits; i++) {
+        r = (r << 1) | ((x >> i) & 1);
+    }
+    return r;
+}
+
+constexpr unsigned log2(unsigned x) {
+    unsigned bits = 0;
+    while ((1u << bits) < x) {
+        bits++;
+    }
+    return bits;
+}
+
+// Representative of x mod q in (-q/2, q/2]
+constexpr int64_t centered(int64_t x, int64_t q) {
+    x %= q;
+    if (x < 0) {
+        x += q;
+    }
+    return x > q / 2 ? x - q : x;
+}
+
+// Smallest primitive root of unity of the given power-of-two order, the same one
+// primera_raiz_primitiva finds: g^(order/2) = -1 makes the order exactly `order`
+constexpr int64_t first_primitive_root(int64_t q, int64_t order) {
+    for (int64_t g = 2; g < q; g++) {
+        if (pow_mod(g, order / 2, q) == q - 1) {
+            return g;
+        }
+    }
+    return 0;
+}
+
+// Tables for a negacyclic NTT of Size butterfly groups mod Q, i.e. one that needs a
+// primitive 2*Size-th root of unity, with Montgomery factor 2^RBits. Entry i belongs
+// to butterfly group i in the order the Cooley-Tukey loop visits them (bit-reversed).
+template <typename T, int64_t Q, unsigned Size, unsigned RBits>
+struct Tables {
+    static constexpr int64_t q = Q;
+    static constexpr unsigned size = Size;
+    static constexpr int64_t root = first_primitive_root(Q, 2 * Size);
+    static constexpr int64_t root_inverse = pow_mod(root, 2 * Size - 1, Q);
+    static constexpr int64_t mont = pow_mod(2, RBits, Q);
+
+    static_assert(root != 0, "the modulus has no root of unity of the required order");
+
+    // root^bitrev(i), and its inverse, in [0, q)
+    static constexpr std::array<T, Size> zetas_plain = [] {
+        std::array<T, Size> t{};
+        for (unsigned i = 0; i < Size; i++) {
+            t[i] = T(pow_mod(root, bit_reverse(i, log2(Size)), Q));
+        }
+        return t;
+    }();
+
+    static constexpr std::array<T, Size> zetas_inverse_plain = [] {
+        std::array<T, Size> t{};
+        for (unsigned i = 0; i < Size; i++) {
+            t[i] = T(pow_mod(root_inverse, bit_reverse(i, log2(Size)), Q));
+        }
+        return t;
+    }();
+
+    // The same values times 2^RBits, centered, for Montgomery multiplication
+    static constexpr std::array<T, Size> zetas = [] {
+        std::array<T, Size> t{};
+        for (unsigned i = 0; i < Size; i++) {
+            t[i] = T(centered(mont * zetas_plain[i], Q));
+        }
+        return t;
+    }();
+
+    static constexpr std::array<T, Size> zetas_inverse = [] {
+        std::array<T, Size> t{};
+        for (unsigned i = 0; i < Size; i++) {
+            t[i] = T(centered(mont * zetas_inverse_plain[i], Q));
+        }
+        return t;
+    }();
+};
+
+// ML-KEM / Kyber: q = 3329, 128 groups of two coefficients, root 17, R = 2^16
+using Kyber = Tables<int16_t, 3329, 128, 16>;
+
+// ML-DSA / Dilithium (firma.py's q = 2^23 - 2^13 + 1): 256 coefficients, root 1753, R = 2^32
+using Dilithium = Tables<int32_t, 8380417, 256, 32>;
+
+static_assert(Kyber::root == 17, "kypher.py's first 256th root of unity mod 3329");
+static_assert(Kyber::zetas[1] == -758 && Kyber::zetas[127] == 1628, "reference Kyber zetas");
+static_assert(Dilithium::root == 1753, "reference Dilithium root of unity");
+static_assert(Dilithium::zetas[1] == 25847 && Dilithium::zetas[2] == -2608894, "reference Dilithium zetas");
+
+} // namespace ntt_tables
+
+#endif // NATIVE_NTT_TABLES_H
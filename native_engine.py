@@ -0,0 +1,295 @@
+"""
+Enlace con el motor nativo en C++ (native/lattice_capi.h) mediante ctypes.
+
+La biblioteca se compila con `make native_lib` y se busca junto a este fichero
+(liblattice_native.so) o en la ruta de la variable LATTICE_NATIVE_LIB. Con
+LATTICE_NATIVE=0 no se carga y todo se hace en Python, útil para comparar.
+
+Las funciones de Kyber tienen el nombre y el resultado de las de kypher.py; devuelven
+None cuando los argumentos no son un caso que el motor nativo cubra, y entonces se
+usa la versión en Python.
+"""
+import ctypes
+import os
+
+q = 3329
+n = 256
+
+# (k, eta1, eta2, du, dv) de cada conjunto de parámetros.
+PARAMETROS = {
+  (2, 3, 2, 10, 4): 'Kyber512',
+  (3, 2, 2, 10, 4): 'Kyber768',
+  (4, 2, 2, 11, 5): 'Kyber1024',
+}
+
+_Pol16 = ctypes.c_int16 * n
+_Pol32 = ctypes.c_int32 * n
+
+
+def _cargar():
+  """
+  Carga la biblioteca y declara los tipos de cada función; None si no está.
+  """
+  if os.environ.get('LATTICE_NATIVE', '1') == '0':
+    return None
+  ruta = os.environ.get('LATTICE_NATIVE_LIB',
+                        os.path.join(os.path.dirname(os.path.abspath(__file__)), 'liblattice_native.so'))
+  try:
+    lib = ctypes.CDLL(ruta)
+  except OSError:
+    return None
+
+  p16, p32, pb = ctypes.POINTER(ctypes.c_int16), ctypes.POINTER(ctypes.c_int32), ctypes.c_char_p
+  size_t, c_int = ctypes.c_size_t, ctypes.c_int
+  firmas = {
+    'lattice_kyber_sizes': (c_int, [pb, ctypes.POINTER(size_t), ctypes.POINTER(size_t), ctypes.POINTER(size_t)]),
+    'lattice_kyber_ntt': (None, [p16]),
+    'lattice_kyber_intt': (None, [p16]),
+    'lattice_kyber_pointwise': (None, [p16, p16, p16]),
+    'lattice_kyber_multiply': (None, [p16, p16, p16]),
+    'lattice_kyber_parse': (None, [p16, pb, size_t]),
+    'lattice_kyber_cbd': (c_int, [p16, pb, size_t, c_int]),
+    'lattice_kyber_compress': (c_int, [p16, p16, c_int]),
+    'lattice_kyber_decompress': (c_int, [p16, p16, c_int]),
+    'lattice_kyber_encode': (c_int, [ctypes.c_void_p, p16, c_int]),
+    'lattice_kyber_decode': (c_int, [p16, pb, c_int]),
+    'lattice_kyber_keygen': (c_int, [pb, ctypes.c_void_p, ctypes.c_void_p, pb]),
+    'lattice_kyber_encrypt': (c_int, [pb, ctypes.c_void_p, pb, pb, pb]),
+    'lattice_kyber_decrypt': (c_int, [pb, ctypes.c_void_p, pb, pb]),
+    'lattice_mldsa_ntt': (None, [p32]),
+    'lattice_mldsa_invntt_tomont': (None, [p32]),
+    'lattice_mldsa_pointwise_montgomery': (None, [p32, p32, p32]),
+    'lattice_mldsa_power2round': (None, [p32, p32, p32]),
+    'lattice_mldsa_decompose': (c_int, [p32, p32, p32, ctypes.c_int32]),
+    'lattice_mldsa_make_hint': (c_int, [p32, p32, p32, ctypes.c_int32]),
+    'lattice_mldsa_use_hint': (c_int, [p32, p32, p32, ctypes.c_int32]),
+    'lattice_mldsa_chknorm': (c_int, [p32, ctypes.c_int32]),
+    'lattice_avx2_enabled': (c_int, []),
+  }
+  for nombre, (resultado, argumentos) in firmas.items():
+    funcion = getattr(lib, nombre)
+    funcion.restype = resultado
+    funcion.argtypes = argumentos
+  return lib
+
+
+lib = _cargar()
+
+
+def disponible():
+  """
+  True si el motor nativo está cargado.
+  """
+  return lib is not None
+
+
+def avx2():
+  """
+  True si el motor usa los kernels AVX2.
+  """
+  return lib is not None and lib.lattice_avx2_enabled() == 1
+
+
+def nombre_parametros(k, n1, n2=None, du=None, dv=None):
+  """
+  Nombre del conjunto de parámetros de Kyber; n2, du y dv sin dar no se comprueban.
+  """
+  for (pk, pn1, pn2, pdu, pdv), nombre in PARAMETROS.items():
+    if (pk, pn1) == (k, n1) and n2 in (None, pn2) and du in (None, pdu) and dv in (None, pdv):
+      return nombre
+  return None
+
+
+def _tamanos(nombre):
+  pk, sk, ct = ctypes.c_size_t(), ctypes.c_size_t(), ctypes.c_size_t()
+  lib.lattice_kyber_sizes(nombre.encode(), ctypes.byref(pk), ctypes.byref(sk), ctypes.byref(ct))
+  return pk.value, sk.value, ct.value
+
+
+def _pol(p, reducir=True):
+  """
+  Lista de coeficientes a array de C, rellenando con ceros hasta 256 como kypher.py.
+  """
+  p = list(p) + [0] * (n - len(p))
+  return _Pol16(*[c % q for c in p]) if reducir else _Pol16(*p)
+
+
+## Operaciones sobre polinomios de Kyber
+
+def NTT_kyber(a):
+  r = _pol(a)
+  lib.lattice_kyber_ntt(r)
+  return list(r)
+
+
+def INTT_kyber(a):
+  r = _pol(a)
+  lib.lattice_kyber_intt(r)
+  return list(r)
+
+
+def pointwise(p, g):
+  r = _Pol16()
+  lib.lattice_kyber_pointwise(r, _pol(p), _pol(g))
+  return list(r)
+
+
+def KyberConvolution(p, g):
+  """
+  Producto de dos polinomios en orden estándar.
+  """
+  r = _Pol16()
+  lib.lattice_kyber_multiply(r, _pol(p), _pol(g))
+  return list(r)
+
+
+def Parse(b):
+  b = bytes(b)
+  r = _Pol16()
+  lib.lattice_kyber_parse(r, b, len(b))
+  return list(r)
+
+
+def CBD(input_bytes, eta):
+  input_bytes = bytes(input_bytes)
+  r = _Pol16()
+  if lib.lattice_kyber_cbd(r, input_bytes, len(input_bytes), eta) != 0:
+    return None
+  return list(r)
+
+
+def compress(x, d):
+  if len(x) != n or not 1 <= d <= 12:
+    return None
+  r = _Pol16()
+  lib.lattice_kyber_compress(r, _pol(x), d)
+  return list(r)
+
+
+def decompress(x, d):
+  if len(x) != n or not 1 <= d <= 12 or any(c < 0 or c >= 2**d for c in x):
+    return None
+  r = _Pol16()
+  lib.lattice_kyber_decompress(r, _pol(x, False), d)
+  return list(r)
+
+
+def encode(p, l):
+  if l is None or len(p) != n or not 1 <= l <= 12 or any(c < 0 or c >= 2**l for c in p):
+    return None
+  out = ctypes.create_string_buffer(32 * l)
+  lib.lattice_kyber_encode(out, _pol(p, False), l)
+  return out.raw
+
+
+def decode(input_bytes, l):
+  if l is None or not 1 <= l <= 12 or len(input_bytes) != 32 * l:
+    return None
+  r = _Pol16()
+  lib.lattice_kyber_decode(r, bytes(input_bytes), l)
+  return list(r)
+
+
+## Algoritmos completos (Kyber IND-CPA de kypher.py)
+
+def keygen(k, n1, d):
+  """
+  (pk, sk) a partir de la semilla d de 32 bytes.
+  """
+  nombre = nombre_parametros(k, n1)
+  if nombre is None or len(d) != 32:
+    return None
+  pk_len, sk_len, _ = _tamanos(nombre)
+  pk, sk = ctypes.create_string_buffer(pk_len), ctypes.create_string_buffer(sk_len)
+  lib.lattice_kyber_keygen(nombre.encode(), pk, sk, bytes(d))
+  return pk.raw, sk.raw
+
+
+def encryption(pk, m, r1, k, n1, n2, du, dv):
+  nombre = nombre_parametros(k, n1, n2, du, dv)
+  if nombre is None or len(m) != 32 or len(r1) != 32:
+    return None
+  pk_len, _, ct_len = _tamanos(nombre)
+  if len(pk) != pk_len:
+    return None
+  c = ctypes.create_string_buffer(ct_len)
+  lib.lattice_kyber_encrypt(nombre.encode(), c, bytes(pk), bytes(m), bytes(r1))
+  return c.raw
+
+
+def decryption(sk, c, k, n1, n2, du, dv):
+  nombre = nombre_parametros(k, n1, n2, du, dv)
+  if nombre is None:
+    return None
+  _, sk_len, ct_len = _tamanos(nombre)
+  if len(sk) != sk_len or len(c) != ct_len:
+    return None
+  m = ctypes.create_string_buffer(32)
+  lib.lattice_kyber_decrypt(nombre.encode(), m, bytes(c), bytes(sk))
+  return m.raw
+
+
+## Núcleos de ML-DSA (q = 8380417), para firma.py
+
+q_mldsa = 2**23 - 2**13 + 1
+gamma2_88 = (q_mldsa - 1) // 88
+gamma2_32 = (q_mldsa - 1) // 32
+
+
+def _pol32(p):
+  return _Pol32(*(list(p) + [0] * (n - len(p))))
+
+
+def mldsa_ntt(a):
+  r = _pol32(a)
+  lib.lattice_mldsa_ntt(r)
+  return list(r)
+
+
+def mldsa_invntt_tomont(a):
+  r = _pol32(a)
+  lib.lattice_mldsa_invntt_tomont(r)
+  return list(r)
+
+
+def mldsa_pointwise_montgomery(a, b):
+  r = _Pol32()
+  lib.lattice_mldsa_pointwise_montgomery(r, _pol32(a), _pol32(b))
+  return list(r)
+
+
+def mldsa_power2round(a):
+  a1, a0 = _Pol32(), _Pol32()
+  lib.lattice_mldsa_power2round(a1, a0, _pol32([c % q_mldsa for c in a]))
+  return list(a1), list(a0)
+
+
+def mldsa_decompose(a, gamma2):
+  """
+  (highbits, lowbits) de cada coeficiente, como decompose de complementary.py
+  con alpha = 2*gamma2.
+  """
+  a1, a0 = _Pol32(), _Pol32()
+  if lib.lattice_mldsa_decompose(a1, a0, _pol32([c % q_mldsa for c in a]), gamma2) != 0:
+    return None
+  return list(a1), list(a0)
+
+
+def mldsa_make_hint(a0, a1, gamma2):
+  h = _Pol32()
+  unos = lib.lattice_mldsa_make_hint(h, _pol32(a0), _pol32(a1), gamma2)
+  return None if unos < 0 else (list(h), unos)
+
+
+def mldsa_use_hint(a, h, gamma2):
+  r = _Pol32()
+  if lib.lattice_mldsa_use_hint(r, _pol32([c % q_mldsa for c in a]), _pol32(h), gamma2) != 0:
+    return None
+  return list(r)
+
+
+def mldsa_chknorm(a, cota):
+  """
+  True si algún coeficiente tiene valor absoluto >= cota (la comprobación de inf).
+  """
+  return lib.lattice_mldsa_chknorm(_pol32(a), cota) == 1
@@ -0,0 +1,244 @@
+#include "ndjson.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ndjson {
+
+namespace {
+
+std::string_view trim(std::string_view line) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+        line.remove_suffix(1);
+    }
+    while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+        line.remove_prefix(1);
+    }
+    return line;
+}
+
+std::string error_line(size_t index, const char *message) {
+    std::string line = "{\"index\":" + std::to_string(index) + ",\"error\":\"";
+    for (const char *p = message; *p; p++) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            line += '\\';
+            line += char(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            line += escaped;
+        } else {
+            line += char(c);
+        }
+    }
+    line += "\"}";
+    return line;
+}
+
+std::string run_item(const ItemHandler &handler, size_t index, std::string_view line) {
+    try {
+        return handler(index, line);
+    } catch (const std::exception &e) {
+        return error_line(index, e.what());
+    } catch (...) {
+        return error_line(index, "unknown error");
+    }
+}
+
+// Threads shared by the items of every request, one per hardware thread, started on first use
+class WorkerPool {
+public:
+    static WorkerPool &instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    void submit(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        work_.notify_one();
+    }
+
+private:
+    WorkerPool() {
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < count; i++) {
+            threads_.emplace_back(&WorkerPool::run, this);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            work_.notify_all();
+        }
+        for (std::thread &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable work_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
+
+} // namespace
+
+bool is_ndjson(const std::string &content_type_header) {
+    return content_type_header.compare(0, std::char_traits<char>::length(content_type), content_type) == 0;
+}
+
+Stream::Stream(const Options &defaults, Opener open, Sink sink)
+    : options_(defaults), open_(std::move(open)), sink_(std::move(sink)) {}
+
+Stream::~Stream() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    progress_.wait(lock, [&] { return running_ == 0; });
+}
+
+void Stream::feed(std::string_view data) {
+    size_t pos = 0;
+    while (pos < data.size() && !error_) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string_view::npos) {
+            partial_.append(data.substr(pos));
+            return;
+        }
+        if (partial_.empty()) {
+            take_line(data.substr(pos, end - pos));
+        } else {
+            partial_.append(data.substr(pos, end - pos));
+            take_line(partial_);
+            partial_.clear();
+        }
+        pos = end + 1;
+    }
+}
+
+void Stream::finish(std::function<void(std::exception_ptr error)> done) {
+    if (!partial_.empty()) {
+        take_line(partial_);
+        partial_.clear();
+    }
+    if (!opened_) {
+        open({});  // No parameter line at all
+    }
+    if (error_) {
+        done(error_);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (written_ < dispatched_) {
+        done_ = std::move(done);
+        return;
+    }
+    lock.unlock();
+    done(nullptr);
+}
+
+void Stream::take_line(std::string_view line) {
+    line = trim(line);
+    if (line.empty()) {
+        return;
+    }
+    if (!opened_) {
+        open(line);
+    } else {
+        dispatch(line);
+    }
+}
+
+void Stream::open(std::string_view params) {
+    opened_ = true;
+    try {
+        handler_ = open_(params, options_);
+        options_.window = std::max<size_t>(options_.window, 1);
+    } catch (...) {
+        error_ = std::current_exception();
+    }
+}
+
+// Queue an item once fewer than window items are waiting for output
+void Stream::dispatch(std::string_view line) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    progress_.wait(lock, [&] { return dispatched_ - written_ < options_.window; });
+    size_t index = dispatched_++;
+    running_++;
+    lock.unlock();
+
+    WorkerPool::instance().submit([this, index, item = std::string(line)] {
+        complete(index, run_item(handler_, index, item));
+    });
+}
+
+void Stream::complete(size_t index, std::string result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!options_.ordered) {
+        emit(result);
+    } else {
+        pending_.emplace(index, std::move(result));
+        while (!pending_.empty() && pending_.begin()->first == written_) {
+            emit(pending_.begin()->second);
+            pending_.erase(pending_.begin());
+        }
+    }
+    running_--;
+    if (done_ && written_ == dispatched_) {
+        auto done = std::move(done_);
+        done_ = nullptr;
+        done(nullptr);
+    }
+    progress_.notify_all();
+}
+
+void Stream::emit(const std::string &line) {
+    sink_(line);
+    written_++;
+}
+
+std::string transform(std::string_view body, const Options &defaults, const Opener &open) {
+    std::string output;
+    std::exception_ptr error;
+    {
+        Stream stream(defaults, open, [&](std::string_view line) {
+            output += line;
+            output += '\n';
+        });
+        stream.feed(body);
+        stream.finish([&](std::exception_ptr e) { error = e; });
+    }  // The destructor waits for the items in flight
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return output;
+}
+
+} // namespace ndjson
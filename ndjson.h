@@ -0,0 +1,95 @@
+#ifndef NDJSON_H
+#define NDJSON_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Newline-delimited JSON for the bulk routes. A request body is a parameter line
+// followed by one line per item; the response has one line per item, each tagged
+// with the "index" of the item it answers.
+//
+// A Stream is fed the body as it arrives and hands each item to a worker pool shared
+// by all requests as soon as its line is complete, so no JSON document for the whole
+// batch is ever parsed and parsing overlaps the crypto of earlier items. At most window
+// items are between dispatch and output at any time: in ordered mode a result waits
+// until all earlier ones are written, otherwise results are written as they complete.
+// Feeding blocks while the window is full, so a request holds its window of items and
+// the current line, not the batch.
+namespace ndjson {
+
+constexpr const char *content_type = "application/x-ndjson";
+constexpr size_t default_window = 256;
+
+struct Options {
+    bool ordered = true;
+    size_t window = default_window;
+};
+
+// Turns one item line into one output line (a JSON object without the newline).
+// Exceptions become {"index":N,"error":"..."} lines.
+using ItemHandler = std::function<std::string(size_t index, std::string_view line)>;
+
+// Reads the parameter line before any item and returns the handler for the items; it
+// may change the options. An exception rejects the request.
+using Opener = std::function<ItemHandler(std::string_view params, Options &options)>;
+
+// Receives each output line (without the newline) in output order, one call at a time
+using Sink = std::function<void(std::string_view line)>;
+
+// True when the request body is declared as NDJSON
+bool is_ndjson(const std::string &content_type_header);
+
+// One request, fed its body in pieces from a single thread
+class Stream {
+public:
+    Stream(const Options &defaults, Opener open, Sink sink);
+    ~Stream();  // Waits for the items in flight
+
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    // Dispatch every complete line of data; an incomplete last line waits for the next call
+    void feed(std::string_view data);
+
+    // The body is complete. done is called once: with the opener's exception if the request
+    // was rejected, otherwise with nullptr after the last line has gone to the sink, which
+    // may be on a worker thread and before finish returns.
+    void finish(std::function<void(std::exception_ptr error)> done);
+
+private:
+    void take_line(std::string_view line);
+    void open(std::string_view params);
+    void dispatch(std::string_view line);
+    void complete(size_t index, std::string result);
+    void emit(const std::string &line);
+
+    Options options_;
+    Opener open_;
+    ItemHandler handler_;
+    Sink sink_;
+    bool opened_ = false;
+    std::exception_ptr error_;
+    std::string partial_;  // Start of a line split across pieces
+
+    std::mutex mutex_;
+    std::condition_variable progress_;
+    std::map<size_t, std::string> pending_;  // Ordered mode: results ahead of written_
+    size_t dispatched_ = 0;
+    size_t written_ = 0;
+    size_t running_ = 0;
+    std::function<void(std::exception_ptr)> done_;
+};
+
+// Run a whole body and return the output lines joined by newlines; rethrows the
+// opener's exception
+std::string transform(std::string_view body, const Options &defaults, const Opener &open);
+
+} // namespace ndjson
+
+#endif // NDJSON_H
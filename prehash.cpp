@@ -0,0 +1,66 @@
+#include "prehash.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <openssl/evp.h>
+
+namespace prehash {
+
+const char context[] = "ml-kem-api prehash shake256";
+
+namespace {
+
+// DER encoding of id-shake256, 2.16.840.1.101.3.4.2.12
+const uint8_t shake256_oid[] = {0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x0c};
+
+constexpr size_t signed_length = sizeof(shake256_oid) + digest_length;
+
+void signed_message(const uint8_t digest[digest_length], uint8_t out[signed_length]) {
+    std::memcpy(out, shake256_oid, sizeof(shake256_oid));
+    std::memcpy(out + sizeof(shake256_oid), digest, digest_length);
+}
+
+void require_context_support(const OQS_SIG *sig) {
+    if (!sig->sig_with_ctx_support) {
+        throw std::invalid_argument(std::string(sig->method_name) + " does not support pre-hashed signing");
+    }
+}
+
+} // namespace
+
+void digest(const uint8_t *message, size_t len, uint8_t out[digest_length]) {
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    bool ok = ctx && EVP_DigestInit_ex(ctx.get(), EVP_shake256(), nullptr) > 0 &&
+              EVP_DigestUpdate(ctx.get(), message, len) > 0 &&
+              EVP_DigestFinalXOF(ctx.get(), out, digest_length) > 0;
+    if (!ok) {
+        throw std::runtime_error("SHAKE256 failed");
+    }
+}
+
+std::vector<uint8_t> sign(const OQS_SIG *sig, const uint8_t digest[digest_length], const uint8_t *secret_key) {
+    require_context_support(sig);
+    uint8_t message[signed_length];
+    signed_message(digest, message);
+    std::vector<uint8_t> signature(sig->length_signature);
+    size_t signature_len = signature.size();
+    if (OQS_SIG_sign_with_ctx_str(sig, signature.data(), &signature_len, message, sizeof(message),
+                                  reinterpret_cast<const uint8_t *>(context), sizeof(context) - 1, secret_key) != OQS_SUCCESS) {
+        throw std::runtime_error("Signing failed.");
+    }
+    signature.resize(signature_len);
+    return signature;
+}
+
+bool verify(const OQS_SIG *sig, const uint8_t digest[digest_length], const uint8_t *signature, size_t signature_len,
+            const uint8_t *public_key) {
+    require_context_support(sig);
+    uint8_t message[signed_length];
+    signed_message(digest, message);
+    return OQS_SIG_verify_with_ctx_str(sig, message, sizeof(message), signature, signature_len,
+                                       reinterpret_cast<const uint8_t *>(context), sizeof(context) - 1, public_key) == OQS_SUCCESS;
+}
+
+} // namespace prehash
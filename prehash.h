@@ -0,0 +1,35 @@
+#ifndef PREHASH_H
+#define PREHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <oqs/oqs.h>
+
+// Pre-hashed signing: the message is reduced to a 64-byte SHAKE256 digest, by the
+// server or by the client, and only the digest goes through the signature scheme, so
+// signing a large message costs one pass of hashing plus one fixed-size signature.
+//
+// liboqs only exposes pure ML-DSA, so this is not FIPS 204 HashML-DSA. The signed
+// message is DER(OID of SHAKE256) || digest, the same bytes HashML-DSA binds, signed
+// as pure ML-DSA under the context string below. The context keeps these signatures
+// apart from pure signatures over the same 75 bytes.
+namespace prehash {
+
+constexpr size_t digest_length = 64;
+
+extern const char context[];
+
+// SHAKE256 of the message, squeezed to digest_length bytes
+void digest(const uint8_t *message, size_t len, uint8_t out[digest_length]);
+
+// Throws std::invalid_argument when the algorithm cannot sign with a context string
+// and std::runtime_error when signing fails
+std::vector<uint8_t> sign(const OQS_SIG *sig, const uint8_t digest[digest_length], const uint8_t *secret_key);
+
+bool verify(const OQS_SIG *sig, const uint8_t digest[digest_length], const uint8_t *signature, size_t signature_len,
+            const uint8_t *public_key);
+
+} // namespace prehash
+
+#endif // PREHASH_H
@@ -0,0 +1,122 @@
+#ifndef REUSEPORT_SERVER_H
+#define REUSEPORT_SERVER_H
+
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include <sys/socket.h>
+#include "crow.h"
+#include "server_worker.h"
+
+// Serves a Crow app from several listeners on one port. Each listener is a thread with
+// its own io_context and its own SO_REUSEPORT acceptor, and serves the connections it
+// accepts itself. The kernel spreads new connections over the listening sockets, so
+// unlike Crow's server (one acceptor posting every socket to a worker io_context)
+// there is no shared accept path and no hand-off between threads.
+//
+// Listener i can be pinned to cpus[i], which keeps a connection's parsing, routing and
+// crypto on one core. The app must not use middlewares; routes are validated by run().
+template <typename App>
+class ReusePortServer {
+public:
+    // cpus[i] is the CPU listener i runs on, or -1 to leave it unpinned
+    ReusePortServer(App &app, uint16_t port, std::vector<int> cpus) : app_(app), port_(port) {
+        for (int cpu : cpus) {
+            listeners_.emplace_back(new Listener(cpu));
+        }
+    }
+
+    // Serve until SIGINT or SIGTERM
+    void run() {
+        app_.validate();
+        crow::tcp::endpoint endpoint(asio::ip::make_address("0.0.0.0"), port_);
+        for (auto &listener : listeners_) {
+            listener->acceptor.open(endpoint.protocol());
+            listener->acceptor.set_option(crow::tcp::acceptor::reuse_address(true));
+            listener->acceptor.set_option(reuse_port(true));
+            listener->acceptor.bind(endpoint);
+            listener->acceptor.listen();
+        }
+
+        std::vector<std::thread> threads;
+        for (auto &listener : listeners_) {
+            threads.emplace_back([this, &listener] { serve(*listener); });
+        }
+        CROW_LOG_INFO << server_name_ << " server is running at http://0.0.0.0:" << port_ << " with "
+                      << listeners_.size() << " SO_REUSEPORT listeners";
+
+        asio::io_context signal_context;
+        asio::signal_set signals(signal_context, SIGINT, SIGTERM);
+        signals.async_wait([this](const crow::error_code &, int) { stop(); });
+        signal_context.run();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    void stop() {
+        stopping_ = true;
+        for (auto &listener : listeners_) {
+            asio::post(listener->io_context, [&listener] {
+                crow::error_code ec;
+                listener->acceptor.close(ec);
+                listener->io_context.stop();
+            });
+        }
+    }
+
+    // The CPUs this process may run on, in ascending order
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        return cpus;
+    }
+
+private:
+    using reuse_port = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+    using Connection = crow::Connection<crow::SocketAdaptor, App>;
+
+    struct Listener : ServerWorker {
+        explicit Listener(int cpu) : ServerWorker(cpu), acceptor(io_context) {}
+
+        crow::tcp::acceptor acceptor;
+    };
+
+    void serve(Listener &listener) {
+        listener.serve(timeout_, stopping_, [this, &listener] { accept(listener); });
+    }
+
+    void accept(Listener &listener) {
+        auto connection = listener.template make_connection<Connection>(app_, server_name_, middlewares_);
+        listener.acceptor.async_accept(connection->socket(), [this, &listener, connection](const crow::error_code &ec) {
+            if (!ec) {
+                connection->start();
+            }
+            if (!stopping_) {
+                accept(listener);
+            }
+        });
+    }
+
+    App &app_;
+    uint16_t port_;
+    std::string server_name_ = std::string("Crow/") + crow::VERSION;
+    std::uint8_t timeout_ = 5;
+    std::tuple<> middlewares_;
+    std::vector<std::unique_ptr<Listener>> listeners_;
+    std::atomic<bool> stopping_{false};
+};
+
+#endif // REUSEPORT_SERVER_H
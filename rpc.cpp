@@ -0,0 +1,298 @@
+#include "rpc.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <oqs/oqs.h>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+namespace rpc {
+
+namespace {
+
+using tcp = asio::ip::tcp;
+
+// Reads start with this much room; a larger frame grows the buffer to fit
+constexpr size_t read_buffer_length = 64 * 1024;
+
+void put_u32(std::string &out, uint32_t value) {
+    char bytes[4] = {char(value >> 24), char(value >> 16), char(value >> 8), char(value)};
+    out.append(bytes, sizeof(bytes));
+}
+
+uint32_t get_u32(const char *bytes) {
+    const uint8_t *b = reinterpret_cast<const uint8_t *>(bytes);
+    return uint32_t(b[0]) << 24 | uint32_t(b[1]) << 16 | uint32_t(b[2]) << 8 | uint32_t(b[3]);
+}
+
+size_t frame_length(std::string_view data, size_t header_length, size_t first_length, size_t lengths) {
+    if (data.size() < header_length) {
+        return 0;
+    }
+    if (uint8_t(data[0]) != version) {
+        throw std::invalid_argument("Unsupported protocol version");
+    }
+    uint64_t length = header_length;
+    for (size_t i = 0; i < lengths; i++) {
+        length += get_u32(data.data() + first_length + 4 * i);
+    }
+    if (length > max_frame_length) {
+        throw std::invalid_argument("Frame too long");
+    }
+    return size_t(length);
+}
+
+// One client connection. Its socket runs on a strand, so reads, writes and the
+// bookkeeping below are serialized while handlers run anywhere on the pool.
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    Connection(tcp::socket socket, asio::io_context &io_context, const Handler &handler)
+        : socket_(std::move(socket)), io_context_(io_context), handler_(handler), in_(read_buffer_length) {}
+
+    void start() {
+        asio::error_code ec;
+        socket_.set_option(tcp::no_delay(true), ec);
+        read();
+    }
+
+private:
+    void read() {
+        if (in_flight_ >= Server::max_in_flight) {
+            read_paused_ = true;
+            return;
+        }
+        if (in_.size() - used_ < read_buffer_length / 2) {
+            in_.resize(std::max(in_.size() * 2, used_ + read_buffer_length));
+        }
+        auto self = shared_from_this();
+        socket_.async_read_some(asio::buffer(in_.data() + used_, in_.size() - used_),
+                                [self](const asio::error_code &ec, size_t bytes) {
+            if (ec) {
+                return;  // Responses still owed go out; the socket closes with the last reference
+            }
+            self->used_ += bytes;
+            try {
+                self->dispatch_frames();
+            } catch (const std::invalid_argument &) {
+                asio::error_code ignored;
+                self->socket_.close(ignored);
+                return;
+            }
+            self->read();
+        });
+    }
+
+    // Hand every complete frame of the buffer to the pool and keep the partial rest
+    void dispatch_frames() {
+        size_t pos = 0;
+        while (true) {
+            std::string_view rest(in_.data() + pos, used_ - pos);
+            size_t length = request_frame_length(rest);
+            if (length == 0 || length > rest.size()) {
+                break;
+            }
+            auto request = std::make_shared<Request>(decode_request(rest.substr(0, length)));
+            pos += length;
+            in_flight_++;
+
+            auto self = shared_from_this();
+            asio::post(io_context_, [self, request] {
+                Response response;
+                try {
+                    self->handler_(*request, response);
+                } catch (const std::invalid_argument &e) {
+                    response = Response{Status::BadRequest, e.what()};
+                } catch (const std::exception &e) {
+                    response = Response{Status::InternalError, e.what()};
+                }
+                std::string frame;
+                encode_response(request->op, request->id, response, frame);
+                asio::post(self->socket_.get_executor(), [self, frame = std::move(frame)] { self->respond(frame); });
+            });
+        }
+        std::memmove(in_.data(), in_.data() + pos, used_ - pos);
+        used_ -= pos;
+    }
+
+    void respond(const std::string &frame) {
+        outbox_ += frame;
+        in_flight_--;
+        if (!writing_) {
+            write();
+        }
+        if (read_paused_ && in_flight_ < Server::max_in_flight) {
+            read_paused_ = false;
+            read();
+        }
+    }
+
+    // Responses that complete while a write is in progress go out together in the next one
+    void write() {
+        writing_ = true;
+        sending_.swap(outbox_);
+        auto self = shared_from_this();
+        asio::async_write(socket_, asio::buffer(sending_), [self](const asio::error_code &ec, size_t) {
+            self->writing_ = false;
+            self->sending_.clear();
+            if (!ec && !self->outbox_.empty()) {
+                self->write();
+            }
+        });
+    }
+
+    tcp::socket socket_;
+    asio::io_context &io_context_;
+    const Handler &handler_;
+    std::vector<char> in_;
+    size_t used_ = 0;
+    size_t in_flight_ = 0;
+    bool read_paused_ = false;
+    bool writing_ = false;
+    std::string outbox_;
+    std::string sending_;
+};
+
+} // namespace
+
+const char *algorithm_name(Algorithm algorithm) {
+    switch (algorithm) {
+    case Algorithm::MlDsa44: return OQS_SIG_alg_ml_dsa_44;
+    case Algorithm::MlDsa65: return OQS_SIG_alg_ml_dsa_65;
+    case Algorithm::MlDsa87: return OQS_SIG_alg_ml_dsa_87;
+    default: return nullptr;
+    }
+}
+
+Request::~Request() {
+    if (!key.empty()) {
+        OQS_MEM_cleanse(&key[0], key.size());
+    }
+}
+
+void encode_request(const Request &request, std::string &out) {
+    out += char(version);
+    out += char(request.op);
+    out += char(request.algorithm);
+    out += char(0);
+    put_u32(out, request.id);
+    put_u32(out, uint32_t(request.key.size()));
+    put_u32(out, uint32_t(request.message.size()));
+    put_u32(out, uint32_t(request.signature.size()));
+    out += request.key;
+    out += request.message;
+    out += request.signature;
+}
+
+void encode_response(Op op, uint32_t id, const Response &response, std::string &out) {
+    out += char(version);
+    out += char(op);
+    out += char(response.status);
+    out += char(0);
+    put_u32(out, id);
+    put_u32(out, uint32_t(response.payload.size()));
+    out += response.payload;
+}
+
+size_t request_frame_length(std::string_view data) {
+    return frame_length(data, request_header_length, 8, 3);
+}
+
+size_t response_frame_length(std::string_view data) {
+    return frame_length(data, response_header_length, 8, 1);
+}
+
+Request decode_request(std::string_view data) {
+    Request request;
+    request.op = Op(data[1]);
+    request.algorithm = Algorithm(data[2]);
+    request.id = get_u32(data.data() + 4);
+    size_t key_length = get_u32(data.data() + 8);
+    size_t message_length = get_u32(data.data() + 12);
+    size_t signature_length = get_u32(data.data() + 16);
+    size_t pos = request_header_length;
+    request.key.assign(data.data() + pos, key_length);
+    pos += key_length;
+    request.message.assign(data.data() + pos, message_length);
+    pos += message_length;
+    request.signature.assign(data.data() + pos, signature_length);
+    return request;
+}
+
+void decode_response(std::string_view data, Op &op, uint32_t &id, Response &response) {
+    op = Op(data[1]);
+    response.status = Status(data[2]);
+    id = get_u32(data.data() + 4);
+    response.payload.assign(data.data() + response_header_length, get_u32(data.data() + 8));
+}
+
+struct Server::Impl {
+    Impl(uint16_t port, unsigned int threads, Handler handler)
+        : port(port), threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+          handler(std::move(handler)), acceptor(io_context) {}
+
+    void accept() {
+        acceptor.async_accept(asio::make_strand(io_context), [this](const asio::error_code &ec, tcp::socket socket) {
+            if (!ec) {
+                std::make_shared<Connection>(std::move(socket), io_context, handler)->start();
+            }
+            if (acceptor.is_open()) {
+                accept();
+            }
+        });
+    }
+
+    uint16_t port;
+    unsigned int threads;
+    Handler handler;
+    asio::io_context io_context;
+    tcp::acceptor acceptor;
+    std::vector<std::thread> pool;
+};
+
+Server::Server(uint16_t port, unsigned int threads, Handler handler)
+    : impl_(new Impl(port, threads, std::move(handler))) {}
+
+Server::~Server() { stop(); }
+
+void Server::start() {
+    tcp::endpoint endpoint(tcp::v4(), impl_->port);
+    impl_->acceptor.open(endpoint.protocol());
+    impl_->acceptor.set_option(tcp::acceptor::reuse_address(true));
+    impl_->acceptor.bind(endpoint);
+    impl_->acceptor.listen();
+    impl_->accept();
+
+    Impl *impl = impl_.get();
+    for (unsigned int i = 0; i < impl->threads; i++) {
+        impl->pool.emplace_back([impl] {
+            while (!impl->io_context.stopped()) {
+                try {
+                    impl->io_context.run();
+                } catch (const std::exception &) {
+                    // A handler escaped its connection; keep serving the others
+                }
+            }
+        });
+    }
+}
+
+void Server::stop() {
+    if (impl_->pool.empty()) {
+        return;
+    }
+    impl_->io_context.stop();
+    for (std::thread &thread : impl_->pool) {
+        thread.join();
+    }
+    impl_->pool.clear();
+    asio::error_code ec;
+    impl_->acceptor.close(ec);
+}
+
+} // namespace rpc
@@ -0,0 +1,102 @@
+#ifndef RPC_H
+#define RPC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Binary protocol for signing and verification between services, without the HTTP and
+// JSON envelope: fixed headers, raw key, message and signature bytes, no Base64.
+//
+// All integers are big-endian. A request frame is
+//   version u8 | op u8 | algorithm u8 | reserved u8 | request id u32 |
+//   key length u32 | message length u32 | signature length u32 | key | message | signature
+// and a response frame is
+//   version u8 | op u8 | status u8 | reserved u8 | request id u32 | payload length u32 | payload
+//
+// The key is the raw secret key (Sign) or public key (Verify) of the algorithm, or for
+// Algorithm::Registered the key_id of a registered key. The payload of a response is
+// the signature of a Sign, empty for a successful Verify and the error message of any
+// other status.
+//
+// A client may send any number of requests without waiting. They are handled
+// concurrently and each response goes out as soon as it is ready, so responses can
+// come back in a different order than the requests; the request id pairs them up.
+namespace rpc {
+
+constexpr uint8_t version = 1;
+constexpr size_t request_header_length = 20;
+constexpr size_t response_header_length = 12;
+constexpr size_t max_frame_length = 16 << 20;
+
+enum class Op : uint8_t { Sign = 1, Verify = 2 };
+
+enum class Status : uint8_t { Ok = 0, BadRequest = 1, UnknownKey = 2, VerificationFailed = 3, InternalError = 4 };
+
+enum class Algorithm : uint8_t { Registered = 0, MlDsa44 = 1, MlDsa65 = 2, MlDsa87 = 3 };
+
+// liboqs name of an algorithm id, or nullptr for Registered and unknown ids
+const char *algorithm_name(Algorithm algorithm);
+
+struct Request {
+    Op op = Op::Sign;
+    Algorithm algorithm = Algorithm::Registered;
+    uint32_t id = 0;
+    std::string key;  // Cleansed on destruction, as it may be a secret key
+    std::string message;
+    std::string signature;
+
+    Request() = default;
+    Request(Request &&) = default;
+    Request &operator=(Request &&) = default;
+    ~Request();
+};
+
+struct Response {
+    Status status = Status::Ok;
+    std::string payload;
+};
+
+// Called concurrently from the server's threads. std::invalid_argument becomes
+// Status::BadRequest and any other exception Status::InternalError.
+using Handler = std::function<void(const Request &, Response &)>;
+
+// Frame encoding, shared with clients
+void encode_request(const Request &request, std::string &out);
+void encode_response(Op op, uint32_t id, const Response &response, std::string &out);
+
+// Length of the frame at the start of data: 0 while its header is incomplete, and
+// more than data.size() while its fields are. Throws std::invalid_argument for an
+// unknown version or a frame longer than max_frame_length.
+size_t request_frame_length(std::string_view data);
+size_t response_frame_length(std::string_view data);
+
+// Decode the complete frame at the start of data
+Request decode_request(std::string_view data);
+void decode_response(std::string_view data, Op &op, uint32_t &id, Response &response);
+
+// Listens on a TCP port and runs the handler for every request. Connections and
+// handlers share threads threads (0 for one per hardware thread); at most
+// max_in_flight requests of a connection are handled at once, after which the
+// connection is not read until responses go out.
+class Server {
+public:
+    static constexpr size_t max_in_flight = 128;
+
+    Server(uint16_t port, unsigned int threads, Handler handler);
+    ~Server();
+
+    void start();
+    void stop();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace rpc
+
+#endif // RPC_H
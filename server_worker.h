@@ -0,0 +1,75 @@
+#ifndef SERVER_WORKER_H
+#define SERVER_WORKER_H
+
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <pthread.h>
+#include <sched.h>
+#include "crow.h"
+
+// A thread with its own io_context and the per-thread state a crow::Connection is
+// constructed with, for the servers that run Crow connections outside Crow's server.
+struct ServerWorker {
+    // cpu is the CPU the worker runs on, or -1 to leave it unpinned
+    explicit ServerWorker(int cpu) : cpu(cpu) {}
+
+    template <typename Connection, typename App>
+    std::shared_ptr<Connection> make_connection(App &app, const std::string &server_name, std::tuple<> &middlewares) {
+        return std::make_shared<Connection>(io_context, &app, server_name, &middlewares, date, *task_timer, nullptr,
+                                            queue_length);
+    }
+
+    // Called on the worker's thread: pins it, calls start() once the connection state
+    // is set up and runs the io_context until stopping is set
+    template <typename Start>
+    void serve(std::uint8_t timeout, const std::atomic<bool> &stopping, Start &&start) {
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+                CROW_LOG_WARNING << "Could not pin a worker to CPU " << cpu;
+            }
+        }
+
+        // Date header of the responses, formatted at most once a second as in Crow's server
+        std::string formatted;
+        std::time_t formatted_at = 0;
+        date = [&formatted, &formatted_at] {
+            std::time_t now = std::time(nullptr);
+            if (now != formatted_at) {
+                std::tm tm;
+                gmtime_r(&now, &tm);
+                char buffer[64];
+                formatted.assign(buffer, std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm));
+                formatted_at = now;
+            }
+            return formatted;
+        };
+
+        crow::detail::task_timer timer(io_context);
+        timer.set_default_timeout(timeout);
+        task_timer = &timer;
+
+        start();
+        while (!stopping) {
+            try {
+                io_context.run();
+            } catch (const std::exception &e) {
+                CROW_LOG_ERROR << "Worker Crash: An uncaught exception occurred: " << e.what();
+            }
+        }
+    }
+
+    int cpu;
+    asio::io_context io_context;
+    crow::detail::task_timer *task_timer = nullptr;
+    std::function<std::string()> date;
+    std::atomic<unsigned int> queue_length{0};  // Required by Connection; only Crow's server balances on it
+};
+
+#endif // SERVER_WORKER_H
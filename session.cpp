@@ -0,0 +1,178 @@
+#include "session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char initiator_label[] = "ml-kem-api session initiator";
+const char responder_label[] = "ml-kem-api session responder";
+
+constexpr size_t counter_length = 8;
+
+// Random 128-bit identifier encoded as lowercase hex
+std::string new_session_id() {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t raw[16];
+    OQS_randombytes(raw, sizeof(raw));
+    std::string id;
+    id.reserve(2 * sizeof(raw));
+    for (uint8_t byte : raw) {
+        id += hex[byte >> 4];
+        id += hex[byte & 0x0f];
+    }
+    return id;
+}
+
+// Nonce for a message counter: four zero bytes, then the counter big-endian
+void counter_nonce(uint64_t counter, uint8_t nonce[batch_aead::nonce_length]) {
+    std::memset(nonce, 0, batch_aead::nonce_length - counter_length);
+    for (size_t i = 0; i < counter_length; i++) {
+        nonce[batch_aead::nonce_length - counter_length + i] = uint8_t(counter >> (56 - 8 * i));
+    }
+}
+
+// Key for traffic sent by the side with the given label
+void traffic_key(const uint8_t *shared_secret, size_t shared_secret_len, const char *label, uint8_t *key) {
+    batch_aead::hkdf_sha256(shared_secret, shared_secret_len, reinterpret_cast<const uint8_t *>(label), std::strlen(label),
+                            key, batch_aead::key_length);
+}
+
+} // namespace
+
+Session::~Session() {
+    OQS_MEM_cleanse(send_key, sizeof(send_key));
+    OQS_MEM_cleanse(receive_key, sizeof(receive_key));
+}
+
+std::vector<uint8_t> Session::encrypt(const uint8_t *message, size_t len) const {
+    uint64_t counter = sent.fetch_add(1, std::memory_order_relaxed);
+    if (counter >= max_messages) {
+        throw std::out_of_range("Session message limit reached");
+    }
+    uint8_t nonce[batch_aead::nonce_length];
+    counter_nonce(counter, nonce);
+    std::vector<uint8_t> sealed = batch_aead::gcm_seal(send_key, nonce, message, len);
+    sealed.insert(sealed.begin(), nonce + batch_aead::nonce_length - counter_length, nonce + batch_aead::nonce_length);
+    return sealed;
+}
+
+std::string Session::decrypt(const uint8_t *sealed, size_t len) const {
+    if (len < counter_length + batch_aead::tag_length) {
+        throw std::invalid_argument("Session message is too short");
+    }
+    uint64_t counter = 0;
+    for (size_t i = 0; i < counter_length; i++) {
+        counter = counter << 8 | sealed[i];
+    }
+    if (counter >= max_messages) {
+        throw std::out_of_range("Session message limit reached");
+    }
+    uint8_t nonce[batch_aead::nonce_length];
+    counter_nonce(counter, nonce);
+    std::string message = batch_aead::gcm_open(receive_key, nonce, sealed + counter_length, len - counter_length);
+
+    // Only authenticated messages advance the window, so forgeries cannot burn counters
+    if (!accept_counter(counter)) {
+        OQS_MEM_cleanse(&message[0], message.size());
+        throw std::out_of_range("Session message was replayed or is older than the replay window");
+    }
+    return message;
+}
+
+bool Session::accept_counter(uint64_t counter) const {
+    std::lock_guard<std::mutex> lock(receive_mutex);
+    if (counter >= received_high) {
+        uint64_t shift = counter + 1 - received_high;
+        received_window = shift >= replay_window ? 0 : received_window << shift;
+        received_window |= 1;
+        received_high = counter + 1;
+        return true;
+    }
+    uint64_t age = received_high - 1 - counter;
+    if (age >= replay_window || (received_window >> age & 1)) {
+        return false;
+    }
+    received_window |= uint64_t(1) << age;
+    return true;
+}
+
+const char *session_role_name(Session::Role role) {
+    return role == Session::Role::Initiator ? "initiator" : "responder";
+}
+
+SessionRef SessionTable::open_initiator(const OQS_KEM *kem, const uint8_t *public_key, std::vector<uint8_t> &kem_ciphertext,
+                                        std::chrono::seconds ttl, uint64_t max_messages) {
+    std::vector<uint8_t> shared_secret(kem->length_shared_secret);
+    kem_ciphertext.resize(kem->length_ciphertext);
+    if (OQS_KEM_encaps(kem, kem_ciphertext.data(), shared_secret.data(), public_key) != OQS_SUCCESS) {
+        throw std::runtime_error("Encapsulation failed");
+    }
+    SessionRef session = insert(kem, Session::Role::Initiator, shared_secret.data(), ttl, max_messages);
+    OQS_MEM_cleanse(shared_secret.data(), shared_secret.size());
+    return session;
+}
+
+SessionRef SessionTable::open_responder(const OQS_KEM *kem, const uint8_t *secret_key, const uint8_t *kem_ciphertext,
+                                        size_t kem_ciphertext_len, std::chrono::seconds ttl, uint64_t max_messages) {
+    if (kem_ciphertext_len != kem->length_ciphertext) {
+        throw std::invalid_argument("Invalid kem_ciphertext length");
+    }
+    std::vector<uint8_t> shared_secret(kem->length_shared_secret);
+    if (OQS_KEM_decaps(kem, shared_secret.data(), kem_ciphertext, secret_key) != OQS_SUCCESS) {
+        throw std::runtime_error("Decapsulation failed");
+    }
+    SessionRef session = insert(kem, Session::Role::Responder, shared_secret.data(), ttl, max_messages);
+    OQS_MEM_cleanse(shared_secret.data(), shared_secret.size());
+    return session;
+}
+
+SessionRef SessionTable::find(const std::string &id) const {
+    epoch::Guard guard;
+    const Session *session = sessions_.find(id);
+    if (!session || session->expired()) {
+        return SessionRef();
+    }
+    return SessionRef(std::move(guard), session);
+}
+
+bool SessionTable::close(const std::string &id) {
+    return sessions_.erase(id);
+}
+
+SessionRef SessionTable::insert(const OQS_KEM *kem, Session::Role role, const uint8_t *shared_secret,
+                                std::chrono::seconds ttl, uint64_t max_messages) {
+    expire();
+
+    auto session = std::make_unique<Session>();
+    session->algorithm = kem->method_name;
+    session->role = role;
+    session->expires_at = std::chrono::steady_clock::now() + std::clamp(ttl, std::chrono::seconds(1), max_ttl);
+    session->max_messages = std::clamp<uint64_t>(max_messages, 1, max_max_messages);
+    bool initiator = role == Session::Role::Initiator;
+    traffic_key(shared_secret, kem->length_shared_secret, initiator ? initiator_label : responder_label, session->send_key);
+    traffic_key(shared_secret, kem->length_shared_secret, initiator ? responder_label : initiator_label, session->receive_key);
+    do {
+        session->id = new_session_id();
+    } while (sessions_.contains(session->id));
+
+    std::string id = session->id;
+    auto expires_at = session->expires_at;
+    epoch::Guard guard;
+    const Session *stored = sessions_.insert(id, std::move(session));
+    {
+        std::lock_guard<std::mutex> lock(expiry_mutex_);
+        expiry_.emplace(expires_at, id);
+    }
+    return SessionRef(std::move(guard), stored);
+}
+
+void SessionTable::expire() {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(expiry_mutex_);
+    while (!expiry_.empty() && expiry_.begin()->first <= now) {
+        sessions_.erase(expiry_.begin()->second);
+        expiry_.erase(expiry_.begin());
+    }
+}
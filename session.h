@@ -0,0 +1,125 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <oqs/oqs.h>
+#include "batch_aead.h"
+#include "concurrent_table.h"
+#include "epoch.h"
+
+// A KEM handshake turned into AES-256-GCM traffic keys, so that later messages to the
+// same peer cost one AEAD call instead of an encapsulation.
+//
+// The side that encapsulates to a public key is the initiator; the side that
+// decapsulates the resulting KEM ciphertext is the responder. Both derive the same
+// two keys, one per direction, with HKDF-SHA256 over the shared secret, and each
+// encrypts under its sending key with the message counter as the nonce. A sealed
+// message is uint64_be(counter) || ciphertext || tag.
+//
+// Each side accepts a counter at most once: the highest counter received and a bitmap
+// of the replay_window counters below it are kept, and anything already seen or older
+// than the window is refused. Received counters must also be below max_messages, which
+// bounds decryptions the way it bounds encryptions.
+struct Session {
+    enum class Role { Initiator, Responder };
+
+    std::string id;
+    std::string algorithm;
+    Role role;
+    std::chrono::steady_clock::time_point expires_at;
+    static constexpr uint64_t replay_window = 64;
+
+    uint64_t max_messages;  // Messages each direction may carry
+    uint8_t send_key[batch_aead::key_length];
+    uint8_t receive_key[batch_aead::key_length];
+    mutable std::atomic<uint64_t> sent{0};
+    mutable std::mutex receive_mutex;
+    mutable uint64_t received_high = 0;  // Highest counter accepted plus one; 0 before any
+    mutable uint64_t received_window = 0;  // Bit i: counter received_high - 1 - i was accepted
+
+    Session() = default;
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+    ~Session();
+
+    bool expired() const { return std::chrono::steady_clock::now() >= expires_at; }
+
+    // Throws std::out_of_range once max_messages have been encrypted
+    std::vector<uint8_t> encrypt(const uint8_t *message, size_t len) const;
+
+    // Throws std::invalid_argument for a malformed or forged message and std::out_of_range
+    // for a replayed counter, one older than the replay window or one past max_messages
+    std::string decrypt(const uint8_t *sealed, size_t len) const;
+
+private:
+    // Record an authenticated counter; false if it was seen or is too old to tell
+    bool accept_counter(uint64_t counter) const;
+};
+
+// Reference to a live session; like KeyRef it keeps the calling thread inside an
+// epoch, so drop it before the handler returns and on the thread that obtained it.
+class SessionRef {
+public:
+    SessionRef() = default;
+    SessionRef(epoch::Guard guard, const Session *session) : guard_(std::move(guard)), session_(session) {
+        if (!session_) {
+            guard_.release();
+        }
+    }
+
+    const Session *operator->() const { return session_; }
+    const Session &operator*() const { return *session_; }
+    explicit operator bool() const { return session_ != nullptr; }
+
+private:
+    epoch::Guard guard_ = epoch::Guard::empty();
+    const Session *session_ = nullptr;
+};
+
+// Open sessions by id. Lookups take no lock (see ConcurrentTable). Sessions past their
+// TTL are treated as absent and removed in TTL order whenever a session is opened.
+class SessionTable {
+public:
+    static constexpr std::chrono::seconds default_ttl{3600};
+    static constexpr std::chrono::seconds max_ttl{86400};
+    static constexpr uint64_t default_max_messages = uint64_t(1) << 20;
+    static constexpr uint64_t max_max_messages = uint64_t(1) << 32;
+
+    // Encapsulate to public_key and open the initiator side; kem_ciphertext receives
+    // what the responder needs. ttl and max_messages are clamped to the limits above.
+    SessionRef open_initiator(const OQS_KEM *kem, const uint8_t *public_key, std::vector<uint8_t> &kem_ciphertext,
+                              std::chrono::seconds ttl, uint64_t max_messages);
+
+    // Decapsulate the initiator's kem_ciphertext and open the responder side. Throws
+    // std::invalid_argument for a ciphertext of the wrong length.
+    SessionRef open_responder(const OQS_KEM *kem, const uint8_t *secret_key, const uint8_t *kem_ciphertext,
+                              size_t kem_ciphertext_len, std::chrono::seconds ttl, uint64_t max_messages);
+
+    // The session for the id, or an empty reference if it is unknown or expired
+    SessionRef find(const std::string &id) const;
+
+    bool close(const std::string &id);
+
+    size_t size() const { return sessions_.size(); }
+
+private:
+    SessionRef insert(const OQS_KEM *kem, Session::Role role, const uint8_t *shared_secret,
+                      std::chrono::seconds ttl, uint64_t max_messages);
+    void expire();
+
+    mutable ConcurrentTable<Session> sessions_;
+    std::mutex expiry_mutex_;
+    // Ids by expiry time; may still hold ids that were closed early
+    std::multimap<std::chrono::steady_clock::time_point, std::string> expiry_;
+};
+
+const char *session_role_name(Session::Role role);
+
+#endif // SESSION_H
@@ -0,0 +1,117 @@
+"""
+Genera test/kyber_vectors.txt con las salidas de kypher.py que comprueba
+test/kyber_native_test.cpp.
+
+Las entradas de cada caso salen de SHAKE-128 de su etiqueta ("ntt 0", "keygen Kyber768",
+...), así que no hace falta guardarlas: el test en C++ las deriva igual. De cada salida
+se guarda el SHA3-256 de su codificación (coeficientes en [0, q) como uint16
+little-endian, o los bytes tal cual).
+
+kypher.py se carga sin ejecutar su código de ejemplo ni la aplicación Flask, y con el
+motor nativo desactivado, para que todos los resultados sean los de Python.
+
+Uso: python3 test/gen_kyber_vectors.py > test/kyber_vectors.txt
+"""
+import ast
+import os
+import random
+from hashlib import sha3_256, sha3_512, shake_128, shake_256
+
+q = 3329
+
+# (k, eta1, eta2, du, dv) de cada conjunto de parámetros, como en native_engine.py.
+PARAMETROS = {
+  'Kyber512': (2, 3, 2, 10, 4),
+  'Kyber768': (3, 2, 2, 10, 4),
+  'Kyber1024': (4, 2, 2, 11, 5),
+}
+ANCHOS = (1, 4, 5, 10, 11, 12)
+LONGITUDES_PARSE = (100, 384, 500, 504, 768, 800, 900)
+CASOS = 8
+
+
+class SinMotorNativo:
+  @staticmethod
+  def disponible():
+    return False
+
+
+def cargar_kypher():
+  ruta = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'kypher.py')
+  arbol = ast.parse(open(ruta, encoding='utf-8').read())
+  # Solo las funciones; las rutas de Flask llevan decorador y se dejan fuera.
+  arbol.body = [nodo for nodo in arbol.body if isinstance(nodo, ast.FunctionDef) and not nodo.decorator_list]
+  ns = {'sha3_256': sha3_256, 'sha3_512': sha3_512, 'shake_128': shake_128, 'shake_256': shake_256,
+        'os': os, 'random': random, 'native_engine': SinMotorNativo, 'print': lambda *a, **k: None}
+  exec(compile(arbol, ruta, 'exec'), ns)
+  return ns
+
+
+K = cargar_kypher()
+
+
+def entrada(etiqueta, longitud):
+  return shake_128(etiqueta.encode()).digest(longitud)
+
+
+def polinomio(etiqueta, modulo=q):
+  b = entrada(etiqueta, 512)
+  return [int.from_bytes(b[2 * i:2 * i + 2], 'little') % modulo for i in range(256)]
+
+
+def resumen_pol(coeficientes):
+  return resumen(b''.join((c % q).to_bytes(2, 'little') for c in coeficientes))
+
+
+def resumen(b):
+  return sha3_256(bytes(b)).hexdigest()
+
+
+def keygen(k, eta1, d):
+  # keygen() de kypher.py toma la semilla de os.urandom y tiene comentadas las
+  # líneas que codifican pk y sk; estos son los mismos pasos con la semilla d.
+  rho, sigma = K['G'](d)
+  A_nt = K['generate_matrix_from_seed'](k, rho)
+  s, N = K['generate_error_vector'](k, sigma, eta1, 0)
+  s_nt = [[K['NTT_kyber'](s[i][0])] for i in range(k)]
+  e, N = K['generate_error_vector'](k, sigma, eta1, N)
+  e_nt = [[K['NTT_kyber'](e[i][0])] for i in range(k)]
+  t = K['vector_sum'](K['Matriz_mult_viaNTT'](A_nt, s_nt), e_nt)
+  return K['encode_matrix'](t, 12) + rho, K['encode_matrix'](s_nt, 12)
+
+
+def main():
+  for i in range(CASOS):
+    print('ntt', i, resumen_pol(K['NTT_kyber'](polinomio('ntt %d' % i))))
+    print('intt', i, resumen_pol(K['INTT_kyber'](polinomio('intt %d' % i))))
+    a, b = polinomio('pointwise %d a' % i), polinomio('pointwise %d b' % i)
+    print('pointwise', i, resumen_pol(K['pointwise'](a, b)))
+    a, b = polinomio('multiply %d a' % i), polinomio('multiply %d b' % i)
+    print('multiply', i, resumen_pol(K['KyberConvolution'](a, b)))
+  for longitud in LONGITUDES_PARSE:
+    print('parse', longitud, resumen_pol(K['Parse'](entrada('parse %d' % longitud, longitud))))
+  for eta in (2, 3):
+    for i in range(CASOS):
+      print('cbd%d' % eta, i, resumen_pol(K['CBD'](entrada('cbd%d %d' % (eta, i), 64 * eta), eta)))
+  for d in ANCHOS:
+    a = polinomio('compress %d' % d)
+    print('compress', d, resumen(K['encode'](K['compress'](a, d), d)))
+    x = polinomio('decompress %d' % d, 2 ** d)
+    print('decompress', d, resumen_pol(K['decompress'](x, d)))
+    x = polinomio('encode %d' % d, 2 ** d)
+    print('encode', d, resumen(K['encode'](x, d)))
+    print('decode', d, resumen_pol(K['decode'](entrada('decode %d' % d, 32 * d), d)))
+  for nombre, (k, eta1, eta2, du, dv) in PARAMETROS.items():
+    pk, sk = keygen(k, eta1, entrada('keygen ' + nombre, 32))
+    print('keygen', nombre, resumen(pk + sk))
+    m, monedas = entrada('encrypt %s m' % nombre, 32), entrada('encrypt %s coins' % nombre, 32)
+    c = K['encryption'](pk, m, monedas, k, eta1, eta2, du, dv)
+    print('encrypt', nombre, resumen(c))
+    K['k'] = k  # decryption() toma k de la variable global de kypher.py
+    descifrado = K['decryption'](sk, c, du, dv)
+    assert bytes(descifrado) == m, nombre
+    print('decrypt', nombre, resumen(descifrado))
+
+
+if __name__ == '__main__':
+  main()
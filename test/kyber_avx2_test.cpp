@@ -0,0 +1,231 @@
+// The AVX2 kernels of the native Kyber engine against their scalar versions, which
+// kyber_native_test checks against kypher.py. Inputs are random plus the edge cases
+// of each kernel; every output must be bit-exact.
+//
+// Usage: kyber_avx2_test
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "native/kyber_pack.h"
+#include "native/kyber_sampling.h"
+
+#ifdef KYBER_NATIVE_X86
+
+namespace {
+
+std::mt19937 rng(20240611);
+int failures = 0;
+
+void fail(const char *kernel, const char *what, size_t a, size_t b) {
+    if (failures++ < 20) {
+        std::printf("%s: %s (%zu, %zu)\n", kernel, what, a, b);
+    }
+}
+
+std::vector<uint8_t> random_bytes(size_t len) {
+    std::vector<uint8_t> out(len);
+    for (uint8_t &byte : out) {
+        byte = uint8_t(rng());
+    }
+    return out;
+}
+
+// Pack 12-bit candidates two per 3 bytes, as rej_uniform reads them
+std::vector<uint8_t> pack_candidates(const std::vector<uint16_t> &candidates) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < candidates.size(); i += 2) {
+        uint16_t d1 = candidates[i], d2 = candidates[i + 1];
+        out.push_back(uint8_t(d1));
+        out.push_back(uint8_t(d1 >> 8 | d2 << 4));
+        out.push_back(uint8_t(d2 >> 4));
+    }
+    return out;
+}
+
+// Both versions on the same input. The output has guard words past len, which
+// neither may touch; below the returned count the coefficients must agree.
+void compare_rej_uniform(const std::vector<uint8_t> &buf, size_t buflen, unsigned len) {
+    constexpr size_t guard = 32;
+    std::vector<int16_t> expected(len + guard, 0x7777), actual(len + guard, 0x7777);
+    unsigned expected_count = kyber::scalar::rej_uniform(expected.data(), len, buf.data(), buflen);
+    unsigned actual_count = kyber::avx2::rej_uniform(actual.data(), len, buf.data(), buflen);
+    if (expected_count != actual_count) {
+        fail("rej_uniform", "count differs", buflen, len);
+        return;
+    }
+    if (std::memcmp(expected.data(), actual.data(), expected_count * sizeof(int16_t)) != 0) {
+        fail("rej_uniform", "coefficients differ", buflen, len);
+    }
+    for (size_t i = len; i < len + guard; i++) {
+        if (actual[i] != 0x7777) {
+            fail("rej_uniform", "wrote past len", buflen, len);
+            break;
+        }
+    }
+}
+
+void check_rej_uniform() {
+    const unsigned lens[] = {0, 1, 2, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 239, 240, 241, 250, 255, 256};
+    std::vector<size_t> buflens;
+    for (size_t i = 0; i <= 75; i++) {
+        buflens.push_back(i);
+    }
+    for (size_t buflen : {167, 168, 335, 336, 503, 504, 505, 506, 840}) {
+        buflens.push_back(buflen);
+    }
+    for (int round = 0; round < 20; round++) {
+        std::vector<uint8_t> buf = random_bytes(840);
+        for (size_t buflen : buflens) {
+            for (unsigned len : lens) {
+                compare_rej_uniform(buf, buflen, len);
+            }
+        }
+    }
+
+    // Parse inputs: 336 candidates (504 bytes, 21 blocks of 24) with `rejected` of them
+    // >= q, placed up front or scattered (where they may collide). The 256th accepted
+    // candidate is then candidate 255 + rejected, so for every rejected count that is
+    // not a multiple of 16 the output fills up partway through a 24-byte block, where
+    // the vector loop hands over to the scalar tail.
+    for (int round = 0; round < 8; round++) {
+        for (unsigned rejected = 0; rejected <= 80; rejected++) {
+            std::vector<uint16_t> candidates(336);
+            for (uint16_t &c : candidates) {
+                c = uint16_t(rng() % kyber::q);
+            }
+            for (unsigned i = 0; i < rejected; i++) {
+                size_t at = round % 2 == 0 ? rng() % (256 + rejected) : i;  // Scattered or all up front
+                candidates[at] = uint16_t(kyber::q + rng() % (4096 - kyber::q));
+            }
+            std::vector<uint8_t> buf = pack_candidates(candidates);
+            compare_rej_uniform(buf, buf.size(), 256);
+            compare_rej_uniform(buf, buf.size() - 1, 256);
+        }
+    }
+
+    // Nothing or everything accepted
+    for (uint8_t fill : {0x00, 0xff}) {
+        std::vector<uint8_t> buf(504, fill);
+        for (unsigned len : lens) {
+            compare_rej_uniform(buf, buf.size(), len);
+        }
+    }
+}
+
+void compare_cbd(const std::vector<uint8_t> &buf, int eta) {
+    kyber::Poly expected, actual;
+    kyber::scalar::cbd(expected, buf.data(), eta);
+    kyber::avx2::cbd(actual, buf.data(), eta);
+    if (std::memcmp(expected.coeffs, actual.coeffs, sizeof(expected.coeffs)) != 0) {
+        fail("cbd", "coefficients differ", size_t(eta), buf.size());
+    }
+}
+
+void check_cbd() {
+    for (int eta : {2, 3}) {
+        for (int round = 0; round < 2000; round++) {
+            compare_cbd(random_bytes(64 * eta), eta);
+        }
+        for (uint8_t fill : {0x00, 0xff, 0x0f, 0xf0, 0x55, 0xaa}) {
+            compare_cbd(std::vector<uint8_t>(64 * eta, fill), eta);
+        }
+    }
+}
+
+kyber::Poly random_poly(int modulus) {
+    kyber::Poly p;
+    for (int16_t &c : p.coeffs) {
+        c = int16_t(rng() % unsigned(modulus));
+    }
+    return p;
+}
+
+// Packed output goes to 32 * bits bytes followed by guard bytes neither version may touch
+void compare_packed(const char *kernel, int bits, void (*scalar)(uint8_t *, const kyber::Poly &, int),
+                    void (*avx2)(uint8_t *, const kyber::Poly &, int), const kyber::Poly &a) {
+    constexpr size_t guard = 32;
+    size_t len = size_t(32 * bits);
+    std::vector<uint8_t> expected(len + guard, 0xa5), actual(len + guard, 0xa5);
+    scalar(expected.data(), a, bits);
+    avx2(actual.data(), a, bits);
+    if (expected != actual) {
+        fail(kernel, std::equal(expected.begin(), expected.begin() + len, actual.begin()) ? "wrote past the output" : "bytes differ",
+             size_t(bits), 0);
+    }
+}
+
+void compare_unpacked(const char *kernel, int bits, void (*scalar)(kyber::Poly &, const uint8_t *, int),
+                      void (*avx2)(kyber::Poly &, const uint8_t *, int), const std::vector<uint8_t> &in) {
+    kyber::Poly expected, actual;
+    scalar(expected, in.data(), bits);
+    avx2(actual, in.data(), bits);
+    if (std::memcmp(expected.coeffs, actual.coeffs, sizeof(expected.coeffs)) != 0) {
+        fail(kernel, "coefficients differ", size_t(bits), 0);
+    }
+}
+
+// Compress_d, Decompress_d, Encode_l and Decode_l for the widths Kyber uses (1 for the
+// message, 4/5 for v, 10/11 for u, 12 for keys). Compress takes every coefficient in
+// [0, q) at least once.
+void check_pack() {
+    for (int bits : {1, 4, 5, 10, 11, 12}) {
+        for (int start = 0; start < kyber::q; start += kyber::n) {
+            kyber::Poly a;
+            for (int i = 0; i < kyber::n; i++) {
+                a.coeffs[i] = int16_t((start + i) % kyber::q);
+            }
+            compare_packed("poly_compress", bits, kyber::scalar::poly_compress, kyber::avx2::poly_compress, a);
+        }
+        for (int round = 0; round < 200; round++) {
+            compare_packed("poly_compress", bits, kyber::scalar::poly_compress, kyber::avx2::poly_compress,
+                           random_poly(kyber::q));
+            compare_packed("poly_encode", bits, kyber::scalar::poly_encode, kyber::avx2::poly_encode,
+                           random_poly(1 << bits));
+            std::vector<uint8_t> packed = random_bytes(size_t(32 * bits));
+            compare_unpacked("poly_decompress", bits, kyber::scalar::poly_decompress, kyber::avx2::poly_decompress, packed);
+            compare_unpacked("poly_decode", bits, kyber::scalar::poly_decode, kyber::avx2::poly_decode, packed);
+        }
+        for (uint8_t fill : {0x00, 0xff}) {
+            std::vector<uint8_t> packed(size_t(32 * bits), fill);
+            compare_unpacked("poly_decompress", bits, kyber::scalar::poly_decompress, kyber::avx2::poly_decompress, packed);
+            compare_unpacked("poly_decode", bits, kyber::scalar::poly_decode, kyber::avx2::poly_decode, packed);
+            kyber::Poly a;
+            for (int16_t &c : a.coeffs) {
+                c = int16_t(fill ? (1 << bits) - 1 : 0);
+            }
+            compare_packed("poly_encode", bits, kyber::scalar::poly_encode, kyber::avx2::poly_encode, a);
+        }
+    }
+}
+
+template <typename F>
+void run(const char *name, F check) {
+    int before = failures;
+    check();
+    std::printf("%-12s %s\n", name, failures == before ? "ok" : "FAILED");
+}
+
+} // namespace
+
+int main() {
+    if (!kyber::avx2_enabled()) {
+        std::printf("avx2 not available on this CPU, nothing to compare\n");
+        return 0;
+    }
+    run("rej_uniform", check_rej_uniform);
+    run("cbd", check_cbd);
+    run("pack", check_pack);
+    return failures == 0 ? 0 : 1;
+}
+
+#else
+
+int main() {
+    std::printf("no AVX2 kernels on this architecture, nothing to compare\n");
+    return 0;
+}
+
+#endif // KYBER_NATIVE_X86
@@ -0,0 +1,208 @@
+// Cross-check of the native Kyber engine against kypher.py. The expected outputs in
+// kyber_vectors.txt come from test/gen_kyber_vectors.py, which runs the Python code;
+// each case derives its input from SHAKE-128 of its label exactly as that script does
+// and compares the SHA3-256 of its output. Everything runs on the AVX2 kernels when
+// the CPU has them and then again on the scalar ones. The constants of the division by
+// q in Compress_d are checked exhaustively first.
+//
+// Usage: kyber_native_test [vectors file]   (default test/kyber_vectors.txt)
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "native/fips202.h"
+#include "native/kyber.h"
+#include "native/kyber_pack.h"
+#include "native/kyber_sampling.h"
+
+namespace {
+
+constexpr int cases = 8;
+constexpr int widths[] = {1, 4, 5, 10, 11, 12};
+constexpr size_t parse_lengths[] = {100, 384, 500, 504, 768, 800, 900};
+const kyber::Params *const all_params[] = {&kyber::kyber512, &kyber::kyber768, &kyber::kyber1024};
+
+std::map<std::string, std::string> expected;
+int failures = 0;
+
+std::vector<uint8_t> input(const std::string &label, size_t len) {
+    std::vector<uint8_t> out(len);
+    fips202::shake128(out.data(), len, reinterpret_cast<const uint8_t *>(label.data()), label.size());
+    return out;
+}
+
+// 256 coefficients from 16-bit little-endian words of the label's stream, mod modulus
+kyber::Poly poly_input(const std::string &label, int modulus = kyber::q) {
+    std::vector<uint8_t> bytes = input(label, 2 * kyber::n);
+    kyber::Poly p;
+    for (int i = 0; i < kyber::n; i++) {
+        p.coeffs[i] = int16_t((bytes[2 * i] | bytes[2 * i + 1] << 8) % modulus);
+    }
+    return p;
+}
+
+std::string digest(const uint8_t *bytes, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t hash[32];
+    fips202::sha3_256(hash, bytes, len);
+    std::string out;
+    for (uint8_t byte : hash) {
+        out += hex[byte >> 4];
+        out += hex[byte & 0x0f];
+    }
+    return out;
+}
+
+std::string digest(const std::vector<uint8_t> &bytes) {
+    return digest(bytes.data(), bytes.size());
+}
+
+// Coefficients in [0, q) as 16-bit little-endian words
+std::string digest(const kyber::Poly &p) {
+    uint8_t bytes[2 * kyber::n];
+    for (int i = 0; i < kyber::n; i++) {
+        int v = p.coeffs[i] % kyber::q;
+        v += v < 0 ? kyber::q : 0;
+        bytes[2 * i] = uint8_t(v);
+        bytes[2 * i + 1] = uint8_t(v >> 8);
+    }
+    return digest(bytes, sizeof(bytes));
+}
+
+void check(const char *path, const std::string &name, const std::string &actual) {
+    auto it = expected.find(name);
+    if (it == expected.end()) {
+        std::printf("%s: %s has no expected value\n", path, name.c_str());
+        failures++;
+    } else if (it->second != actual) {
+        std::printf("%s: %s differs from kypher.py\n", path, name.c_str());
+        failures++;
+    }
+}
+
+void check_poly(const char *path) {
+    for (int i = 0; i < cases; i++) {
+        std::string id = std::to_string(i);
+        kyber::Poly a = poly_input("ntt " + id);
+        kyber::ntt(a);
+        check(path, "ntt " + id, digest(a));
+
+        a = poly_input("intt " + id);
+        kyber::intt(a);
+        check(path, "intt " + id, digest(a));
+
+        kyber::Poly r;
+        kyber::pointwise(r, poly_input("pointwise " + id + " a"), poly_input("pointwise " + id + " b"));
+        check(path, "pointwise " + id, digest(r));
+
+        kyber::multiply(r, poly_input("multiply " + id + " a"), poly_input("multiply " + id + " b"));
+        check(path, "multiply " + id, digest(r));
+    }
+}
+
+void check_sampling(const char *path) {
+    for (size_t len : parse_lengths) {
+        std::string id = std::to_string(len);
+        kyber::Poly r;
+        kyber::parse(r, input("parse " + id, len).data(), len);
+        check(path, "parse " + id, digest(r));
+    }
+    for (int eta : {2, 3}) {
+        for (int i = 0; i < cases; i++) {
+            std::string name = "cbd" + std::to_string(eta) + " " + std::to_string(i);
+            kyber::Poly r;
+            kyber::cbd(r, input(name, 64 * eta).data(), eta);
+            check(path, name, digest(r));
+        }
+    }
+}
+
+void check_pack(const char *path) {
+    for (int d : widths) {
+        std::string id = std::to_string(d);
+        std::vector<uint8_t> packed(32 * d);
+        kyber::poly_compress(packed.data(), poly_input("compress " + id), d);
+        check(path, "compress " + id, digest(packed));
+
+        kyber::Poly r;
+        kyber::poly_encode(packed.data(), poly_input("decompress " + id, 1 << d), d);
+        kyber::poly_decompress(r, packed.data(), d);
+        check(path, "decompress " + id, digest(r));
+
+        kyber::poly_encode(packed.data(), poly_input("encode " + id, 1 << d), d);
+        check(path, "encode " + id, digest(packed));
+
+        kyber::poly_decode(r, input("decode " + id, 32 * d).data(), d);
+        check(path, "decode " + id, digest(r));
+    }
+}
+
+void check_scheme(const char *path) {
+    for (const kyber::Params *params : all_params) {
+        std::string name = params->name;
+        std::vector<uint8_t> keys(params->public_key_bytes() + params->secret_key_bytes());
+        uint8_t *pk = keys.data();
+        uint8_t *sk = keys.data() + params->public_key_bytes();
+        kyber::keygen(*params, pk, sk, input("keygen " + name, 32).data());
+        check(path, "keygen " + name, digest(keys));
+
+        std::vector<uint8_t> msg = input("encrypt " + name + " m", 32);
+        std::vector<uint8_t> ct(params->ciphertext_bytes());
+        kyber::encrypt(*params, ct.data(), pk, msg.data(), input("encrypt " + name + " coins", 32).data());
+        check(path, "encrypt " + name, digest(ct));
+
+        std::vector<uint8_t> decrypted(32);
+        kyber::decrypt(*params, decrypted.data(), ct.data(), sk);
+        check(path, "decrypt " + name, digest(decrypted));
+    }
+}
+
+// poly_compress divides by q with div_q_multiplier and div_q_shift. Check that this is
+// floor(v / q) for every v up to the largest rounding numerator, (q - 1) * 2^12 + q / 2.
+void check_div_q() {
+    const uint64_t max = (uint64_t(kyber::q - 1) << 12) + kyber::q / 2;
+    for (uint64_t v = 0; v <= max; v++) {
+        if ((v * kyber::div_q_multiplier) >> kyber::div_q_shift != v / kyber::q) {
+            std::printf("div_q: wrong quotient for %llu\n", (unsigned long long)v);
+            failures++;
+            return;
+        }
+    }
+    std::printf("div_q   ok\n");
+}
+
+void run(const char *path) {
+    int before = failures;
+    check_poly(path);
+    check_sampling(path);
+    check_pack(path);
+    check_scheme(path);
+    std::printf("%-7s %s\n", path, failures == before ? "ok" : "FAILED");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *vectors = argc > 1 ? argv[1] : "test/kyber_vectors.txt";
+    std::ifstream in(vectors);
+    std::string op, param, hash;
+    while (in >> op >> param >> hash) {
+        expected[op + " " + param] = hash;
+    }
+    if (expected.empty()) {
+        std::fprintf(stderr, "no vectors in %s\n", vectors);
+        return 1;
+    }
+
+    check_div_q();
+    if (kyber::avx2_enabled()) {
+        run("avx2");
+        kyber::disable_avx2();
+    } else {
+        std::printf("avx2    not available on this CPU\n");
+    }
+    run("scalar");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#ifndef UNIX_SOCKET_SERVER_H
+#define UNIX_SOCKET_SERVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "crow.h"
+#include "server_worker.h"
+
+// Serves a Crow app on a unix domain stream socket, for clients on the same host. The
+// routes are the app's own; only the transport differs, so a request skips the TCP
+// stack and access is governed by the permissions of the socket file.
+//
+// One acceptor hands connections to the workers in turn, as Crow's server does. The
+// app must not use middlewares, and its routes must be validated before start(), which
+// run() does and app.run() does for a server started after it.
+template <typename App>
+class UnixSocketServer {
+public:
+    // mode is the permission bits of the socket file, or 0 to leave them to the umask
+    UnixSocketServer(App &app, std::string path, unsigned int threads, mode_t mode)
+        : app_(app), path_(std::move(path)), mode_(mode) {
+        for (unsigned int i = 0; i < std::max(1u, threads); i++) {
+            workers_.emplace_back(new ServerWorker(-1));
+        }
+    }
+
+    ~UnixSocketServer() { stop(); }
+
+    // Bind the socket file, replacing a stale socket left by a previous run, and start serving
+    void start() {
+        struct stat existing;
+        if (lstat(path_.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                throw std::runtime_error(path_ + " exists and is not a socket");
+            }
+            unlink(path_.c_str());
+        }
+
+        acceptor_.reset(new crow::stream_protocol::acceptor(workers_[0]->io_context));
+        crow::stream_protocol::endpoint endpoint(path_);
+        acceptor_->open(endpoint.protocol());
+        acceptor_->bind(endpoint);
+        if (mode_ != 0 && chmod(path_.c_str(), mode_) != 0) {
+            throw std::runtime_error("Could not set the permissions of " + path_);
+        }
+        acceptor_->listen();
+
+        for (auto &worker : workers_) {
+            ServerWorker *w = worker.get();
+            threads_.emplace_back([this, w] {
+                // Connections are handed to a worker only once it has set up its state
+                w->serve(timeout_, stopping_, [this] {
+                    if (++ready_ == workers_.size()) {
+                        asio::post(workers_[0]->io_context, [this] { accept(); });
+                    }
+                });
+            });
+        }
+        CROW_LOG_INFO << server_name_ << " server is running at unix:" << path_ << " using " << workers_.size()
+                      << " threads";
+    }
+
+    void stop() {
+        if (threads_.empty() || stopping_.exchange(true)) {
+            return;
+        }
+        for (auto &worker : workers_) {
+            worker->io_context.stop();
+        }
+        for (std::thread &thread : threads_) {
+            thread.join();
+        }
+        crow::error_code ec;
+        acceptor_->close(ec);
+        unlink(path_.c_str());
+    }
+
+    // Serve until SIGINT or SIGTERM
+    void run() {
+        app_.validate();
+        start();
+        asio::io_context signal_context;
+        asio::signal_set signals(signal_context, SIGINT, SIGTERM);
+        signals.async_wait([](const crow::error_code &, int) {});
+        signal_context.run();
+        stop();
+    }
+
+private:
+    using Connection = crow::Connection<crow::UnixSocketAdaptor, App>;
+
+    void accept() {
+        ServerWorker &worker = *workers_[next_worker_++ % workers_.size()];
+        auto connection = worker.make_connection<Connection>(app_, server_name_, middlewares_);
+        acceptor_->async_accept(connection->socket(), [this, &worker, connection](const crow::error_code &ec) {
+            if (!ec) {
+                asio::post(worker.io_context, [connection] { connection->start(); });
+            }
+            if (!stopping_) {
+                accept();
+            }
+        });
+    }
+
+    App &app_;
+    std::string path_;
+    mode_t mode_;
+    std::string server_name_ = std::string("Crow/") + crow::VERSION;
+    std::uint8_t timeout_ = 5;
+    std::tuple<> middlewares_;
+    std::vector<std::unique_ptr<ServerWorker>> workers_;
+    std::unique_ptr<crow::stream_protocol::acceptor> acceptor_;
+    std::vector<std::thread> threads_;
+    size_t next_worker_ = 0;
+    std::atomic<size_t> ready_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+#endif // UNIX_SOCKET_SERVER_H
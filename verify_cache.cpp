@@ -0,0 +1,125 @@
+#include "verify_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <openssl/evp.h>
+
+namespace {
+
+using MdCtxPtr = std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)>;
+
+// SHA-256 context of the calling thread, reinitialized for every key
+EVP_MD_CTX *digest_context() {
+    thread_local MdCtxPtr ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!ctx) {
+        throw std::runtime_error("Failed to allocate the verification cache digest");
+    }
+    return ctx.get();
+}
+
+bool absorb_field(EVP_MD_CTX *ctx, std::string_view field) {
+    uint8_t length[8];
+    for (int i = 0; i < 8; i++) {
+        length[i] = uint8_t(uint64_t(field.size()) >> (56 - 8 * i));
+    }
+    return EVP_DigestUpdate(ctx, length, sizeof(length)) > 0 && EVP_DigestUpdate(ctx, field.data(), field.size()) > 0;
+}
+
+} // namespace
+
+VerifyCache::VerifyCache(std::chrono::seconds ttl, size_t max_entries)
+    : ttl_(ttl), shard_capacity_(std::max<size_t>(1, max_entries / shard_count)) {}
+
+VerifyCache::Key VerifyCache::make_key(std::string_view algorithm, std::string_view public_key, std::string_view message,
+                                       std::string_view signature) {
+    EVP_MD_CTX *ctx = digest_context();
+    Key key;
+    unsigned int key_len = 0;
+    bool ok = EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) > 0 &&
+              absorb_field(ctx, algorithm) && absorb_field(ctx, public_key) &&
+              absorb_field(ctx, message) && absorb_field(ctx, signature) &&
+              EVP_DigestFinal_ex(ctx, key.data(), &key_len) > 0;
+    if (!ok) {
+        throw std::runtime_error("Verification cache digest failed");
+    }
+    return key;
+}
+
+size_t VerifyCache::size() const {
+    size_t total = 0;
+    for (const Shard &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+bool VerifyCache::lookup(const Key &key) {
+    Shard &shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    if (it->second <= Clock::now()) {
+        shard.entries.erase(it);
+        expirations_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void VerifyCache::insert(const Key &key) {
+    Shard &shard = shard_of(key);
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Drop expired entries and queue pairs whose entry was erased or reinserted since
+    while (!shard.order.empty()) {
+        auto &[front_key, front_expiry] = shard.order.front();
+        auto it = shard.entries.find(front_key);
+        bool live = it != shard.entries.end() && it->second == front_expiry;
+        if (live && front_expiry > now) {
+            break;
+        }
+        if (live) {
+            shard.entries.erase(it);
+            expirations_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.order.pop_front();
+    }
+
+    auto expires_at = now + ttl_;
+    auto [it, inserted] = shard.entries.insert_or_assign(key, expires_at);
+    shard.order.emplace_back(key, expires_at);
+    if (!inserted) {
+        return;
+    }
+
+    // The oldest entry makes room; stale pairs ahead of it are skipped
+    while (shard.entries.size() > shard_capacity_ && !shard.order.empty()) {
+        auto &[front_key, front_expiry] = shard.order.front();
+        auto oldest = shard.entries.find(front_key);
+        if (oldest != shard.entries.end() && oldest->second == front_expiry) {
+            shard.entries.erase(oldest);
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.order.pop_front();
+    }
+}
+
+bool parse_verify_cache_route(const std::string &name, VerifyCache::Route &route) {
+    if (name == "verify") {
+        route = VerifyCache::Route::Verify;
+    } else if (name == "bulkVerify") {
+        route = VerifyCache::Route::BulkVerify;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *verify_cache_route_name(VerifyCache::Route route) {
+    return route == VerifyCache::Route::Verify ? "verify" : "bulkVerify";
+}
@@ -0,0 +1,110 @@
+#ifndef VERIFY_CACHE_H
+#define VERIFY_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Successful signature verifications remembered for a TTL, so that a token checked
+// again on every hop costs a hash and a lookup instead of OQS_SIG_verify.
+//
+// An entry is keyed by SHA-256 over the length-prefixed algorithm, raw public key,
+// message and signature as sent, so a hit means exactly these inputs verified before.
+// Only successes are stored; a failed verification leaves nothing behind, and any
+// change to one of the four inputs is a miss that goes to the signature scheme.
+//
+// Entries are spread over shard_count shards with a mutex each. All entries share the
+// TTL, so insertion order is expiry order: each shard drops expired entries from the
+// front of its queue and evicts the oldest once it holds its share of max_entries.
+class VerifyCache {
+public:
+    enum class Route { Verify, BulkVerify };
+    static constexpr size_t route_count = 2;
+    static constexpr size_t shard_count = 16;
+
+    using Key = std::array<uint8_t, 32>;
+
+    VerifyCache(std::chrono::seconds ttl, size_t max_entries);
+
+    // Routes are off until enabled
+    void enable(Route route) { enabled_[size_t(route)].store(true, std::memory_order_relaxed); }
+    bool enabled(Route route) const { return enabled_[size_t(route)].load(std::memory_order_relaxed); }
+
+    static Key make_key(std::string_view algorithm, std::string_view public_key, std::string_view message,
+                        std::string_view signature);
+
+    // verify() unless the route caches and the same inputs verified within the TTL
+    template <typename Verify>
+    bool verify(Route route, std::string_view algorithm, std::string_view public_key, std::string_view message,
+                std::string_view signature, Verify &&verify) {
+        if (!enabled(route)) {
+            return verify();
+        }
+        Key key = make_key(algorithm, public_key, message, signature);
+        if (lookup(key)) {
+            hits_[size_t(route)].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        misses_[size_t(route)].fetch_add(1, std::memory_order_relaxed);
+        if (!verify()) {
+            return false;
+        }
+        insert(key);
+        return true;
+    }
+
+    std::chrono::seconds ttl() const { return ttl_; }
+    size_t max_entries() const { return shard_capacity_ * shard_count; }
+    size_t size() const;
+
+    uint64_t hits(Route route) const { return hits_[size_t(route)].load(std::memory_order_relaxed); }
+    uint64_t misses(Route route) const { return misses_[size_t(route)].load(std::memory_order_relaxed); }
+    uint64_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+    uint64_t expirations() const { return expirations_.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            size_t hash;
+            std::memcpy(&hash, key.data(), sizeof(hash));
+            return hash;
+        }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Clock::time_point, KeyHash> entries;  // Expiry by key
+        std::deque<std::pair<Key, Clock::time_point>> order;          // May hold stale pairs
+    };
+
+    // The map hash reads the first bytes of a key, so shards are picked by the last
+    Shard &shard_of(const Key &key) { return shards_[key.back() % shard_count]; }
+
+    bool lookup(const Key &key);
+    void insert(const Key &key);
+
+    std::chrono::seconds ttl_;
+    size_t shard_capacity_;
+    Shard shards_[shard_count];
+    std::atomic<bool> enabled_[route_count] = {};
+    std::atomic<uint64_t> hits_[route_count] = {};
+    std::atomic<uint64_t> misses_[route_count] = {};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> expirations_{0};
+};
+
+// "verify" or "bulkVerify", as used in VERIFY_CACHE; false for any other name
+bool parse_verify_cache_route(const std::string &name, VerifyCache::Route &route);
+const char *verify_cache_route_name(VerifyCache::Route route);
+
+#endif // VERIFY_CACHE_H